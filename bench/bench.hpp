@@ -0,0 +1,287 @@
+#pragma once
+
+// Minimal self-contained benchmark harness for zoneout (no external dependencies).
+//
+// Each bench/*.cpp is its own executable and includes this header exactly once: it replaces the global
+// allocation functions to count allocations made inside timed regions.
+//
+// Command line:
+//   --filter <substr>   only run benchmarks whose name contains substr
+//   --min-time <sec>    target time per benchmark (default 0.5)
+//   --csv               print CSV instead of a table (for tracking across versions)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+namespace dp = datapod;
+
+namespace zoneout::bench {
+
+    struct AllocCounters {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<int64_t> live{0}; // bytes currently allocated
+        std::atomic<int64_t> peak{0};
+    };
+
+    inline AllocCounters &alloc_counters() {
+        static AllocCounters counters;
+        return counters;
+    }
+
+} // namespace zoneout::bench
+
+// ============ Counting allocator (one definition per benchmark executable) ============
+// Each block carries a max_align_t-sized header holding its size, so frees can keep the live byte count.
+
+namespace zoneout::bench {
+    inline constexpr std::size_t alloc_header = alignof(std::max_align_t);
+
+    inline void release(void *ptr) noexcept {
+        if (ptr == nullptr)
+            return;
+        auto *block = static_cast<char *>(ptr) - alloc_header;
+        std::size_t size;
+        std::memcpy(&size, block, sizeof(size));
+        alloc_counters().live.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+        std::free(block);
+    }
+} // namespace zoneout::bench
+
+void *operator new(std::size_t size) {
+    auto &counters = zoneout::bench::alloc_counters();
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    auto *block = static_cast<char *>(std::malloc(size + zoneout::bench::alloc_header));
+    if (block == nullptr)
+        throw std::bad_alloc();
+    std::memcpy(block, &size, sizeof(size));
+    int64_t live = counters.live.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                   static_cast<int64_t>(size);
+    int64_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return block + zoneout::bench::alloc_header;
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return ::operator new(size, tag); }
+void operator delete(void *ptr) noexcept { zoneout::bench::release(ptr); }
+void operator delete[](void *ptr) noexcept { zoneout::bench::release(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { zoneout::bench::release(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { zoneout::bench::release(ptr); }
+
+namespace zoneout::bench {
+
+    /// Bytes still allocated since construction, and the peak reached in between (e.g. footprint of a build)
+    class LiveBytes {
+      private:
+        int64_t start_;
+
+      public:
+        inline LiveBytes() : start_(alloc_counters().live.load()) { alloc_counters().peak.store(start_); }
+        inline int64_t live() const { return alloc_counters().live.load() - start_; }
+        inline int64_t peak() const { return alloc_counters().peak.load() - start_; }
+    };
+
+} // namespace zoneout::bench
+
+namespace zoneout::bench {
+
+    /// Keep a computed value alive so the optimizer cannot drop the benchmarked work
+    template <typename T> inline void do_not_optimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+    struct Result {
+        std::string name;
+        uint64_t iterations = 0;
+        double ns_per_op = 0.0;      // median over samples
+        double items_per_sec = 0.0;  // items_per_op / (ns_per_op * 1e-9)
+        double allocs_per_op = 0.0;  // mean over all timed iterations
+        double bytes_per_op = 0.0;
+    };
+
+    class Runner {
+      private:
+        std::string filter_;
+        double min_time_ = 0.5;
+        bool csv_ = false;
+        std::vector<Result> results_;
+
+        static constexpr int samples = 5;
+
+        inline void print(const Result &r) const {
+            if (csv_) {
+                std::printf("%s,%llu,%.1f,%.1f,%.1f,%.1f\n", r.name.c_str(),
+                            static_cast<unsigned long long>(r.iterations), r.ns_per_op, r.items_per_sec,
+                            r.allocs_per_op, r.bytes_per_op);
+            } else {
+                std::printf("%-48s %10llu %14.1f %14.3e %12.1f %14.1f\n", r.name.c_str(),
+                            static_cast<unsigned long long>(r.iterations), r.ns_per_op, r.items_per_sec,
+                            r.allocs_per_op, r.bytes_per_op);
+            }
+            std::fflush(stdout);
+        }
+
+      public:
+        inline Runner(int argc, char **argv) {
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--filter" && i + 1 < argc) {
+                    filter_ = argv[++i];
+                } else if (arg == "--min-time" && i + 1 < argc) {
+                    min_time_ = std::atof(argv[++i]);
+                } else if (arg == "--csv") {
+                    csv_ = true;
+                }
+            }
+            if (csv_) {
+                std::printf("name,iterations,ns_per_op,items_per_sec,allocs_per_op,bytes_per_op\n");
+            } else {
+                std::printf("%-48s %10s %14s %14s %12s %14s\n", "benchmark", "iters", "ns/op", "items/s", "allocs/op",
+                            "bytes/op");
+            }
+        }
+
+        inline bool enabled(const std::string &name) const {
+            return filter_.empty() || name.find(filter_) != std::string::npos;
+        }
+
+        /**
+         * @brief Time `fn` (one operation per call)
+         *
+         * The iteration count is calibrated so each of the samples takes about min_time / samples; the reported
+         * time is the median sample, which is robust against scheduler noise.
+         */
+        template <typename F> inline void run(const std::string &name, double items_per_op, F &&fn) {
+            if (!enabled(name))
+                return;
+            using Clock = std::chrono::steady_clock;
+
+            fn(); // warm-up: page in data, fill caches
+            uint64_t iterations = 1;
+            const double sample_target = min_time_ / samples;
+            while (true) {
+                auto start = Clock::now();
+                for (uint64_t i = 0; i < iterations; ++i)
+                    fn();
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                if (elapsed >= sample_target || iterations >= (uint64_t{1} << 30))
+                    break;
+                double scale = elapsed > 0.0 ? sample_target / elapsed : 10.0;
+                iterations = std::max<uint64_t>(iterations + 1,
+                                                static_cast<uint64_t>(static_cast<double>(iterations) *
+                                                                      std::min(scale, 10.0)));
+            }
+
+            std::vector<double> per_op;
+            per_op.reserve(samples);
+            auto &counters = alloc_counters();
+            const uint64_t allocs_before = counters.count.load();
+            const uint64_t bytes_before = counters.bytes.load();
+            for (int s = 0; s < samples; ++s) {
+                auto start = Clock::now();
+                for (uint64_t i = 0; i < iterations; ++i)
+                    fn();
+                double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                per_op.push_back(ns / static_cast<double>(iterations));
+            }
+            const double total = static_cast<double>(iterations) * samples;
+
+            std::sort(per_op.begin(), per_op.end());
+            Result result;
+            result.name = name;
+            result.iterations = iterations * samples;
+            result.ns_per_op = per_op[per_op.size() / 2];
+            result.items_per_sec = result.ns_per_op > 0.0 ? items_per_op * 1e9 / result.ns_per_op : 0.0;
+            result.allocs_per_op = static_cast<double>(counters.count.load() - allocs_before) / total;
+            result.bytes_per_op = static_cast<double>(counters.bytes.load() - bytes_before) / total;
+            print(result);
+            results_.push_back(result);
+        }
+
+        inline const std::vector<Result> &results() const { return results_; }
+    };
+
+    // ============ Reproducible inputs ============
+
+    inline dp::Geo bench_datum() { return dp::Geo{51.98776, 5.66238, 0.0}; }
+
+    /// Star-shaped field outline with `vertices` vertices around the origin; same seed, same field
+    inline dp::Polygon synthetic_field(size_t vertices, double radius, uint32_t seed = 42) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> jitter(0.75, 1.0);
+        dp::Polygon poly;
+        for (size_t i = 0; i < vertices; ++i) {
+            double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(vertices);
+            double r = radius * jitter(rng);
+            poly.vertices.push_back({r * std::cos(angle), r * std::sin(angle), 0.0});
+        }
+        return poly;
+    }
+
+    /// Axis-aligned square of side `size` centred on `center`
+    inline dp::Polygon square(const dp::Point &center, double size) {
+        double h = size / 2.0;
+        dp::Polygon poly;
+        poly.vertices.push_back({center.x - h, center.y - h, 0.0});
+        poly.vertices.push_back({center.x + h, center.y - h, 0.0});
+        poly.vertices.push_back({center.x + h, center.y + h, 0.0});
+        poly.vertices.push_back({center.x - h, center.y + h, 0.0});
+        return poly;
+    }
+
+    /// Uniform points in [-extent, extent]^2
+    inline std::vector<dp::Point> random_points(size_t count, double extent, uint32_t seed = 7) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> coord(-extent, extent);
+        std::vector<dp::Point> points;
+        points.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            points.push_back({coord(rng), coord(rng), 0.0});
+        return points;
+    }
+
+    /// Locate a file under misc/ (source tree), returning an empty path if absent
+    inline std::filesystem::path misc_file(const std::string &name) {
+#ifdef PROJECT_DIR
+        std::filesystem::path in_tree = std::filesystem::path(PROJECT_DIR) / "misc" / name;
+        if (std::filesystem::exists(in_tree))
+            return in_tree;
+#endif
+        for (const char *prefix : {"misc/", "../misc/", "../../misc/"}) {
+            std::filesystem::path candidate = std::filesystem::path(prefix) / name;
+            if (std::filesystem::exists(candidate))
+                return candidate;
+        }
+        return {};
+    }
+
+    inline std::filesystem::path scratch_dir(const std::string &name) {
+        auto dir = std::filesystem::temp_directory_path() / ("zoneout_bench_" + name);
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        return dir;
+    }
+
+} // namespace zoneout::bench
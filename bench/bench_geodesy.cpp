@@ -0,0 +1,36 @@
+// ENU -> WGS84: per-vertex concord frame conversion against the batched LocalFrame
+
+#include "bench.hpp"
+
+#include <concord/frame/convert.hpp>
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+    const auto datum = zb::bench_datum();
+
+    for (size_t vertices : {64, 4096, 100000}) {
+        const auto points = zb::random_points(vertices, 500.0, 3);
+        const std::string n = "/v" + std::to_string(vertices);
+
+        runner.run("enu_to_wgs/per_point" + n, static_cast<double>(vertices), [&] {
+            std::vector<dp::Geo> out;
+            for (const auto &p : points) {
+                concord::frame::ENU enu{p.x, p.y, p.z, datum};
+                auto wgs = concord::frame::to_wgs(enu);
+                out.push_back(dp::Geo{wgs.latitude, wgs.longitude, wgs.altitude});
+            }
+            zb::do_not_optimize(out);
+        });
+
+        runner.run("enu_to_wgs/batch" + n, static_cast<double>(vertices), [&] {
+            auto out = LocalFrame(datum).to_wgs(points);
+            zb::do_not_optimize(out);
+        });
+    }
+    return 0;
+}
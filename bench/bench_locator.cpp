@@ -0,0 +1,66 @@
+// Point-to-zone lookup: Plot::zones_containing (linear scan) vs ZoneLocator across zone counts, plus locator build
+
+#include "bench.hpp"
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+namespace {
+
+    /// `zones` 64-vertex fields of ~40 m radius on a 100 m lattice
+    Plot make_farm(size_t zones) {
+        const auto datum = zb::bench_datum();
+        Plot plot("Farm", "agricultural", datum);
+        const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(zones))));
+        for (size_t z = 0; z < zones; ++z) {
+            auto boundary = zb::synthetic_field(64, 40.0, static_cast<uint32_t>(z + 1));
+            for (auto &v : boundary.vertices) {
+                v.x += 100.0 * static_cast<double>(z % side);
+                v.y += 100.0 * static_cast<double>(z / side);
+            }
+            plot.add_zone(Zone("field" + std::to_string(z), "field", boundary, datum, 10.0));
+        }
+        return plot;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+
+    for (size_t zones : {16, 256, 1200}) {
+        const auto plot = make_farm(zones);
+        const std::string n = "/z" + std::to_string(zones);
+        const double extent = 50.0 * std::ceil(std::sqrt(static_cast<double>(zones)));
+        auto points = zb::random_points(4096, extent);
+        for (auto &p : points) {
+            p.x += extent - 50.0;
+            p.y += extent - 50.0;
+        }
+        const double items = static_cast<double>(points.size());
+
+        if (zones <= 256) { // the scan is far too slow to time at 1200 zones in a reasonable run
+            runner.run("locate/zones_containing" + n, items, [&] {
+                size_t found = 0;
+                for (const auto &p : points)
+                    found += plot.zones_containing(p).size();
+                zb::do_not_optimize(found);
+            });
+        }
+
+        runner.run("locate/build" + n, static_cast<double>(zones), [&] {
+            ZoneLocator locator(plot);
+            zb::do_not_optimize(locator);
+        });
+
+        const ZoneLocator locator(plot);
+        std::vector<size_t> out(points.size());
+        runner.run("locate/batch" + n, items, [&] {
+            locator.locate(points, out);
+            zb::do_not_optimize(out);
+        });
+    }
+    return 0;
+}
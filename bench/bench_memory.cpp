@@ -0,0 +1,59 @@
+// Memory accounting: cost of Zone/Plot::memory_usage() and how its estimate compares with measured live bytes
+
+#include "bench.hpp"
+
+#include <optional>
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+namespace {
+
+    Zone make_zone(size_t elements, double resolution, uint32_t seed) {
+        Zone zone("field", "field", zb::synthetic_field(64, 150.0, seed), zb::bench_datum(), resolution);
+        zone.set_property("crop_type", "wheat");
+        const auto centers = zb::random_points(elements, 90.0, seed + 1);
+        for (size_t i = 0; i < elements; ++i) {
+            zone.poly().add_polygon_element(generateUUID(), "obstacle" + std::to_string(i), "obstacle", "default",
+                                            zb::square(centers[i], 2.0), {{"height", "1.5"}});
+        }
+        return zone;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+
+    std::printf("\n%-28s %14s %14s %14s\n", "footprint", "estimated", "measured", "peak");
+    for (size_t elements : {10, 1000}) {
+        for (double resolution : {1.0, 0.25}) {
+            std::optional<Zone> zone;
+            zb::LiveBytes scope;
+            zone.emplace(make_zone(elements, resolution, 5));
+            const auto measured = scope.live();
+            const auto peak = scope.peak();
+            const auto usage = zone->memory_usage();
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "zone/e%zu/r%g", elements, resolution);
+            std::printf("%-28s %14zu %14lld %14lld\n", name, usage.total(), static_cast<long long>(measured),
+                        static_cast<long long>(peak));
+            std::printf("  %s\n", usage.to_string().c_str());
+        }
+    }
+    std::printf("\n");
+
+    for (size_t zones : {1, 16}) {
+        Plot plot("Farm", "agricultural", zb::bench_datum());
+        for (size_t z = 0; z < zones; ++z)
+            plot.add_zone(make_zone(100, 1.0, static_cast<uint32_t>(z)));
+        runner.run("memory_usage/plot/z" + std::to_string(zones), static_cast<double>(zones), [&] {
+            auto usage = plot.memory_usage();
+            zb::do_not_optimize(usage);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Plot persistence: directory and tar save/load across zone counts, manifest verification against a full load, and
+// the batched file I/O backends (io_uring vs thread pool) on many small files
+
+#include "bench.hpp"
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+namespace {
+
+    Plot make_plot(size_t zones, size_t elements_per_zone) {
+        const auto datum = zb::bench_datum();
+        Plot plot("Farm", "agricultural", datum);
+        for (size_t z = 0; z < zones; ++z) {
+            auto boundary = zb::synthetic_field(64, 100.0, static_cast<uint32_t>(z + 1));
+            Zone zone("field" + std::to_string(z), "field", boundary, datum, 1.0);
+            zone.set_property("crop_type", "wheat");
+            const auto points = zb::random_points(elements_per_zone, 60.0, static_cast<uint32_t>(z + 100));
+            for (size_t i = 0; i < points.size(); ++i) {
+                zone.poly().add_point_element(generateUUID(), "p" + std::to_string(i), "marker", "default", points[i]);
+            }
+            plot.add_zone(zone);
+        }
+        return plot;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+
+    for (size_t zones : {1, 4, 16}) {
+        auto plot = make_plot(zones, 100);
+        const std::string n = "/z" + std::to_string(zones);
+        const double items = static_cast<double>(zones);
+
+        auto dir = zb::scratch_dir("dir" + n.substr(1));
+        runner.run("plot/save" + n, items, [&] { plot.save(dir); });
+        plot.save(dir);
+        runner.run("plot/load" + n, items, [&] {
+            auto loaded = Plot::load(dir, "Farm", "agricultural", zb::bench_datum());
+            zb::do_not_optimize(loaded);
+        });
+        runner.run("plot/verify" + n, items, [&] {
+            auto report = Plot::verify(dir);
+            zb::do_not_optimize(report);
+        });
+
+        auto tar = zb::scratch_dir("tar" + n.substr(1)) / "plot.tar";
+        runner.run("plot/save_tar" + n, items, [&] { plot.save_tar(tar); });
+        plot.save_tar(tar);
+        runner.run("plot/load_tar" + n, items, [&] {
+            auto loaded = Plot::load_tar(tar, "Farm", "agricultural", zb::bench_datum());
+            zb::do_not_optimize(loaded);
+        });
+        runner.run("plot/verify_tar" + n, items, [&] {
+            auto report = Plot::verify(tar);
+            zb::do_not_optimize(report);
+        });
+
+        std::filesystem::remove_all(dir);
+        std::filesystem::remove_all(tar.parent_path());
+    }
+
+    // A large plot, where per-zone file writes dominate the save
+    if (runner.enabled("plot/save/z5000")) {
+        auto plot = make_plot(5000, 10);
+        auto dir = zb::scratch_dir("dir5000");
+        runner.run("plot/save/z5000", 5000.0, [&] { plot.save(dir); });
+        std::filesystem::remove_all(dir);
+    }
+
+    // Many small files, the shape of a large plot's zone directory
+    auto small = zb::scratch_dir("small_files");
+    std::vector<fileio::File> files(1024);
+    for (size_t i = 0; i < files.size(); ++i) {
+        files[i].path = small / ("f" + std::to_string(i));
+        files[i].data = std::string(4096, static_cast<char>('a' + i % 26));
+    }
+    std::vector<fileio::Backend> backends{fileio::Backend::Threads};
+    if (fileio::backend() == fileio::Backend::IoUring)
+        backends.push_back(fileio::Backend::IoUring);
+    for (auto backend : backends) {
+        fileio::Options io;
+        io.backend = backend;
+        const std::string name = fileio::backend_name(backend);
+        const double items = static_cast<double>(files.size());
+        runner.run("fileio/write_4k/" + name, items, [&] { fileio::write(files, io); });
+        runner.run("fileio/read_4k/" + name, items, [&] {
+            std::vector<fileio::File> back(files.size());
+            for (size_t i = 0; i < files.size(); ++i)
+                back[i].path = files[i].path;
+            fileio::read(back, io);
+            zb::do_not_optimize(back);
+        });
+    }
+    std::filesystem::remove_all(small);
+    return 0;
+}
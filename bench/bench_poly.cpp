@@ -0,0 +1,58 @@
+// Poly/Zone queries: point-in-boundary and element lookups across element counts
+
+#include "bench.hpp"
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+    const auto datum = zb::bench_datum();
+
+    for (size_t vertices : {8, 64, 512}) {
+        Zone zone("field", "field", zb::synthetic_field(vertices, 150.0), datum, 1.0);
+        const auto points = zb::random_points(1024, 160.0);
+        runner.run("poly/contains/v" + std::to_string(vertices), static_cast<double>(points.size()), [&] {
+            size_t inside = 0;
+            for (const auto &p : points)
+                inside += zone.contains(p);
+            zb::do_not_optimize(inside);
+        });
+    }
+
+    for (size_t elements : {10, 100, 1000}) {
+        Zone zone("field", "field", zb::synthetic_field(64, 150.0), datum, 1.0);
+        const auto centers = zb::random_points(elements, 90.0, 11);
+        for (size_t i = 0; i < elements; ++i) {
+            zone.poly().add_point_element(generateUUID(), "p" + std::to_string(i), "marker", "default", centers[i]);
+            zone.poly().add_polygon_element(generateUUID(), "obstacle" + std::to_string(i), "obstacle", "default",
+                                            zb::square(centers[i], 2.0));
+        }
+        const std::string n = "/e" + std::to_string(elements);
+
+        dp::AABB box;
+        box.min_point = dp::Point{-25.0, -25.0, 0.0};
+        box.max_point = dp::Point{25.0, 25.0, 0.0};
+        runner.run("poly/point_elements_in_area" + n, static_cast<double>(elements), [&] {
+            auto found = zone.point_elements_in_area(box);
+            zb::do_not_optimize(found);
+        });
+        runner.run("poly/polygon_elements_in_area" + n, static_cast<double>(elements), [&] {
+            auto found = zone.polygon_elements_in_area(box);
+            zb::do_not_optimize(found);
+        });
+
+        const auto area = zb::synthetic_field(32, 50.0, 3);
+        runner.run("poly/points_in_polygon" + n, static_cast<double>(elements), [&] {
+            auto found = zone.points_in_polygon(area);
+            zb::do_not_optimize(found);
+        });
+        runner.run("poly/polygons_by_type" + n, static_cast<double>(elements), [&] {
+            auto found = zone.poly().polygons_by_type("obstacle");
+            zb::do_not_optimize(found);
+        });
+    }
+    return 0;
+}
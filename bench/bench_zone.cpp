@@ -0,0 +1,60 @@
+// Zone construction: boundary rasterization across vertex counts and resolutions, plus the real fields in misc/
+
+#include "bench.hpp"
+
+#include "vectkit/vectkit.hpp"
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+namespace zb = zoneout::bench;
+
+int main(int argc, char **argv) {
+    zb::Runner runner(argc, argv);
+    const auto datum = zb::bench_datum();
+
+    for (size_t vertices : {8, 64, 512}) {
+        for (double resolution : {1.0, 0.5}) {
+            auto boundary = zb::synthetic_field(vertices, 150.0);
+            auto probe = Zone("probe", "field", boundary, datum, resolution);
+            const double cells = static_cast<double>(probe.layer_rows(0) * probe.layer_cols(0));
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "zone/construct/v%zu/r%g", vertices, resolution);
+            runner.run(name, cells, [&] {
+                Zone zone("field", "field", boundary, datum, resolution);
+                zb::do_not_optimize(zone);
+            });
+        }
+    }
+
+    for (const char *file : {"field4.geojson", "wur.geojson"}) {
+        auto path = zb::misc_file(file);
+        if (path.empty()) {
+            std::fprintf(stderr, "skipping %s: not found\n", file);
+            continue;
+        }
+        auto collection = vectkit::ReadFeatureCollection(path.string());
+        for (const auto &feature : collection.features) {
+            const auto *polygon = std::get_if<dp::Polygon>(&feature.geometry);
+            if (polygon == nullptr)
+                continue;
+            auto probe = Zone("probe", "field", *polygon, collection.datum, 1.0);
+            const double cells = static_cast<double>(probe.layer_rows(0) * probe.layer_cols(0));
+            runner.run(std::string("zone/construct/") + file, cells, [&] {
+                Zone zone("field", "field", *polygon, collection.datum, 1.0);
+                zb::do_not_optimize(zone);
+            });
+            break; // first polygon is the field boundary
+        }
+    }
+
+    {
+        auto boundary = zb::synthetic_field(64, 150.0);
+        Zone zone("field", "field", boundary, datum, 0.5);
+        runner.run("zone/add_coverage_layer/r0.5", 1.0, [&] {
+            size_t index = zone.add_coverage_layer();
+            zone.grid().remove_layer(index);
+        });
+    }
+    return 0;
+}
@@ -4,9 +4,13 @@
 
 #include <datapod/datapod.hpp>
 
+#include "zoneout/lod.hpp"
+#include "zoneout/plot.hpp"
 #include "zoneout/zone.hpp"
 #include <array>
+#include <map>
 #include <rerun/archetypes/geo_line_strings.hpp>
+#include <rerun/archetypes/image.hpp>
 #include <rerun/archetypes/line_strips3d.hpp>
 #include <rerun/components/color.hpp>
 #include <rerun/components/geo_line_string.hpp>
@@ -15,7 +19,7 @@
 #include <rerun/result.hpp>
 #include <vector>
 
-#include <concord/frame/convert.hpp>
+#include "zoneout/utils/geodesy.hpp"
 
 namespace zoneout {
     namespace visualize {
@@ -24,13 +28,44 @@ namespace zoneout {
          * @brief Convert ENU point to WGS84 LatLon for geo visualization
          */
         inline rerun::components::LatLon enu_to_latlon(const datapod::Point &enu_pt, const datapod::Geo &datum) {
-            // Create ENU with origin
-            concord::frame::ENU enu{enu_pt.x, enu_pt.y, enu_pt.z, datum};
-            // Convert to WGS
-            auto wgs = concord::frame::to_wgs(enu);
+            auto wgs = LocalFrame(datum).to_wgs(enu_pt);
             return rerun::components::LatLon{float(wgs.latitude), float(wgs.longitude)};
         }
 
+        /**
+         * @brief Convert a vertex ring to LatLon in one batch, appending the first vertex again if `close` is set
+         */
+        inline std::vector<rerun::components::LatLon> ring_to_latlon(const std::vector<datapod::Point> &vertices,
+                                                                     const LocalFrame &frame, bool close) {
+            std::vector<rerun::components::LatLon> coords;
+            coords.reserve(vertices.size() + 1);
+            for (const auto &wgs : frame.to_wgs(vertices)) {
+                coords.push_back(rerun::components::LatLon{float(wgs.latitude), float(wgs.longitude)});
+            }
+            if (close && !coords.empty()) {
+                coords.push_back(coords.front());
+            }
+            return coords;
+        }
+
+        /**
+         * @brief ENU line strip at a fixed height; repeats the first vertex if the ring is open and reports that
+         */
+        inline std::vector<std::array<float, 3>> ring_to_enu(const std::vector<datapod::Point> &vertices, float height,
+                                                             bool &closed_here) {
+            std::vector<std::array<float, 3>> points;
+            points.reserve(vertices.size() + 1);
+            for (const auto &point : vertices) {
+                points.push_back({float(point.x), float(point.y), height});
+            }
+            closed_here = !points.empty() && (points.front()[0] != points.back()[0] ||
+                                              points.front()[1] != points.back()[1]);
+            if (closed_here) {
+                points.push_back(points.front());
+            }
+            return points;
+        }
+
         /**
          * @brief Visualize a single zone - ENU and WGS coordinates
          */
@@ -64,20 +99,10 @@ namespace zoneout {
 
             auto color = palette[color_index % palette.size()];
 
-            // ENU coordinates visualization (local 3D space)
-            std::vector<std::array<float, 3>> enu_points;
-            std::vector<rerun::components::LatLon> wgs_coords;
-            for (const auto &point : vertices) {
-                enu_points.push_back({float(point.x), float(point.y), 0.0f});
-                wgs_coords.push_back(enu_to_latlon(point, datum));
-            }
-
-            // Close the polygon if not already closed
-            if (!enu_points.empty() &&
-                (enu_points.front()[0] != enu_points.back()[0] || enu_points.front()[1] != enu_points.back()[1])) {
-                enu_points.push_back(enu_points.front());
-                wgs_coords.push_back(wgs_coords.front());
-            }
+            // ENU coordinates visualization (local 3D space), closed if the ring is open
+            bool closed = false;
+            auto enu_points = ring_to_enu(vertices, 0.0f, closed);
+            auto wgs_coords = ring_to_latlon(vertices, LocalFrame(datum), closed);
 
             std::cout << "Visualizing zone: " << zone_name << " with " << enu_points.size() << " points" << std::endl;
 
@@ -127,17 +152,9 @@ namespace zoneout {
 
             auto color = palette[color_index % palette.size()];
 
-            // ENU coordinates visualization (local 3D space)
-            std::vector<std::array<float, 3>> enu_points;
-            for (const auto &point : vertices) {
-                enu_points.push_back({float(point.x), float(point.y), 0.0f});
-            }
-
-            // Close the polygon if not already closed
-            if (!enu_points.empty() &&
-                (enu_points.front()[0] != enu_points.back()[0] || enu_points.front()[1] != enu_points.back()[1])) {
-                enu_points.push_back(enu_points.front());
-            }
+            // ENU coordinates visualization (local 3D space), closed if the ring is open
+            bool closed = false;
+            auto enu_points = ring_to_enu(vertices, 0.0f, closed);
 
             std::cout << "Visualizing zone: " << zone_name << " with " << enu_points.size() << " points" << std::endl;
 
@@ -155,24 +172,15 @@ namespace zoneout {
                                           const datapod::Geo &datum, const std::string &zone_name,
                                           float height = 0.1f) {
             const auto &elements = zone.poly().polygon_elements();
+            const LocalFrame frame(datum);
 
             for (size_t i = 0; i < elements.size(); ++i) {
                 const auto &element = elements[i];
                 const auto &vertices = element.geometry.vertices;
 
-                std::vector<std::array<float, 3>> enu_points;
-                std::vector<rerun::components::LatLon> wgs_coords;
-                for (const auto &point : vertices) {
-                    enu_points.push_back({float(point.x), float(point.y), height});
-                    wgs_coords.push_back(enu_to_latlon(point, datum));
-                }
-
-                // Close polygon
-                if (!enu_points.empty() &&
-                    (enu_points.front()[0] != enu_points.back()[0] || enu_points.front()[1] != enu_points.back()[1])) {
-                    enu_points.push_back(enu_points.front());
-                    wgs_coords.push_back(wgs_coords.front());
-                }
+                bool closed = false;
+                auto enu_points = ring_to_enu(vertices, height, closed);
+                auto wgs_coords = ring_to_latlon(vertices, frame, closed);
 
                 std::string entity_path = "/" + zone_name + "/elements/" + element.type + std::to_string(i);
 
@@ -200,16 +208,8 @@ namespace zoneout {
                 const auto &element = elements[i];
                 const auto &vertices = element.geometry.vertices;
 
-                std::vector<std::array<float, 3>> enu_points;
-                for (const auto &point : vertices) {
-                    enu_points.push_back({float(point.x), float(point.y), height});
-                }
-
-                // Close polygon
-                if (!enu_points.empty() &&
-                    (enu_points.front()[0] != enu_points.back()[0] || enu_points.front()[1] != enu_points.back()[1])) {
-                    enu_points.push_back(enu_points.front());
-                }
+                bool closed = false;
+                auto enu_points = ring_to_enu(vertices, height, closed);
 
                 std::string entity_path = "/" + zone_name + "/elements/" + element.type + std::to_string(i);
 
@@ -220,6 +220,88 @@ namespace zoneout {
             }
         }
 
+        /**
+         * @brief Level-of-detail settings for the batched logging functions
+         */
+        struct LodOptions {
+            double tolerance = 0.0;      // metres; simplifies rings and culls smaller elements, 0 keeps full detail
+            size_t max_image_side = 512; // raster previews are box-filtered down to this many pixels per side
+            float element_height = 0.1f;
+        };
+
+        /**
+         * @brief Visualize polygon elements with one LineStrips3D and one GeoLineStrings per element type
+         */
+        inline void show_polygon_elements_batched(const Zone &zone, std::shared_ptr<rerun::RecordingStream> rec,
+                                                  const datapod::Geo &datum, const std::string &zone_name,
+                                                  const LodOptions &options = {}) {
+            struct Batch {
+                std::vector<rerun::components::LineStrip3D> enu;
+                std::vector<rerun::components::GeoLineString> wgs;
+            };
+            std::map<std::string, Batch> batches;
+            const LocalFrame frame(datum);
+
+            for (const auto &element : zone.poly().polygon_elements()) {
+                if (!lod::visible(element.geometry.vertices, options.tolerance)) {
+                    continue;
+                }
+                const auto ring = lod::simplify(element.geometry.vertices, options.tolerance);
+                bool closed = false;
+                auto &batch = batches[element.type];
+                batch.enu.emplace_back(ring_to_enu(ring, options.element_height, closed));
+                auto coords = ring_to_latlon(ring, frame, closed);
+                batch.wgs.push_back(rerun::components::GeoLineString::from_lat_lon(coords));
+            }
+
+            for (auto &[type, batch] : batches) {
+                const std::string entity_path = "/" + zone_name + "/elements/" + type;
+                rec->log_static(entity_path, rerun::archetypes::LineStrips3D(std::move(batch.enu))
+                                                 .with_colors({{rerun::components::Color(200, 200, 100)}})
+                                                 .with_radii({{0.3f}}));
+                rec->log_static(entity_path, rerun::archetypes::GeoLineStrings(std::move(batch.wgs))
+                                                 .with_colors({{rerun::components::Color(200, 200, 100)}})
+                                                 .with_radii({{1.5f}}));
+            }
+        }
+
+        /**
+         * @brief Log a numeric raster layer as a downsampled grayscale image
+         */
+        inline void show_raster_layer(const Zone &zone, std::shared_ptr<rerun::RecordingStream> rec,
+                                      const std::string &zone_name, size_t layer_index,
+                                      const LodOptions &options = {}) {
+            auto image = lod::downsample(zone.grid().get_layer(layer_index), options.max_image_side);
+            if (image.pixels.empty()) {
+                return;
+            }
+            rec->log_static("/" + zone_name + "/raster/" + std::to_string(layer_index),
+                            rerun::archetypes::Image::from_grayscale8(
+                                std::move(image.pixels),
+                                rerun::WidthHeight(static_cast<uint32_t>(image.width),
+                                                   static_cast<uint32_t>(image.height))));
+        }
+
+        /**
+         * @brief Visualize every zone of a plot: boundary, batched elements and raster previews
+         */
+        inline void show_plot(const Plot &plot, std::shared_ptr<rerun::RecordingStream> rec,
+                              const LodOptions &options = {}) {
+            const auto &zones = plot.zones();
+            for (size_t i = 0; i < zones.size(); ++i) {
+                const auto &zone = zones[i];
+                show_zone(zone, rec, zone.datum(), zone.name(), i);
+                show_polygon_elements_batched(zone, rec, zone.datum(), zone.name(), options);
+                for (size_t layer = 0; layer < zone.grid().layer_count(); ++layer) {
+                    try {
+                        show_raster_layer(zone, rec, zone.name(), layer, options);
+                    } catch (const std::invalid_argument &) {
+                        // Colour layers have no grayscale preview
+                    }
+                }
+            }
+        }
+
     } // namespace visualize
 } // namespace zoneout
 
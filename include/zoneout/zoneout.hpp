@@ -7,9 +7,26 @@
 #include "visualize.hpp"
 #endif
 
+#include "zoneout/zoneout/coverage.hpp"
 #include "zoneout/zoneout/io.hpp"
+#include "zoneout/zoneout/isoxml.hpp"
+#include "zoneout/zoneout/journal.hpp"
+#include "zoneout/zoneout/layer_stats.hpp"
+#include "zoneout/zoneout/locator.hpp"
+#include "zoneout/zoneout/lod.hpp"
+#include "zoneout/zoneout/manifest.hpp"
 #include "zoneout/zoneout/plot.hpp"
 #include "zoneout/zoneout/polygrid.hpp"
+#include "zoneout/zoneout/snapshot.hpp"
+#include "zoneout/zoneout/sync.hpp"
+#include "zoneout/zoneout/temporal.hpp"
+#include "zoneout/zoneout/tile_delta.hpp"
+#include "zoneout/zoneout/tlg.hpp"
+#include "zoneout/zoneout/utils/async.hpp"
+#include "zoneout/zoneout/utils/executor.hpp"
+#include "zoneout/zoneout/utils/geodesy.hpp"
+#include "zoneout/zoneout/utils/memory.hpp"
+#include "zoneout/zoneout/utils/metrics.hpp"
 #include "zoneout/zoneout/utils/time.hpp"
 #include "zoneout/zoneout/utils/uuid.hpp"
 #include "zoneout/zoneout/zone.hpp"
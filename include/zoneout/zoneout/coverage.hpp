@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "layer_stats.hpp"
+#include "tile_delta.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Incremental coverage layer fed by implement footprints
+     *
+     * Each pose update sweeps the implement bar (width perpendicular to the heading) from the previous pose to the
+     * new one. The swept quad is rasterized by span filling in grid index space, so an update costs time
+     * proportional to the cells it touches and never rescans the layer. The covered cell count is kept up to
+     * date as cells flip, and the touched tiles are recorded for journaling/sync. Given the layer's LayerStats, it
+     * also accounts each footprint's newly covered cells there in one update, so the stats stay current without
+     * going through Grid::set_cell cell by cell.
+     *
+     * Holds a reference to the layer grid (and stats): keep them alive (and the layer vector unchanged) while in
+     * use.
+     */
+    class CoverageAccumulator {
+      private:
+        dp::Grid<uint8_t> *grid_;
+        double implement_width_;
+        uint8_t covered_value_;
+        LayerStats *stats_;
+
+        // World -> fractional (row, col): p = origin + col * col_step + row * row_step
+        dp::Point origin_;
+        double inv_[4] = {0, 0, 0, 0};
+
+        std::vector<uint8_t> inside_; // 1 where the cell center lies inside the boundary
+        size_t total_cells_ = 0;
+        size_t covered_cells_ = 0;
+        TileChanges changes_;
+
+        bool has_previous_ = false;
+        dp::Point previous_{};
+        double previous_heading_ = 0.0;
+
+        struct Vec {
+            double r, c;
+        };
+
+        inline Vec to_index(double x, double y) const {
+            double dx = x - origin_.x;
+            double dy = y - origin_.y;
+            return Vec{inv_[2] * dx + inv_[3] * dy, inv_[0] * dx + inv_[1] * dy};
+        }
+
+        inline size_t fill_triangle(const Vec &a, const Vec &b, const Vec &c) {
+            constexpr double eps = 1e-9;
+            const double rmin = std::min({a.r, b.r, c.r});
+            const double rmax = std::max({a.r, b.r, c.r});
+            if (rmax < 0.0 || rmin > static_cast<double>(grid_->rows - 1))
+                return 0;
+
+            const long r0 = std::max(0L, static_cast<long>(std::ceil(rmin - eps)));
+            const long r1 = std::min(static_cast<long>(grid_->rows) - 1, static_cast<long>(std::floor(rmax + eps)));
+            const Vec edges[3][2] = {{a, b}, {b, c}, {c, a}};
+            const long last_col = static_cast<long>(grid_->cols) - 1;
+
+            size_t newly = 0;
+            for (long r = r0; r <= r1; ++r) {
+                const double y = static_cast<double>(r);
+                double cmin = std::numeric_limits<double>::max();
+                double cmax = std::numeric_limits<double>::lowest();
+                for (const auto &edge : edges) {
+                    const Vec &p = edge[0];
+                    const Vec &q = edge[1];
+                    if ((y < std::min(p.r, q.r) - eps) || (y > std::max(p.r, q.r) + eps))
+                        continue;
+                    if (std::abs(q.r - p.r) < eps) {
+                        cmin = std::min({cmin, p.c, q.c});
+                        cmax = std::max({cmax, p.c, q.c});
+                    } else {
+                        double t = std::clamp((y - p.r) / (q.r - p.r), 0.0, 1.0);
+                        double x = p.c + t * (q.c - p.c);
+                        cmin = std::min(cmin, x);
+                        cmax = std::max(cmax, x);
+                    }
+                }
+                if (cmin > cmax)
+                    continue;
+                const long c0 = std::max(0L, static_cast<long>(std::ceil(cmin - eps)));
+                const long c1 = std::min(last_col, static_cast<long>(std::floor(cmax + eps)));
+                if (c0 > c1)
+                    continue;
+
+                const size_t row_offset = static_cast<size_t>(r) * grid_->cols;
+                uint8_t *cells = grid_->data.data() + row_offset;
+                const uint8_t *inside = inside_.data() + row_offset;
+                for (long col = c0; col <= c1; ++col) {
+                    if (inside[col] && cells[col] == 0) {
+                        cells[col] = covered_value_;
+                        ++newly;
+                    }
+                }
+                changes_.mark_rect(static_cast<size_t>(r), static_cast<size_t>(c0), static_cast<size_t>(r),
+                                   static_cast<size_t>(c1));
+            }
+            return newly;
+        }
+
+        inline size_t sweep(const dp::Point &from, double from_heading, const dp::Point &to, double to_heading) {
+            const double half = implement_width_ * 0.5;
+            auto bar = [&](const dp::Point &p, double heading, Vec &left, Vec &right) {
+                const double nx = -std::sin(heading) * half;
+                const double ny = std::cos(heading) * half;
+                left = to_index(p.x + nx, p.y + ny);
+                right = to_index(p.x - nx, p.y - ny);
+            };
+            Vec l0, r0, l1, r1;
+            bar(from, from_heading, l0, r0);
+            bar(to, to_heading, l1, r1);
+
+            size_t newly = fill_triangle(l0, r0, r1);
+            newly += fill_triangle(l0, r1, l1);
+            covered_cells_ += newly;
+            if (stats_ != nullptr) {
+                // Only empty cells are painted, so the footprint is one bulk 0 -> covered_value_ change
+                stats_->update(0.0, static_cast<double>(covered_value_), newly);
+            }
+            return newly;
+        }
+
+      public:
+        /**
+         * @param grid            Coverage layer; cells != 0 count as covered
+         * @param implement_width Working width in meters
+         * @param boundary        Cells whose centers fall outside are never painted or counted (empty = whole grid)
+         * @param covered_value   Value written into newly covered cells
+         * @param stats           Statistics of the layer to keep current, if it has any
+         */
+        inline CoverageAccumulator(dp::Grid<uint8_t> &grid, double implement_width,
+                                   const dp::Polygon &boundary = dp::Polygon{}, uint8_t covered_value = 255,
+                                   LayerStats *stats = nullptr)
+            : grid_(&grid), implement_width_(implement_width), covered_value_(covered_value), stats_(stats),
+              changes_(grid) {
+            if (implement_width <= 0.0) {
+                throw std::invalid_argument("Implement width must be positive");
+            }
+            if (covered_value == 0) {
+                throw std::invalid_argument("Covered value must be non-zero");
+            }
+            if (grid.rows == 0 || grid.cols == 0) {
+                throw std::invalid_argument("Coverage grid is empty");
+            }
+
+            // Derive the cell affine transform from the grid itself rather than assuming an axis convention
+            origin_ = grid.get_point(0, 0);
+            dp::Point col_step = grid.get_point(0, 1) - origin_;
+            dp::Point row_step = grid.get_point(1, 0) - origin_;
+            double det = col_step.x * row_step.y - col_step.y * row_step.x;
+            if (std::abs(det) < 1e-12) {
+                throw std::invalid_argument("Coverage grid has a degenerate cell transform");
+            }
+            inv_[0] = row_step.y / det;
+            inv_[1] = -row_step.x / det;
+            inv_[2] = -col_step.y / det;
+            inv_[3] = col_step.x / det;
+
+            // One-time scan: boundary mask and the coverage already present in the layer
+            inside_.assign(grid.rows * grid.cols, 1);
+            const bool clip = boundary.vertices.size() >= 3;
+            for (size_t r = 0; r < grid.rows; ++r) {
+                for (size_t c = 0; c < grid.cols; ++c) {
+                    size_t idx = r * grid.cols + c;
+                    if (clip && !boundary.contains(grid.get_point(r, c))) {
+                        inside_[idx] = 0;
+                        continue;
+                    }
+                    ++total_cells_;
+                    if (grid.data[idx] != 0) {
+                        ++covered_cells_;
+                    }
+                }
+            }
+        }
+
+        /// Move the implement to `position` with the given heading (radians, CCW from +x). Returns newly covered cells.
+        inline size_t add_pose(const dp::Point &position, double heading) {
+            size_t newly = 0;
+            if (has_previous_) {
+                newly = sweep(previous_, previous_heading_, position, heading);
+            }
+            previous_ = position;
+            previous_heading_ = heading;
+            has_previous_ = true;
+            return newly;
+        }
+
+        /// Like add_pose, with the heading taken from the direction of travel (stationary updates are ignored)
+        inline size_t add_position(const dp::Point &position) {
+            if (!has_previous_) {
+                previous_ = position;
+                has_previous_ = true;
+                return 0;
+            }
+            double dx = position.x - previous_.x;
+            double dy = position.y - previous_.y;
+            if (dx * dx + dy * dy < 1e-18) {
+                return 0;
+            }
+            double heading = std::atan2(dy, dx);
+            size_t newly = sweep(previous_, heading, position, heading);
+            previous_ = position;
+            previous_heading_ = heading;
+            return newly;
+        }
+
+        /// Lift the implement: the next pose starts a new swath instead of sweeping from the last one
+        inline void lift() { has_previous_ = false; }
+
+        inline double implement_width() const { return implement_width_; }
+        inline void set_implement_width(double width) {
+            if (width <= 0.0) {
+                throw std::invalid_argument("Implement width must be positive");
+            }
+            implement_width_ = width;
+        }
+
+        inline size_t covered_cells() const { return covered_cells_; }
+        inline size_t total_cells() const { return total_cells_; }
+        inline double cell_area() const { return grid_->resolution * grid_->resolution; }
+        inline double covered_area() const { return static_cast<double>(covered_cells_) * cell_area(); }
+
+        inline double coverage_ratio() const {
+            return total_cells_ == 0 ? 0.0 : static_cast<double>(covered_cells_) / static_cast<double>(total_cells_);
+        }
+
+        inline double coverage_percent() const { return coverage_ratio() * 100.0; }
+
+        /// Tiles touched since the last clear_changes() (feed to encode_tile_delta / journaling)
+        inline const TileChanges &changes() const { return changes_; }
+        inline void clear_changes() { changes_.clear(); }
+    };
+
+} // namespace zoneout
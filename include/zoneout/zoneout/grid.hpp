@@ -1,15 +1,25 @@
 #pragma once
 
+#include <algorithm>
 #include <filesystem>
+#include <iostream>
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <variant>
+#include <vector>
 
 #include <concord/concord.hpp>
 #include <datapod/datapod.hpp>
 #include <rastkit/rastkit.hpp>
 
+#include "layer_stats.hpp"
+#include "temporal.hpp"
+#include "utils/memory.hpp"
 #include "utils/meta.hpp"
+#include "utils/time.hpp"
 #include "utils/uuid.hpp"
 
 namespace dp = datapod;
@@ -20,21 +30,119 @@ namespace zoneout {
       private:
         Meta meta_;
         rastkit::RasterCollection raster_;
+        // Time-series layers, kept out of raster_.layers so they never shift layer indices
+        std::map<std::string, TemporalLayerVariant> temporal_layers_;
+        // Opt-in incremental statistics, keyed by layer index
+        std::map<size_t, LayerStats> layer_stats_;
+
+        inline std::unordered_map<std::string, std::string> global_properties() const {
+            return {{"name", meta_.name},
+                    {"type", meta_.type},
+                    {"subtype", meta_.subtype},
+                    {"uuid", meta_.id.toString()}};
+        }
 
         inline void sync_to_global_properties() {
             if (has_layers()) {
-                std::unordered_map<std::string, std::string> props;
-                props["name"] = meta_.name;
-                props["type"] = meta_.type;
-                props["subtype"] = meta_.subtype;
-                props["uuid"] = meta_.id.toString();
-                raster_.setGlobalPropertiesOnAllLayers(props);
+                raster_.setGlobalPropertiesOnAllLayers(global_properties());
+            }
+        }
+
+        /// Whether every layer still carries this grid's identity tags (raster() hands out mutable layers)
+        inline bool global_properties_current() const {
+            const auto props = global_properties();
+            for (const auto &layer : raster_.layers) {
+                for (const auto &[key, value] : props) {
+                    if (layer.getGlobalProperty(key) != value) {
+                        return false;
+                    }
+                }
             }
+            return true;
+        }
+
+        /// Rescan layer `index` into `stats`
+        inline void rebuild_layer_stats(size_t index, LayerStats &stats) const {
+            std::visit(
+                [&](const auto &g) {
+                    using CellType = typename std::decay_t<decltype(g.data)>::value_type;
+                    if constexpr (std::is_arithmetic_v<CellType>) {
+                        stats.rebuild(g);
+                    } else {
+                        throw std::invalid_argument("Layer statistics need a numeric layer");
+                    }
+                },
+                get_layer(index).grid);
+        }
+
+        /// Move layers tagged by to_file() back into their temporal layers (oldest first)
+        inline void extract_temporal_layers() {
+            struct Slice {
+                uint64_t time_ms;
+                size_t index;
+                bool placeholder;
+            };
+            std::map<std::string, std::vector<Slice>> slices;
+            std::map<std::string, size_t> capacities;
+            for (size_t i = 0; i < raster_.layers.size(); ++i) {
+                auto props = raster_.layers[i].getGlobalProperties();
+                auto name_it = props.find("temporal_name");
+                if (name_it == props.end())
+                    continue;
+                auto time_it = props.find("temporal_time");
+                auto capacity_it = props.find("temporal_capacity");
+                bool placeholder = time_it == props.end();
+                uint64_t time_ms = placeholder ? 0 : std::stoull(time_it->second);
+                size_t capacity = capacity_it != props.end() ? std::stoull(capacity_it->second) : 1;
+                slices[name_it->second].push_back({time_ms, i, placeholder});
+                capacities[name_it->second] = std::max(capacities[name_it->second], capacity);
+            }
+            if (slices.empty())
+                return;
+
+            std::vector<bool> consumed(raster_.layers.size(), false);
+            for (auto &[layer_name, entries] : slices) {
+                std::stable_sort(entries.begin(), entries.end(),
+                                 [](const Slice &a, const Slice &b) { return a.time_ms < b.time_ms; });
+                std::visit(
+                    [&](const auto &first) {
+                        using CellType = typename std::decay_t<decltype(first.data)>::value_type;
+                        if constexpr (std::is_constructible_v<TemporalLayerVariant, TemporalLayer<CellType>>) {
+                            TemporalLayer<CellType> series(first.rows, first.cols,
+                                                           std::max(capacities[layer_name], entries.size()),
+                                                           first.resolution, first.centered, first.pose);
+                            for (const auto &entry : entries) {
+                                const auto *grid = raster_.layers[entry.index].template gridIf<CellType>();
+                                if (grid == nullptr || grid->rows != first.rows || grid->cols != first.cols)
+                                    continue;
+                                if (!entry.placeholder)
+                                    series.push(time_utils::fromMilliseconds(entry.time_ms), *grid);
+                                consumed[entry.index] = true;
+                            }
+                            temporal_layers_.insert_or_assign(layer_name, std::move(series));
+                        } else {
+                            std::cerr << "Warning: Temporal layer '" << layer_name
+                                      << "' has an unsupported cell type, kept as regular layers" << std::endl;
+                        }
+                    },
+                    raster_.layers[entries.front().index].grid);
+            }
+
+            std::vector<rastkit::Layer> regular;
+            regular.reserve(raster_.layers.size());
+            for (size_t i = 0; i < raster_.layers.size(); ++i) {
+                if (!consumed[i])
+                    regular.push_back(std::move(raster_.layers[i]));
+            }
+            raster_.layers = std::move(regular);
         }
 
       public:
         inline Grid() : meta_("", "other", "default"), raster_() {}
 
+        /// Empty Grid with a null id (no random draw); used for temporaries that are filled in from a file
+        inline explicit Grid(NullIdTag) : meta_(UUID(null_id), "", "other", "default"), raster_() {}
+
         inline Grid(const std::string &name, const std::string &type, const std::string &subtype = "default")
             : meta_(name, type, subtype), raster_() {}
 
@@ -85,7 +193,7 @@ namespace zoneout {
 
             rastkit::RasterCollection raster_data = rastkit::ReadRasterCollection(file_path);
 
-            Grid grid;
+            Grid grid(null_id);
             grid.raster_ = std::move(raster_data);
 
             auto global_props = grid.raster_.getGlobalPropertiesFromFirstLayer();
@@ -108,14 +216,71 @@ namespace zoneout {
             auto uuid_it = global_props.find("uuid");
             if (uuid_it != global_props.end()) {
                 grid.meta_.id = UUID(uuid_it->second);
+            } else {
+                grid.meta_.id.generate();
             }
 
+            grid.extract_temporal_layers();
             return grid;
         }
 
+        /// Write the raster collection; never touches this grid's own layers, so safe alongside other readers
         inline void to_file(const std::filesystem::path &file_path) const {
-            const_cast<Grid *>(this)->sync_to_global_properties();
-            rastkit::WriteRasterCollection(raster_, file_path);
+            if (temporal_layers_.empty() && global_properties_current()) {
+                rastkit::WriteRasterCollection(raster_, file_path);
+                return;
+            }
+
+            // rastkit only writes an owning collection, so anything that has to differ from raster_ (stale
+            // identity tags, temporal slices as extra tagged layers) goes into a separate one
+            rastkit::RasterCollection collection;
+            collection.datum = raster_.datum;
+            collection.shift = raster_.shift;
+            collection.resolution = raster_.resolution;
+            size_t slices = 0;
+            for (const auto &[layer_name, temporal] : temporal_layers_) {
+                slices += std::visit([](const auto &series) { return std::max<size_t>(series.size(), 1); }, temporal);
+            }
+            collection.layers.reserve(raster_.layers.size() + slices);
+            collection.layers.insert(collection.layers.end(), raster_.layers.begin(), raster_.layers.end());
+            collection.setGlobalPropertiesOnAllLayers(global_properties());
+            for (const auto &[layer_name, temporal] : temporal_layers_) {
+                std::visit(
+                    [&](const auto &series) {
+                        using CellType = typename std::decay_t<decltype(series)>::value_type;
+                        // An empty series is kept as a single untimed placeholder slice
+                        const size_t count = std::max<size_t>(series.size(), 1);
+                        for (size_t i = 0; i < count; ++i) {
+                            rastkit::Layer layer;
+                            layer.width = static_cast<uint32_t>(series.cols());
+                            layer.height = static_cast<uint32_t>(series.rows());
+                            layer.samplesPerPixel = 1;
+                            layer.planarConfig = 1;
+                            layer.datum = raster_.datum;
+                            layer.shift = raster_.shift;
+                            layer.resolution = raster_.resolution;
+                            if (series.empty()) {
+                                layer.grid = dp::make_grid<CellType>(series.rows(), series.cols(), series.resolution(),
+                                                                     series.centered(), series.pose(), CellType{});
+                            } else {
+                                layer.grid = series.to_grid(i);
+                            }
+                            layer.setGlobalProperty("name", meta_.name);
+                            layer.setGlobalProperty("type", meta_.type);
+                            layer.setGlobalProperty("subtype", meta_.subtype);
+                            layer.setGlobalProperty("uuid", meta_.id.toString());
+                            layer.setGlobalProperty("temporal_name", layer_name);
+                            layer.setGlobalProperty("temporal_capacity", std::to_string(series.capacity()));
+                            if (!series.empty()) {
+                                layer.setGlobalProperty("temporal_time",
+                                                        std::to_string(time_utils::toMilliseconds(series.time(i))));
+                            }
+                            collection.layers.push_back(std::move(layer));
+                        }
+                    },
+                    temporal);
+            }
+            rastkit::WriteRasterCollection(collection, file_path);
         }
 
         inline void add_grid(uint32_t width, uint32_t height, const std::string &name, const std::string &type = "",
@@ -146,7 +311,9 @@ namespace zoneout {
             sync_to_global_properties();
         }
 
-        inline void add_grid(const dp::Grid<uint8_t> &grid, const std::string &name, const std::string &type = "",
+        /// Add a layer holding a copy of `grid` (any cell type the raster variant supports)
+        template <typename T>
+        inline void add_grid(const dp::Grid<T> &grid, const std::string &name, const std::string &type = "",
                              const std::unordered_map<std::string, std::string> &properties = {}) {
             rastkit::Layer layer;
             layer.width = static_cast<uint32_t>(grid.cols);
@@ -195,6 +362,12 @@ namespace zoneout {
         inline bool remove_layer(size_t index) {
             if (index < raster_.layers.size()) {
                 raster_.layers.erase(raster_.layers.begin() + static_cast<std::ptrdiff_t>(index));
+                std::map<size_t, LayerStats> shifted;
+                for (auto &[i, stats] : layer_stats_) {
+                    if (i != index)
+                        shifted.emplace(i > index ? i - 1 : i, std::move(stats));
+                }
+                layer_stats_ = std::move(shifted);
                 return true;
             }
             return false;
@@ -206,15 +379,17 @@ namespace zoneout {
                 auto props = raster_.layers[i].getGlobalProperties();
                 auto it = props.find("name");
                 if (it != props.end() && it->second == layer_name) {
-                    raster_.layers.erase(raster_.layers.begin() + static_cast<std::ptrdiff_t>(i));
-                    return true;
+                    return remove_layer(i);
                 }
             }
             return false;
         }
 
         /// Clear all layers
-        inline void clear_layers() { raster_.layers.clear(); }
+        inline void clear_layers() {
+            raster_.layers.clear();
+            layer_stats_.clear();
+        }
 
         /// Find layer index by name. Returns dp::Optional containing index if found.
         inline dp::Optional<size_t> layer_index_by_name(const std::string &layer_name) const {
@@ -245,6 +420,158 @@ namespace zoneout {
             }
             return dp::nullopt;
         }
+
+        // ============ Temporal Layers ============
+
+        /// Add a ring-buffered time series of `capacity` slices, shaped rows x cols on this grid's geometry
+        template <typename T>
+        inline TemporalLayer<T> &add_temporal_layer(const std::string &layer_name, size_t capacity, size_t rows,
+                                                    size_t cols) {
+            if (temporal_layers_.find(layer_name) != temporal_layers_.end()) {
+                throw std::invalid_argument("Temporal layer already exists: " + layer_name);
+            }
+            auto [it, inserted] = temporal_layers_.emplace(
+                layer_name, TemporalLayer<T>(rows, cols, capacity, raster_.resolution, true, raster_.shift));
+            return std::get<TemporalLayer<T>>(it->second);
+        }
+
+        /// Same, shaped like the first regular layer
+        template <typename T>
+        inline TemporalLayer<T> &add_temporal_layer(const std::string &layer_name, size_t capacity) {
+            if (!has_layers()) {
+                throw std::runtime_error("Temporal layer needs a shape: grid has no layers");
+            }
+            auto [rows, cols] = rastkit::get_grid_dimensions(raster_.layers[0].grid);
+            return add_temporal_layer<T>(layer_name, capacity, rows, cols);
+        }
+
+        template <typename T>
+        inline dp::Optional<std::reference_wrapper<TemporalLayer<T>>> temporal_layer(const std::string &layer_name) {
+            auto it = temporal_layers_.find(layer_name);
+            if (it != temporal_layers_.end()) {
+                if (auto *series = std::get_if<TemporalLayer<T>>(&it->second))
+                    return std::ref(*series);
+            }
+            return dp::nullopt;
+        }
+
+        template <typename T>
+        inline dp::Optional<std::reference_wrapper<const TemporalLayer<T>>>
+        temporal_layer(const std::string &layer_name) const {
+            auto it = temporal_layers_.find(layer_name);
+            if (it != temporal_layers_.end()) {
+                if (const auto *series = std::get_if<TemporalLayer<T>>(&it->second))
+                    return std::cref(*series);
+            }
+            return dp::nullopt;
+        }
+
+        inline bool has_temporal_layer(const std::string &layer_name) const {
+            return temporal_layers_.find(layer_name) != temporal_layers_.end();
+        }
+
+        inline bool remove_temporal_layer(const std::string &layer_name) {
+            return temporal_layers_.erase(layer_name) > 0;
+        }
+
+        inline size_t temporal_layer_count() const { return temporal_layers_.size(); }
+
+        inline const std::map<std::string, TemporalLayerVariant> &temporal_layers() const { return temporal_layers_; }
+
+        // ============ Memory Accounting ============
+
+        /// Add this grid's raster, temporal and statistics footprint to `usage`
+        inline void memory_usage(MemoryUsage &usage) const {
+            usage.raster_bytes += memory::vector_heap(raster_.layers);
+            for (const auto &layer : raster_.layers) {
+                size_t cells = std::visit([](const auto &g) { return memory::vector_heap(g.data); }, layer.grid);
+                usage.raster_layer_bytes.push_back(cells);
+                usage.raster_bytes += cells + memory::map_heap(layer.getGlobalProperties()) +
+                                      memory::string_heap(layer.imageDescription);
+            }
+            for (const auto &[name, series] : temporal_layers_) {
+                usage.temporal_bytes += std::visit([](const auto &t) { return t.memory_bytes(); }, series);
+                usage.temporal_bytes += memory::string_heap(name) + sizeof(TemporalLayerVariant) + 4 * sizeof(void *);
+            }
+            for (const auto &[index, stats] : layer_stats_) {
+                usage.stats_bytes += stats.memory_bytes() + sizeof(LayerStats) + 4 * sizeof(void *);
+            }
+            usage.property_bytes += memory::string_heap(meta_.name) + memory::string_heap(meta_.type) +
+                                    memory::string_heap(meta_.subtype);
+        }
+
+        // ============ Layer Statistics ============
+
+        /// Start maintaining statistics for a layer (one full scan); later writes through set_cell keep them current
+        inline const LayerStats &enable_layer_stats(size_t index) {
+            auto &stats = layer_stats_[index];
+            try {
+                rebuild_layer_stats(index, stats);
+            } catch (...) {
+                layer_stats_.erase(index);
+                throw;
+            }
+            return stats;
+        }
+
+        inline void disable_layer_stats(size_t index) { layer_stats_.erase(index); }
+
+        inline bool has_layer_stats(size_t index) const { return layer_stats_.find(index) != layer_stats_.end(); }
+
+        inline dp::Optional<std::reference_wrapper<const LayerStats>> layer_stats(size_t index) const {
+            auto it = layer_stats_.find(index);
+            if (it != layer_stats_.end())
+                return std::cref(it->second);
+            return dp::nullopt;
+        }
+
+        /// Writable statistics of a tracked layer (nullptr if untracked), for bulk writers that do their own accounting;
+        /// stale statistics are rebuilt first. Writers call settle_layer_stats() when done.
+        inline LayerStats *mutable_layer_stats(size_t index) {
+            auto it = layer_stats_.find(index);
+            if (it == layer_stats_.end())
+                return nullptr;
+            if (it->second.stale())
+                rebuild_layer_stats(index, it->second);
+            return &it->second;
+        }
+
+        /// Rescan a tracked layer whose statistics went stale during a write (no-op otherwise)
+        inline void settle_layer_stats(size_t index) {
+            auto it = layer_stats_.find(index);
+            if (it != layer_stats_.end() && it->second.stale()) {
+                rebuild_layer_stats(index, it->second);
+            }
+        }
+
+        /// Rescan a tracked layer after writing its data directly
+        inline void refresh_layer_stats(size_t index) {
+            auto it = layer_stats_.find(index);
+            if (it != layer_stats_.end()) {
+                rebuild_layer_stats(index, it->second);
+            }
+        }
+
+        /// Write one cell, keeping the layer's statistics (if enabled) in step
+        template <typename T> inline void set_cell(size_t index, size_t r, size_t c, T value) {
+            auto *grid = get_layer(index).template gridIf<T>();
+            if (grid == nullptr) {
+                throw std::invalid_argument("set_cell: value type does not match the layer");
+            }
+            if (r >= grid->rows || c >= grid->cols) {
+                throw std::out_of_range("set_cell: cell out of range");
+            }
+            T &cell = (*grid)(r, c);
+            if constexpr (std::is_arithmetic_v<T>) {
+                if (auto *stats = mutable_layer_stats(index)) {
+                    stats->update(static_cast<double>(cell), static_cast<double>(value));
+                    cell = value;
+                    settle_layer_stats(index);
+                    return;
+                }
+            }
+            cell = value;
+        }
     };
 
 } // namespace zoneout
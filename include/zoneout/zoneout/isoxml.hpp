@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "plot.hpp"
+#include "utils/async.hpp"
+#include "utils/geodesy.hpp"
+#include "utils/metrics.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief ISO 11783-10 (ISOXML) task data export
+     *
+     * Each zone becomes a partfield (PFD: boundary, elements, guidance) and a task (TSK) carrying one prescription
+     * grid. uint8 layers are written as type 1 grids (cell = treatment zone code, one TZN per code in use); other
+     * numeric layers as type 2 grids (cell = int32 rate). Grid binaries are streamed row by row straight from the
+     * layer, south row first, and zones are exported in parallel. Grids must be north-up (no rotation).
+     */
+    namespace isoxml {
+
+        struct ExportOptions {
+            std::string manufacturer = "Zoneout";
+            std::string software_version = "1.0";
+            bool include_grids = true;
+            size_t prescription_layer = 0; // layer index exported as each task's grid (ISOXML allows one per task)
+            uint16_t ddi = 0x0006;         // process data variable of the rates (default: setpoint mass per area)
+            double value_scale = 1.0;      // layer value -> DDI units, applied to TZN rates and type 2 cells
+            bool include_guidance = true;  // line elements typed "guidance" / subtyped "ab-line" become GPNs
+            uint8_t no_treatment_code = 0; // TZN written, at rate 0, for uint8 cells holding 255 (nodata)
+            size_t threads = 0;            // 0 = all the executor offers
+        };
+
+        namespace detail {
+
+            inline std::string escape(const std::string &s) {
+                std::string out;
+                out.reserve(s.size());
+                for (char ch : s) {
+                    switch (ch) {
+                    case '&':
+                        out += "&amp;";
+                        break;
+                    case '<':
+                        out += "&lt;";
+                        break;
+                    case '>':
+                        out += "&gt;";
+                        break;
+                    case '"':
+                        out += "&quot;";
+                        break;
+                    case '\'':
+                        out += "&apos;";
+                        break;
+                    default:
+                        out += ch;
+                    }
+                }
+                return out;
+            }
+
+            inline std::string degrees(double value) {
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), "%.9f", value);
+                return buf;
+            }
+
+            inline std::string grid_filename(size_t number) {
+                char buf[16];
+                std::snprintf(buf, sizeof(buf), "GRD%05zu", number);
+                return buf;
+            }
+
+            inline int polygon_type(const std::string &type) {
+                if (type == "boundary")
+                    return 1;
+                if (type == "treatment")
+                    return 2;
+                if (type == "water")
+                    return 3;
+                if (type == "building")
+                    return 4;
+                if (type == "road")
+                    return 5;
+                if (type == "obstacle")
+                    return 6;
+                if (type == "headland")
+                    return 10;
+                if (type == "buffer")
+                    return 11;
+                if (type == "windbreak")
+                    return 12;
+                return 8; // other
+            }
+
+            inline int line_type(const std::string &type) {
+                if (type == "sampling")
+                    return 4;
+                if (type == "drainage")
+                    return 6;
+                if (type == "fence")
+                    return 7;
+                return 3; // tram line
+            }
+
+            inline int point_type(const std::string &type) {
+                if (type == "flag")
+                    return 1;
+                if (type == "access")
+                    return 3;
+                if (type == "storage")
+                    return 4;
+                if (type == "obstacle")
+                    return 5;
+                return 2; // other
+            }
+
+            inline bool is_guidance(const LineElement &line) {
+                return line.type == "guidance" || line.subtype == "ab-line";
+            }
+
+            /// PNT elements for `points`; `type_of(i)` gives each point's ISOXML type
+            template <typename TypeOf>
+            inline void write_points(std::ostream &os, const std::vector<dp::Point> &points, const LocalFrame &frame,
+                                     const std::string &indent, TypeOf type_of) {
+                const auto geos = frame.to_wgs(points);
+                for (size_t i = 0; i < geos.size(); ++i) {
+                    os << indent << "<PNT A=\"" << type_of(i) << "\" C=\"" << degrees(geos[i].latitude) << "\" D=\""
+                       << degrees(geos[i].longitude) << "\"/>\n";
+                }
+            }
+
+            inline void write_polygon(std::ostream &os, int type, const std::string &name,
+                                      const std::vector<dp::Point> &ring, const LocalFrame &frame,
+                                      const std::string &indent) {
+                os << indent << "<PLN A=\"" << type << "\" B=\"" << escape(name) << "\">\n";
+                os << indent << "  <LSG A=\"1\">\n";
+                write_points(os, ring, frame, indent + "    ", [](size_t) { return 2; });
+                os << indent << "  </LSG>\n";
+                os << indent << "</PLN>\n";
+            }
+
+            /// Geometry of a north-up layer grid in WGS84: south-west corner and cell size in degrees
+            struct GridGeometry {
+                double min_north = 0.0;
+                double min_east = 0.0;
+                double cell_north = 0.0;
+                double cell_east = 0.0;
+                bool north_row_first = true;
+            };
+
+            template <typename T> inline GridGeometry grid_geometry(const dp::Grid<T> &grid, const LocalFrame &frame) {
+                const auto origin = grid.get_point(0, 0);
+                const auto right = grid.cols > 1 ? grid.get_point(0, 1) : dp::Point{origin.x + grid.resolution,
+                                                                                     origin.y, 0.0};
+                const auto below = grid.rows > 1 ? grid.get_point(1, 0) : dp::Point{origin.x,
+                                                                                     origin.y - grid.resolution, 0.0};
+                const double eps = grid.resolution * 1e-6;
+                if (std::abs(right.y - origin.y) > eps || std::abs(below.x - origin.x) > eps || right.x < origin.x) {
+                    throw std::invalid_argument("ISOXML export needs a north-up grid");
+                }
+
+                GridGeometry geo;
+                geo.north_row_first = below.y < origin.y;
+                const double half = grid.resolution / 2.0;
+                const auto south_row = geo.north_row_first ? grid.rows - 1 : 0;
+                const auto sw_center = grid.get_point(south_row, 0);
+                const auto sw = frame.to_wgs(dp::Point{sw_center.x - half, sw_center.y - half, 0.0});
+                geo.min_north = sw.latitude;
+                geo.min_east = sw.longitude;
+
+                // Cell size in degrees at the middle of the grid
+                const double mid_x = sw_center.x - half + grid.cols * grid.resolution / 2.0;
+                const double mid_y = sw_center.y - half + grid.rows * grid.resolution / 2.0;
+                const auto south = frame.to_wgs(dp::Point{mid_x, mid_y - half, 0.0});
+                const auto north = frame.to_wgs(dp::Point{mid_x, mid_y + half, 0.0});
+                const auto west = frame.to_wgs(dp::Point{mid_x - half, mid_y, 0.0});
+                const auto east = frame.to_wgs(dp::Point{mid_x + half, mid_y, 0.0});
+                geo.cell_north = north.latitude - south.latitude;
+                geo.cell_east = east.longitude - west.longitude;
+                return geo;
+            }
+
+            /// Highest TreatmentZoneCode ISO 11783-10 allows
+            inline constexpr int max_treatment_zone = 254;
+
+            /**
+             * @brief Rows south to north straight from the layer; returns the bytes written
+             *
+             * Type 1 cells holding 255, which is not a valid zone code, are written as `no_treatment_code`
+             * when `remap_nodata` is set.
+             */
+            template <typename T>
+            inline uint64_t write_grid_binary(const dp::Grid<T> &grid, bool north_row_first, double value_scale,
+                                              bool remap_nodata, uint8_t no_treatment_code,
+                                              const std::filesystem::path &path) {
+                std::ofstream out(path, std::ios::binary);
+                if (!out) {
+                    throw std::runtime_error("Cannot write ISOXML grid: " + path.string());
+                }
+                std::vector<char> row;
+                if (!std::is_same_v<T, uint8_t> || remap_nodata) {
+                    row.resize(grid.cols * (std::is_same_v<T, uint8_t> ? 1 : 4));
+                }
+                for (size_t i = 0; i < grid.rows; ++i) {
+                    const size_t r = north_row_first ? grid.rows - 1 - i : i;
+                    if constexpr (std::is_same_v<T, uint8_t>) {
+                        const auto *cells = reinterpret_cast<const char *>(&grid(r, 0));
+                        if (remap_nodata) {
+                            std::replace_copy(cells, cells + grid.cols, row.begin(), static_cast<char>(0xFF),
+                                              static_cast<char>(no_treatment_code));
+                            cells = row.data();
+                        }
+                        out.write(cells, static_cast<std::streamsize>(grid.cols));
+                    } else {
+                        for (size_t c = 0; c < grid.cols; ++c) {
+                            const double v = static_cast<double>(grid(r, c)) * value_scale;
+                            const auto rate =
+                                std::isnan(v) ? 0L : std::lround(std::clamp(v, -2147483648.0, 2147483647.0));
+                            const auto cell = static_cast<uint32_t>(static_cast<int32_t>(rate));
+                            row[c * 4 + 0] = static_cast<char>(cell & 0xFF);
+                            row[c * 4 + 1] = static_cast<char>((cell >> 8) & 0xFF);
+                            row[c * 4 + 2] = static_cast<char>((cell >> 16) & 0xFF);
+                            row[c * 4 + 3] = static_cast<char>((cell >> 24) & 0xFF);
+                        }
+                        out.write(row.data(), static_cast<std::streamsize>(row.size()));
+                    }
+                }
+                if (!out) {
+                    throw std::runtime_error("Failed writing ISOXML grid: " + path.string());
+                }
+                return static_cast<uint64_t>(grid.rows) * grid.cols * (std::is_same_v<T, uint8_t> ? 1 : 4);
+            }
+
+            inline std::string ddi_hex(uint16_t ddi) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "%04X", ddi);
+                return buf;
+            }
+
+            /// TZN/GRD part of a task for the prescription layer; writes the binary as a side effect
+            template <typename T>
+            inline void write_task_grid(std::ostream &os, const dp::Grid<T> &grid, const LocalFrame &frame,
+                                        const ExportOptions &options, const std::filesystem::path &dir,
+                                        size_t grid_number) {
+                const auto geo = grid_geometry(grid, frame);
+                const auto name = grid_filename(grid_number);
+                const auto ddi = ddi_hex(options.ddi);
+
+                int grid_type = 2;
+                bool remap_nodata = false;
+                if constexpr (std::is_same_v<T, uint8_t>) {
+                    grid_type = 1;
+                    std::array<bool, 256> used{};
+                    for (uint8_t v : grid.data)
+                        used[v] = true;
+                    // 255 is out of the TreatmentZoneCode range; those cells fall into the no-treatment zone
+                    const int no_treatment = options.no_treatment_code;
+                    remap_nodata = used[255];
+                    if (no_treatment > max_treatment_zone) {
+                        throw std::invalid_argument("ISOXML no-treatment code must be at most 254");
+                    }
+                    if (remap_nodata && used[static_cast<size_t>(no_treatment)] &&
+                        std::llround(no_treatment * options.value_scale) != 0) {
+                        throw std::invalid_argument("ISOXML no-treatment code " + std::to_string(no_treatment) +
+                                                    " is also used as a treatment zone with a non-zero rate");
+                    }
+                    for (int code = 0; code <= max_treatment_zone; ++code) {
+                        if (remap_nodata && code == no_treatment) {
+                            os << "    <TZN A=\"" << code << "\" B=\"no treatment\">\n";
+                            os << "      <PDV A=\"" << ddi << "\" B=\"0\"/>\n";
+                            os << "    </TZN>\n";
+                            continue;
+                        }
+                        if (!used[static_cast<size_t>(code)])
+                            continue;
+                        os << "    <TZN A=\"" << code << "\" B=\"zone " << code << "\">\n";
+                        os << "      <PDV A=\"" << ddi << "\" B=\"" << std::llround(code * options.value_scale)
+                           << "\"/>\n";
+                        os << "    </TZN>\n";
+                    }
+                } else {
+                    os << "    <TZN A=\"1\" B=\"prescription\">\n";
+                    os << "      <PDV A=\"" << ddi << "\" B=\"0\"/>\n";
+                    os << "    </TZN>\n";
+                }
+
+                const auto bytes = write_grid_binary(grid, geo.north_row_first, options.value_scale, remap_nodata,
+                                                     options.no_treatment_code, dir / (name + ".BIN"));
+                ZONEOUT_METRIC_COUNT("isoxml.grid_bytes_written", bytes);
+                os << "    <GRD A=\"" << degrees(geo.min_north) << "\" B=\"" << degrees(geo.min_east) << "\" C=\""
+                   << degrees(geo.cell_north) << "\" D=\"" << degrees(geo.cell_east) << "\" E=\"" << grid.cols
+                   << "\" F=\"" << grid.rows << "\" G=\"" << name << "\" H=\"" << bytes << "\" I=\"" << grid_type
+                   << "\"";
+                if (grid_type == 2) {
+                    os << " J=\"1\"";
+                }
+                os << "/>\n";
+            }
+
+            /// Guidance lines a zone exports as GPN elements
+            inline size_t guidance_count(const Zone &zone, const ExportOptions &options) {
+                if (!options.include_guidance)
+                    return 0;
+                const auto &lines = zone.poly().line_elements();
+                return static_cast<size_t>(std::count_if(lines.begin(), lines.end(), is_guidance));
+            }
+
+            /**
+             * @brief PFD and TSK elements of one zone
+             *
+             * `number` is its 1-based position (ids and grid file name); its GPN ids continue the export-wide
+             * sequence from `first_gpn`, since ISOXML ids are a prefix plus a plain number.
+             */
+            inline std::string zone_fragment(const Zone &zone, size_t number, size_t first_gpn,
+                                             const ExportOptions &options, const std::filesystem::path &dir) {
+                const LocalFrame frame(zone.datum());
+                const auto &poly = zone.poly();
+                const std::string pfd = "PFD" + std::to_string(number);
+                std::ostringstream os;
+
+                os << "  <PFD A=\"" << pfd << "\" C=\"" << escape(zone.name()) << "\" D=\""
+                   << static_cast<uint64_t>(std::llround(poly.area())) << "\">\n";
+                if (poly.has_field_boundary()) {
+                    write_polygon(os, 1, zone.name(), poly.field_boundary().vertices, frame, "    ");
+                }
+                for (const auto &element : poly.polygon_elements()) {
+                    write_polygon(os, polygon_type(element.type), element.name, element.geometry.vertices, frame,
+                                  "    ");
+                }
+                for (const auto &line : poly.line_elements()) {
+                    if (options.include_guidance && is_guidance(line))
+                        continue;
+                    os << "    <LSG A=\"" << line_type(line.type) << "\" B=\"" << escape(line.name) << "\">\n";
+                    write_points(os, {line.geometry.start, line.geometry.end}, frame, "      ",
+                                 [](size_t) { return 2; });
+                    os << "    </LSG>\n";
+                }
+                for (const auto &point : poly.point_elements()) {
+                    const int type = point_type(point.type);
+                    const auto geo = frame.to_wgs(point.geometry);
+                    os << "    <PNT A=\"" << type << "\" B=\"" << escape(point.name) << "\" C=\""
+                       << degrees(geo.latitude) << "\" D=\"" << degrees(geo.longitude) << "\"/>\n";
+                }
+                if (options.include_guidance) {
+                    size_t pattern = 0;
+                    for (const auto &line : poly.line_elements()) {
+                        if (!is_guidance(line))
+                            continue;
+                        if (pattern == 0) {
+                            os << "    <GGP A=\"GGP" << number << "\" B=\"" << escape(zone.name()) << "\">\n";
+                        }
+                        ++pattern;
+                        os << "      <GPN A=\"GPN" << first_gpn + pattern - 1 << "\" B=\"" << escape(line.name)
+                           << "\" C=\"1\">\n";
+                        os << "        <LSG A=\"5\">\n";
+                        // Guidance reference points A and B
+                        write_points(os, {line.geometry.start, line.geometry.end}, frame, "          ",
+                                     [](size_t i) { return i == 0 ? 6 : 7; });
+                        os << "        </LSG>\n";
+                        os << "      </GPN>\n";
+                    }
+                    if (pattern > 0) {
+                        os << "    </GGP>\n";
+                    }
+                }
+                os << "  </PFD>\n";
+
+                os << "  <TSK A=\"TSK" << number << "\" B=\"" << escape(zone.name()) << "\" E=\"" << pfd
+                   << "\" G=\"1\">\n";
+                const auto &grid = zone.grid();
+                if (options.include_grids && options.prescription_layer < grid.layer_count()) {
+                    std::visit(
+                        [&](const auto &g) {
+                            using CellType = typename std::decay_t<decltype(g.data)>::value_type;
+                            if constexpr (std::is_arithmetic_v<CellType>) {
+                                write_task_grid(os, g, frame, options, dir, number);
+                            } else {
+                                throw std::invalid_argument("ISOXML export: prescription layer is not numeric");
+                            }
+                        },
+                        grid.get_layer(options.prescription_layer).grid);
+                }
+                os << "  </TSK>\n";
+                return os.str();
+            }
+
+        } // namespace detail
+
+        /**
+         * @brief Write `<output_dir>/TASKDATA/TASKDATA.XML` and one GRDnnnnn.BIN per zone
+         * @return The TASKDATA directory
+         */
+        inline std::filesystem::path export_zones(std::span<const Zone> zones, const std::filesystem::path &output_dir,
+                                                  const ExportOptions &options = {}) {
+            ZONEOUT_METRIC_TIMER("isoxml.export");
+            const auto dir = output_dir / "TASKDATA";
+            std::filesystem::create_directories(dir);
+
+            // GPN ids run across the whole export; each zone gets its starting number up front
+            std::vector<size_t> first_gpn(zones.size(), 1);
+            for (size_t i = 1; i < zones.size(); ++i) {
+                first_gpn[i] = first_gpn[i - 1] + detail::guidance_count(zones[i - 1], options);
+            }
+
+            std::vector<std::string> fragments(zones.size());
+            async::run(zones.size(), options.threads, {}, "ISOXML export", [&](size_t i) {
+                fragments[i] = detail::zone_fragment(zones[i], i + 1, first_gpn[i], options, dir);
+            });
+
+            const auto xml_path = dir / "TASKDATA.XML";
+            std::ofstream xml(xml_path);
+            if (!xml) {
+                throw std::runtime_error("Cannot write ISOXML task data: " + xml_path.string());
+            }
+            xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            xml << "<ISO11783_TaskData VersionMajor=\"4\" VersionMinor=\"3\" ManagementSoftwareManufacturer=\""
+                << detail::escape(options.manufacturer) << "\" ManagementSoftwareVersion=\""
+                << detail::escape(options.software_version) << "\" DataTransferOrigin=\"1\">\n";
+            for (const auto &fragment : fragments)
+                xml << fragment;
+            xml << "</ISO11783_TaskData>\n";
+            if (!xml) {
+                throw std::runtime_error("Failed writing ISOXML task data: " + xml_path.string());
+            }
+            ZONEOUT_METRIC_COUNT("isoxml.zones_exported", zones.size());
+            return dir;
+        }
+
+        inline std::filesystem::path export_zone(const Zone &zone, const std::filesystem::path &output_dir,
+                                                 const ExportOptions &options = {}) {
+            return export_zones(std::span<const Zone>(&zone, 1), output_dir, options);
+        }
+
+        inline std::filesystem::path export_plot(const Plot &plot, const std::filesystem::path &output_dir,
+                                                 const ExportOptions &options = {}) {
+            return export_zones(plot.zones(), output_dir, options);
+        }
+
+    } // namespace isoxml
+
+} // namespace zoneout
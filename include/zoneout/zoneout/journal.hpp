@@ -0,0 +1,918 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <datapod/datapod.hpp>
+
+#include "plot.hpp"
+#include "tile_delta.hpp"
+#include "utils/binary.hpp"
+#include "utils/checksum.hpp"
+#include "utils/metrics.hpp"
+#include "utils/uuid.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    namespace journal {
+
+        enum class RecordType : uint8_t {
+            PlotMeta = 1,
+            PlotProperty = 2,
+            PlotPropertyRemoved = 3,
+            ZoneAdded = 4,
+            ZoneRemoved = 5,
+            ZoneProperty = 6,
+            ZonePropertyRemoved = 7,
+            PolygonElementAdded = 8,
+            LineElementAdded = 9,
+            PointElementAdded = 10,
+            PolygonElementRemoved = 11,
+            LineElementRemoved = 12,
+            PointElementRemoved = 13,
+            RasterLayerAdded = 14,
+            RasterLayerUpdated = 15,
+        };
+
+        inline constexpr char journal_magic[4] = {'Z', 'O', 'J', '1'};
+        inline constexpr char snapshot_magic[4] = {'Z', 'O', 'S', '1'};
+        inline constexpr uint32_t format_version = 1;
+        // Frame header: u32 payload length + u32 CRC32C of the payload
+        inline constexpr size_t frame_header_size = 8;
+        inline constexpr size_t journal_header_size = sizeof(journal_magic) + sizeof(format_version);
+
+        struct Options {
+            /// Journal size (bytes) above which the next mutation folds the journal into a fresh snapshot
+            size_t compact_threshold = 8 * 1024 * 1024;
+            /// fsync after every record. Off by default: records are still flushed to the OS on every append, so
+            /// only an OS crash or power loss (not a process crash) can drop the tail; call sync() at checkpoints.
+            bool sync_every_record = false;
+        };
+
+        inline std::string read_file(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not read file: " + path.string());
+            }
+            std::ostringstream content;
+            content << file.rdbuf();
+            if (file.bad()) {
+                throw std::runtime_error("Could not read file: " + path.string());
+            }
+            return content.str();
+        }
+
+        /// Like read_file(), but a file that does not exist reads as empty
+        inline std::string read_file_if_exists(const std::filesystem::path &path) {
+            if (!std::filesystem::exists(path)) {
+                return {};
+            }
+            return read_file(path);
+        }
+
+        inline void write_file(const std::filesystem::path &path, std::string_view data) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not write file: " + path.string());
+            }
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        /// Flush and fsync an open stream; false if either step failed
+        inline bool sync_file(std::FILE *file) {
+            if (std::fflush(file) != 0)
+                return false;
+#if defined(__unix__) || defined(__APPLE__)
+            return ::fsync(::fileno(file)) == 0;
+#else
+            return true;
+#endif
+        }
+
+        using fileio::sync_path;
+
+        /// fsync every file below `root`, then every directory bottom-up, then `root` itself
+        inline void sync_tree(const std::filesystem::path &root) {
+            std::vector<std::filesystem::path> directories;
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+                if (entry.is_directory())
+                    directories.push_back(entry.path());
+                else if (entry.is_regular_file())
+                    sync_path(entry.path());
+            }
+            for (auto it = directories.rbegin(); it != directories.rend(); ++it) {
+                sync_path(*it);
+            }
+            sync_path(root);
+        }
+
+        /// Write all of `size` bytes or throw
+        inline void write_all(std::FILE *file, const void *data, size_t size, const std::filesystem::path &path) {
+            if (std::fwrite(data, 1, size, file) != size) {
+                throw std::runtime_error("Short write: " + path.string());
+            }
+        }
+
+    } // namespace journal
+
+    /**
+     * @brief Plot whose mutations are persisted as an append-only journal
+     *
+     * Every mutation is appended as a small checksummed record to `<directory>/journal.bin` and then applied to
+     * the in-memory Plot, so persisting an edit costs one short write instead of a full Plot::save. A failed
+     * append is cut off again and throws, leaving both the journal and the Plot as they were.
+     * Once the journal grows past Options::compact_threshold it is folded into `<directory>/snapshot` and
+     * truncated. open() restores the state as snapshot + replay of every intact record; a record torn by a
+     * power loss (short or failing its CRC) ends the replay and is cut off.
+     *
+     * Reads go through plot(). Mutating the Plot directly bypasses the journal and is only persisted by the
+     * next compact().
+     */
+    class JournaledPlot {
+      private:
+        std::filesystem::path directory_;
+        journal::Options options_;
+        Plot plot_;
+        std::FILE *journal_ = nullptr;
+        uint64_t sequence_ = 0;
+        size_t journal_bytes_ = 0;
+        bool failed_ = false; // an append could not be rolled back; the file no longer matches plot_
+        binary::Writer record_;
+
+        inline JournaledPlot(const std::filesystem::path &directory, Plot plot, const journal::Options &options)
+            : directory_(directory), options_(options), plot_(std::move(plot)) {}
+
+        inline std::filesystem::path journal_path() const { return directory_ / "journal.bin"; }
+        inline std::filesystem::path snapshot_path() const { return directory_ / "snapshot"; }
+
+        inline Zone &zone_or_throw(const UUID &zone_id) {
+            auto zone = plot_.zone(zone_id);
+            if (!zone.has_value()) {
+                throw std::runtime_error("Zone not found: " + zone_id.toString());
+            }
+            return zone->get();
+        }
+
+        inline void begin(journal::RecordType type) {
+            if (failed_) {
+                throw std::runtime_error("Journal is unusable after a failed append, reopen it: " +
+                                         journal_path().string());
+            }
+            record_.clear();
+            record_.u8(static_cast<uint8_t>(type));
+            record_.u64(sequence_ + 1);
+        }
+
+        /// Cut the journal back to its last complete record; if even that fails, refuse further writes
+        inline void discard_tail() {
+            close_journal();
+            try {
+                std::filesystem::resize_file(journal_path(), journal_bytes_);
+                open_journal();
+            } catch (...) {
+                close_journal();
+                failed_ = true;
+            }
+        }
+
+        /// Append the record built since begin(); on failure the journal is left as it was and this throws
+        inline void append() {
+            const auto &payload = record_.data();
+            uint32_t header[2] = {static_cast<uint32_t>(payload.size()), crc32c(payload)};
+            const char *error = nullptr;
+            if (std::fwrite(header, sizeof(header), 1, journal_) != 1 ||
+                std::fwrite(payload.data(), 1, payload.size(), journal_) != payload.size()) {
+                error = "Could not append to journal: ";
+            } else if (options_.sync_every_record ? !journal::sync_file(journal_) : std::fflush(journal_) != 0) {
+                error = "Could not sync journal: ";
+            }
+            if (error != nullptr) {
+                // A torn frame would end every later replay, dropping the records appended after it
+                discard_tail();
+                throw std::runtime_error(error + journal_path().string());
+            }
+            ++sequence_;
+            journal_bytes_ += journal::frame_header_size + payload.size();
+            ZONEOUT_METRIC_COUNT("journal.records_written", 1);
+            ZONEOUT_METRIC_COUNT("journal.bytes_written", journal::frame_header_size + payload.size());
+        }
+
+        inline void compact_if_needed() {
+            if (journal_bytes_ > options_.compact_threshold) {
+                compact();
+            }
+        }
+
+        /**
+         * @brief Append the record, then apply(): the change reaches plot_ only once it is in the journal
+         *
+         * Mutators validate before begin(), so apply() is not expected to throw; if it does anyway the record is
+         * cut off again, keeping the journal and plot_ in step.
+         */
+        template <typename Apply> inline void commit(Apply &&apply) {
+            const size_t before = journal_bytes_;
+            append();
+            try {
+                std::forward<Apply>(apply)();
+            } catch (...) {
+                --sequence_;
+                journal_bytes_ = before;
+                discard_tail();
+                throw;
+            }
+            compact_if_needed();
+        }
+
+        template <typename Elements> inline static bool contains(const Elements &elements, const UUID &id) {
+            return std::any_of(elements.begin(), elements.end(), [&](const auto &e) { return e.uuid == id; });
+        }
+
+        inline void open_journal() {
+            journal_ = std::fopen(journal_path().string().c_str(), "ab");
+            if (journal_ == nullptr) {
+                throw std::runtime_error("Could not open journal: " + journal_path().string());
+            }
+        }
+
+        inline void close_journal() {
+            if (journal_ != nullptr) {
+                std::fclose(journal_);
+                journal_ = nullptr;
+            }
+        }
+
+        inline void write_empty_journal(const std::filesystem::path &path) const {
+            binary::Writer header;
+            header.bytes(journal::journal_magic, sizeof(journal::journal_magic));
+            header.u32(journal::format_version);
+            std::FILE *file = std::fopen(path.string().c_str(), "wb");
+            if (file == nullptr) {
+                throw std::runtime_error("Could not create journal: " + path.string());
+            }
+            try {
+                journal::write_all(file, header.data().data(), header.size(), path);
+                if (!journal::sync_file(file))
+                    throw std::runtime_error("Could not sync journal: " + path.string());
+            } catch (...) {
+                std::fclose(file);
+                throw;
+            }
+            std::fclose(file);
+        }
+
+        // Zones are stored in their regular on-disk form (vector.geojson + raster.tiff) inside the record
+        inline void encode_zone(const Zone &zone) {
+            auto staging = directory_ / "zone.tmp";
+            std::filesystem::remove_all(staging);
+            zone.save(staging);
+            record_.str(journal::read_file(staging / "vector.geojson"));
+            // Zones without layers have no raster file; one with layers must have written it
+            record_.str(zone.layer_count() > 0 ? journal::read_file(staging / "raster.tiff")
+                                               : journal::read_file_if_exists(staging / "raster.tiff"));
+            std::filesystem::remove_all(staging);
+        }
+
+        inline Zone decode_zone(binary::Reader &in) const {
+            auto vector_bytes = in.view(in.u32());
+            auto raster_bytes = in.view(in.u32());
+            auto staging = directory_ / "zone.tmp";
+            std::filesystem::remove_all(staging);
+            std::filesystem::create_directories(staging);
+            if (!vector_bytes.empty()) {
+                journal::write_file(staging / "vector.geojson", vector_bytes);
+            }
+            if (!raster_bytes.empty()) {
+                journal::write_file(staging / "raster.tiff", raster_bytes);
+            }
+            auto zone = Zone::load(staging);
+            std::filesystem::remove_all(staging);
+            return zone;
+        }
+
+        inline Zone *replay_zone(const UUID &zone_id, uint64_t seq) {
+            auto zone = plot_.zone(zone_id);
+            if (!zone.has_value()) {
+                std::cerr << "Warning: Journal record " << seq << " references unknown zone " << zone_id.toString()
+                          << ", skipping" << std::endl;
+                return nullptr;
+            }
+            return &zone->get();
+        }
+
+        inline void apply(binary::Reader &in) {
+            auto type = static_cast<journal::RecordType>(in.u8());
+            uint64_t seq = in.u64();
+
+            switch (type) {
+            case journal::RecordType::PlotMeta: {
+                auto name = in.str();
+                auto plot_type = in.str();
+                auto datum = in.geo();
+                plot_.set_name(name);
+                plot_.set_type(plot_type);
+                plot_.set_datum(datum);
+                break;
+            }
+            case journal::RecordType::PlotProperty: {
+                auto key = in.str();
+                plot_.set_property(key, in.str());
+                break;
+            }
+            case journal::RecordType::PlotPropertyRemoved:
+                plot_.remove_property(in.str());
+                break;
+            case journal::RecordType::ZoneAdded:
+                plot_.add_zone(decode_zone(in));
+                break;
+            case journal::RecordType::ZoneRemoved:
+                plot_.remove_zone(in.uuid());
+                break;
+            case journal::RecordType::ZoneProperty: {
+                auto zone_id = in.uuid();
+                auto key = in.str();
+                auto value = in.str();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->set_property(key, value);
+                break;
+            }
+            case journal::RecordType::ZonePropertyRemoved: {
+                auto zone_id = in.uuid();
+                auto key = in.str();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->remove_property(key);
+                break;
+            }
+            case journal::RecordType::PolygonElementAdded: {
+                auto zone_id = in.uuid();
+                auto element_id = in.uuid();
+                auto color = in.u8();
+                auto geometry = in.polygon();
+                auto name = in.str();
+                auto element_type = in.str();
+                auto subtype = in.str();
+                auto props = in.properties();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->add_polygon_element(element_id, color, geometry, name, element_type, subtype, props);
+                break;
+            }
+            case journal::RecordType::LineElementAdded: {
+                auto zone_id = in.uuid();
+                auto element_id = in.uuid();
+                auto geometry = in.segment();
+                auto name = in.str();
+                auto element_type = in.str();
+                auto subtype = in.str();
+                auto props = in.properties();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->poly().add_line_element(element_id, name, element_type, subtype, geometry, props);
+                break;
+            }
+            case journal::RecordType::PointElementAdded: {
+                auto zone_id = in.uuid();
+                auto element_id = in.uuid();
+                auto geometry = in.point();
+                auto name = in.str();
+                auto element_type = in.str();
+                auto subtype = in.str();
+                auto props = in.properties();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->poly().add_point_element(element_id, name, element_type, subtype, geometry, props);
+                break;
+            }
+            case journal::RecordType::PolygonElementRemoved:
+            case journal::RecordType::LineElementRemoved:
+            case journal::RecordType::PointElementRemoved: {
+                auto zone_id = in.uuid();
+                auto element_id = in.uuid();
+                if (auto *zone = replay_zone(zone_id, seq)) {
+                    if (type == journal::RecordType::PolygonElementRemoved)
+                        zone->poly().remove_polygon_element(element_id);
+                    else if (type == journal::RecordType::LineElementRemoved)
+                        zone->poly().remove_line_element(element_id);
+                    else
+                        zone->poly().remove_point_element(element_id);
+                }
+                break;
+            }
+            case journal::RecordType::RasterLayerAdded: {
+                auto zone_id = in.uuid();
+                auto grid = in.grid<uint8_t>();
+                auto name = in.str();
+                auto layer_type = in.str();
+                auto props = in.properties();
+                bool poly_cut = in.boolean();
+                if (auto *zone = replay_zone(zone_id, seq))
+                    zone->add_raster_layer(grid, name, layer_type, props, poly_cut);
+                break;
+            }
+            case journal::RecordType::RasterLayerUpdated: {
+                auto zone_id = in.uuid();
+                auto layer_index = in.u32();
+                auto delta = in.view(in.u32());
+                auto *zone = replay_zone(zone_id, seq);
+                if (zone == nullptr)
+                    break;
+                if (layer_index >= zone->layer_count()) {
+                    std::cerr << "Warning: Journal record " << seq << " references missing layer " << layer_index
+                              << ", skipping" << std::endl;
+                    break;
+                }
+                auto *stats = zone->grid().mutable_layer_stats(layer_index);
+                std::visit([&](auto &grid) { apply_tile_delta(grid, delta, stats); }, zone->layer(layer_index).grid);
+                zone->grid().settle_layer_stats(layer_index);
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown journal record type " + std::to_string(static_cast<int>(type)));
+            }
+        }
+
+        /// Replay journal.bin on top of the loaded snapshot; returns the length of its intact prefix
+        inline size_t replay(uint64_t snapshot_sequence) {
+            auto content = journal::read_file_if_exists(journal_path());
+            if (content.size() < journal::journal_header_size) {
+                // Missing, or torn while being created
+                write_empty_journal(journal_path());
+                return journal::journal_header_size;
+            }
+            binary::Reader in(content);
+            auto magic = in.view(sizeof(journal::journal_magic));
+            if (magic != std::string_view(journal::journal_magic, sizeof(journal::journal_magic)) ||
+                in.u32() != journal::format_version) {
+                throw std::runtime_error("Not a zoneout journal: " + journal_path().string());
+            }
+
+            while (in.remaining() >= journal::frame_header_size) {
+                uint32_t length = in.u32();
+                uint32_t crc = in.u32();
+                if (length > in.remaining()) {
+                    break;
+                }
+                auto payload = in.view(length);
+                if (crc32c(payload) != crc) {
+                    break;
+                }
+
+                binary::Reader record(payload);
+                record.u8();
+                uint64_t seq = record.u64();
+                // Records already folded into the snapshot (compaction interrupted before the journal reset)
+                if (seq > snapshot_sequence) {
+                    binary::Reader full(payload);
+                    apply(full);
+                    sequence_ = seq;
+                }
+                journal_bytes_ = in.position();
+            }
+
+            if (journal_bytes_ < journal::journal_header_size) {
+                journal_bytes_ = journal::journal_header_size;
+            }
+            if (journal_bytes_ < content.size()) {
+                std::cerr << "Warning: Discarding " << content.size() - journal_bytes_
+                          << " bytes of incomplete journal tail in " << journal_path() << std::endl;
+                std::filesystem::resize_file(journal_path(), journal_bytes_);
+            }
+            return journal_bytes_;
+        }
+
+        inline static Plot load_snapshot(const std::filesystem::path &snapshot, uint64_t &sequence) {
+            auto content = journal::read_file_if_exists(snapshot / "plot.bin");
+            if (content.size() < journal::frame_header_size) {
+                throw std::runtime_error("Missing or truncated snapshot: " + snapshot.string());
+            }
+            binary::Reader frame(content);
+            uint32_t length = frame.u32();
+            uint32_t crc = frame.u32();
+            auto payload = frame.view(length);
+            if (crc32c(payload) != crc) {
+                throw std::runtime_error("Corrupt snapshot: " + snapshot.string());
+            }
+
+            binary::Reader in(payload);
+            if (in.view(sizeof(journal::snapshot_magic)) !=
+                std::string_view(journal::snapshot_magic, sizeof(journal::snapshot_magic))) {
+                throw std::runtime_error("Not a zoneout snapshot: " + snapshot.string());
+            }
+            sequence = in.u64();
+            auto id = in.uuid();
+            auto name = in.str();
+            auto type = in.str();
+            auto datum = in.geo();
+            auto properties = in.properties();
+            uint32_t zone_count = in.u32();
+
+            Plot plot(id, name, type, datum);
+            for (const auto &[key, value] : properties) {
+                plot.set_property(key, value);
+            }
+            // Zones are loaded by index so the snapshot preserves zone order (Plot::load iterates the directory)
+            for (uint32_t i = 0; i < zone_count; ++i) {
+                plot.add_zone(Zone::load(snapshot / ("zone_" + std::to_string(i))));
+            }
+            return plot;
+        }
+
+      public:
+        JournaledPlot(const JournaledPlot &) = delete;
+        JournaledPlot &operator=(const JournaledPlot &) = delete;
+
+        inline JournaledPlot(JournaledPlot &&other) noexcept
+            : directory_(std::move(other.directory_)), options_(other.options_), plot_(std::move(other.plot_)),
+              journal_(std::exchange(other.journal_, nullptr)), sequence_(other.sequence_),
+              journal_bytes_(other.journal_bytes_), failed_(other.failed_) {}
+
+        inline JournaledPlot &operator=(JournaledPlot &&other) noexcept {
+            if (this != &other) {
+                close_journal();
+                directory_ = std::move(other.directory_);
+                options_ = other.options_;
+                plot_ = std::move(other.plot_);
+                journal_ = std::exchange(other.journal_, nullptr);
+                sequence_ = other.sequence_;
+                journal_bytes_ = other.journal_bytes_;
+                failed_ = other.failed_;
+            }
+            return *this;
+        }
+
+        inline ~JournaledPlot() { close_journal(); }
+
+        /// Start journaling an existing plot; any previous journal state in `directory` is replaced
+        inline static JournaledPlot create(const std::filesystem::path &directory, Plot plot,
+                                           const journal::Options &options = {}) {
+            std::filesystem::create_directories(directory);
+            JournaledPlot journaled(directory, std::move(plot), options);
+            journaled.compact();
+            return journaled;
+        }
+
+        /// Recover the plot stored in `directory` (snapshot + journal replay). An empty directory starts a new
+        /// plot with the given name, type and datum.
+        inline static JournaledPlot open(const std::filesystem::path &directory, const std::string &name,
+                                         const std::string &type, const dp::Geo &datum,
+                                         const journal::Options &options = {}) {
+            auto snapshot = directory / "snapshot";
+            auto previous = directory / "snapshot.old";
+            // A compaction interrupted between its two renames leaves only the previous snapshot behind
+            if (!std::filesystem::exists(snapshot) && std::filesystem::exists(previous)) {
+                std::filesystem::rename(previous, snapshot);
+            }
+            if (!std::filesystem::exists(snapshot / "plot.bin")) {
+                return create(directory, Plot(name, type, datum), options);
+            }
+
+            uint64_t snapshot_sequence = 0;
+            JournaledPlot journaled(directory, load_snapshot(snapshot, snapshot_sequence), options);
+            journaled.sequence_ = snapshot_sequence;
+            journaled.replay(snapshot_sequence);
+            journaled.open_journal();
+            return journaled;
+        }
+
+        inline const Plot &plot() const { return plot_; }
+        inline const std::filesystem::path &directory() const { return directory_; }
+
+        /// Sequence number of the last applied mutation
+        inline uint64_t sequence() const { return sequence_; }
+
+        /// Current journal file size in bytes
+        inline size_t journal_size() const { return journal_bytes_; }
+
+        inline const journal::Options &options() const { return options_; }
+        inline void set_options(const journal::Options &options) { options_ = options; }
+
+        // ========== Plot mutations ==========
+
+        inline void set_name(const std::string &name) {
+            begin(journal::RecordType::PlotMeta);
+            record_.str(name);
+            record_.str(plot_.type());
+            record_.geo(plot_.datum());
+            commit([&] { plot_.set_name(name); });
+        }
+
+        inline void set_type(const std::string &type) {
+            begin(journal::RecordType::PlotMeta);
+            record_.str(plot_.name());
+            record_.str(type);
+            record_.geo(plot_.datum());
+            commit([&] { plot_.set_type(type); });
+        }
+
+        inline void set_datum(const dp::Geo &datum) {
+            begin(journal::RecordType::PlotMeta);
+            record_.str(plot_.name());
+            record_.str(plot_.type());
+            record_.geo(datum);
+            commit([&] { plot_.set_datum(datum); });
+        }
+
+        inline void set_property(const std::string &key, const std::string &value) {
+            begin(journal::RecordType::PlotProperty);
+            record_.str(key);
+            record_.str(value);
+            commit([&] { plot_.set_property(key, value); });
+        }
+
+        inline bool remove_property(const std::string &key) {
+            if (!plot_.has_property(key))
+                return false;
+            begin(journal::RecordType::PlotPropertyRemoved);
+            record_.str(key);
+            commit([&] { plot_.remove_property(key); });
+            return true;
+        }
+
+        inline void add_zone(const Zone &zone) {
+            begin(journal::RecordType::ZoneAdded);
+            encode_zone(zone);
+            commit([&] { plot_.add_zone(zone); });
+        }
+
+        inline bool remove_zone(const UUID &zone_id) {
+            if (!plot_.zone(zone_id).has_value())
+                return false;
+            begin(journal::RecordType::ZoneRemoved);
+            record_.uuid(zone_id);
+            commit([&] { plot_.remove_zone(zone_id); });
+            return true;
+        }
+
+        // ========== Zone mutations (throw if the zone does not exist) ==========
+
+        inline void set_zone_property(const UUID &zone_id, const std::string &key, const std::string &value) {
+            auto &zone = zone_or_throw(zone_id);
+            begin(journal::RecordType::ZoneProperty);
+            record_.uuid(zone_id);
+            record_.str(key);
+            record_.str(value);
+            commit([&] { zone.set_property(key, value); });
+        }
+
+        inline bool remove_zone_property(const UUID &zone_id, const std::string &key) {
+            auto &zone = zone_or_throw(zone_id);
+            if (!zone.has_property(key))
+                return false;
+            begin(journal::RecordType::ZonePropertyRemoved);
+            record_.uuid(zone_id);
+            record_.str(key);
+            commit([&] { zone.remove_property(key); });
+            return true;
+        }
+
+        inline UUID add_polygon_element(const UUID &zone_id, const dp::Polygon &geometry, const std::string &name,
+                                        const std::string &type = "", const std::string &subtype = "default",
+                                        const std::unordered_map<std::string, std::string> &properties = {}) {
+            auto &zone = zone_or_throw(zone_id);
+            const uint8_t color = Zone::random_polygon_color();
+            UUID element_id = generateUUID();
+
+            begin(journal::RecordType::PolygonElementAdded);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            record_.u8(color);
+            record_.polygon(geometry);
+            record_.str(name);
+            record_.str(type);
+            record_.str(subtype);
+            record_.properties(properties);
+            commit([&] { zone.add_polygon_element(element_id, color, geometry, name, type, subtype, properties); });
+            return element_id;
+        }
+
+        inline UUID add_line_element(const UUID &zone_id, const dp::Segment &geometry, const std::string &name,
+                                     const std::string &type = "", const std::string &subtype = "default",
+                                     const std::unordered_map<std::string, std::string> &properties = {}) {
+            auto &zone = zone_or_throw(zone_id);
+            UUID element_id = generateUUID();
+
+            begin(journal::RecordType::LineElementAdded);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            record_.segment(geometry);
+            record_.str(name);
+            record_.str(type);
+            record_.str(subtype);
+            record_.properties(properties);
+            commit([&] { zone.poly().add_line_element(element_id, name, type, subtype, geometry, properties); });
+            return element_id;
+        }
+
+        inline UUID add_point_element(const UUID &zone_id, const dp::Point &geometry, const std::string &name,
+                                      const std::string &type = "", const std::string &subtype = "default",
+                                      const std::unordered_map<std::string, std::string> &properties = {}) {
+            auto &zone = zone_or_throw(zone_id);
+            UUID element_id = generateUUID();
+
+            begin(journal::RecordType::PointElementAdded);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            record_.point(geometry);
+            record_.str(name);
+            record_.str(type);
+            record_.str(subtype);
+            record_.properties(properties);
+            commit([&] { zone.poly().add_point_element(element_id, name, type, subtype, geometry, properties); });
+            return element_id;
+        }
+
+        inline bool remove_polygon_element(const UUID &zone_id, const UUID &element_id) {
+            auto &zone = zone_or_throw(zone_id);
+            if (!contains(zone.poly().polygon_elements(), element_id))
+                return false;
+            begin(journal::RecordType::PolygonElementRemoved);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            commit([&] { zone.poly().remove_polygon_element(element_id); });
+            return true;
+        }
+
+        inline bool remove_line_element(const UUID &zone_id, const UUID &element_id) {
+            auto &zone = zone_or_throw(zone_id);
+            if (!contains(zone.poly().line_elements(), element_id))
+                return false;
+            begin(journal::RecordType::LineElementRemoved);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            commit([&] { zone.poly().remove_line_element(element_id); });
+            return true;
+        }
+
+        inline bool remove_point_element(const UUID &zone_id, const UUID &element_id) {
+            auto &zone = zone_or_throw(zone_id);
+            if (!contains(zone.poly().point_elements(), element_id))
+                return false;
+            begin(journal::RecordType::PointElementRemoved);
+            record_.uuid(zone_id);
+            record_.uuid(element_id);
+            commit([&] { zone.poly().remove_point_element(element_id); });
+            return true;
+        }
+
+        inline void add_raster_layer(const UUID &zone_id, const dp::Grid<uint8_t> &grid, const std::string &name,
+                                     const std::string &type = "",
+                                     const std::unordered_map<std::string, std::string> &properties = {},
+                                     bool poly_cut = false) {
+            auto &zone = zone_or_throw(zone_id);
+            begin(journal::RecordType::RasterLayerAdded);
+            record_.uuid(zone_id);
+            record_.grid(grid);
+            record_.str(name);
+            record_.str(type);
+            record_.properties(properties);
+            record_.boolean(poly_cut);
+            commit([&] { zone.add_raster_layer(grid, name, type, properties, poly_cut); });
+        }
+
+        /**
+         * @brief Edit the cells of a layer in place through fn(TileEdit<T> &)
+         *
+         * Writes go through the TileEdit, which saves each tile before its first write, so the cost is the tiles
+         * touched rather than a copy and a full diff of the layer. Only the tiles fn actually changed are
+         * journaled, as an XOR/RLE tile delta against their previous contents, so updating a strip of a coverage
+         * layer costs a few hundred bytes instead of the whole layer. If fn throws, or the record cannot be
+         * appended, the layer is restored.
+         */
+        template <typename T, typename F>
+        inline void edit_raster_layer(const UUID &zone_id, size_t layer_index, F &&fn) {
+            auto &zone = zone_or_throw(zone_id);
+            if (layer_index >= zone.layer_count()) {
+                throw std::out_of_range("Layer index out of range: " + std::to_string(layer_index));
+            }
+            auto *grid = zone.layer(layer_index).template gridIf<T>();
+            if (grid == nullptr) {
+                throw std::invalid_argument("Layer " + std::to_string(layer_index) + " has a different cell type");
+            }
+
+            TileEdit<T> edit(*grid);
+            try {
+                std::forward<F>(fn)(edit);
+            } catch (...) {
+                edit.restore();
+                throw;
+            }
+
+            auto changes = edit.changes();
+            if (changes.empty()) {
+                return;
+            }
+            try {
+                begin(journal::RecordType::RasterLayerUpdated);
+                record_.uuid(zone_id);
+                record_.u32(static_cast<uint32_t>(layer_index));
+                record_.str(edit.delta(changes));
+                append();
+            } catch (...) {
+                edit.restore();
+                throw;
+            }
+            if constexpr (std::is_arithmetic_v<T>) {
+                if (auto *stats = zone.grid().mutable_layer_stats(layer_index)) {
+                    edit.account(*stats);
+                    zone.grid().settle_layer_stats(layer_index);
+                }
+            }
+            compact_if_needed();
+        }
+
+        // ========== Persistence ==========
+
+        /// Hand buffered records to the OS (survives a process crash)
+        inline void flush() {
+            if (journal_ != nullptr && std::fflush(journal_) != 0) {
+                throw std::runtime_error("Could not flush journal: " + journal_path().string());
+            }
+        }
+
+        /// Force the journal to stable storage (survives power loss)
+        inline void sync() {
+            if (journal_ != nullptr && !journal::sync_file(journal_)) {
+                throw std::runtime_error("Could not sync journal: " + journal_path().string());
+            }
+        }
+
+        /**
+         * @brief Fold the journal into a fresh snapshot and start an empty journal
+         *
+         * The snapshot is written to `snapshot.tmp` and swapped in by rename. It records the sequence number it
+         * covers, so if we crash before the journal is reset the stale records are skipped on replay. Every file
+         * and directory of the snapshot, and the directory entries changed by each rename, reach stable storage
+         * before the journal is truncated, so a power cut never leaves an empty journal beside a partial snapshot.
+         */
+        inline void compact() {
+            ZONEOUT_METRIC_TIMER("journal.compact");
+            auto staging = directory_ / "snapshot.tmp";
+            auto previous = directory_ / "snapshot.old";
+            std::filesystem::remove_all(staging);
+            plot_.save(staging);
+
+            binary::Writer meta;
+            meta.bytes(journal::snapshot_magic, sizeof(journal::snapshot_magic));
+            meta.u64(sequence_);
+            meta.uuid(plot_.id());
+            meta.str(plot_.name());
+            meta.str(plot_.type());
+            meta.geo(plot_.datum());
+            meta.properties(plot_.properties());
+            meta.u32(static_cast<uint32_t>(plot_.zone_count()));
+
+            binary::Writer frame;
+            frame.u32(static_cast<uint32_t>(meta.size()));
+            frame.u32(crc32c(meta.data()));
+            frame.bytes(meta.data().data(), meta.size());
+            std::FILE *file = std::fopen((staging / "plot.bin").string().c_str(), "wb");
+            if (file == nullptr) {
+                throw std::runtime_error("Could not write snapshot: " + staging.string());
+            }
+            try {
+                journal::write_all(file, frame.data().data(), frame.size(), staging / "plot.bin");
+            } catch (...) {
+                std::fclose(file);
+                throw;
+            }
+            if (std::fclose(file) != 0) {
+                throw std::runtime_error("Could not write snapshot: " + staging.string());
+            }
+            journal::sync_tree(staging);
+
+            std::filesystem::remove_all(previous);
+            if (std::filesystem::exists(snapshot_path())) {
+                std::filesystem::rename(snapshot_path(), previous);
+            }
+            std::filesystem::rename(staging, snapshot_path());
+            journal::sync_path(directory_);
+            std::filesystem::remove_all(previous);
+
+            close_journal();
+            auto fresh = directory_ / "journal.tmp";
+            write_empty_journal(fresh);
+            std::filesystem::rename(fresh, journal_path());
+            journal::sync_path(directory_);
+            journal_bytes_ = journal::journal_header_size;
+            open_journal();
+        }
+    };
+
+} // namespace zoneout
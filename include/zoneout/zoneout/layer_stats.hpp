@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Per-layer summary kept current cell by cell
+     *
+     * Holds a value histogram (dense counters for 8/16-bit integer layers, a hash map otherwise), the sum and the
+     * non-zero count, so queries are O(1). Min/max are cached; when the last cell holding an extreme is
+     * overwritten they are recomputed right away from the histogram, never from the grid, so every const
+     * accessor is read-only and safe to call concurrently. NaN cells are not counted.
+     *
+     * An update that does not match the histogram (a bucket that is missing or would drop below zero, typically
+     * after raw writes to the layer data) marks the stats stale instead of corrupting them; stale stats ignore
+     * further updates until rebuilt. Grid rebuilds them after its own writers.
+     */
+    class LayerStats {
+      private:
+        size_t count_ = 0;
+        size_t nonzero_ = 0;
+        double sum_ = 0.0;
+        bool dense_mode_ = false;
+        std::vector<uint32_t> dense_;
+        std::unordered_map<double, size_t> sparse_;
+
+        double min_ = 0.0;
+        double max_ = 0.0;
+        bool extrema_dirty_ = false;
+        bool stale_ = false;
+
+        inline bool has_dense_bin(double value) const {
+            return value >= 0.0 && value < static_cast<double>(dense_.size()) && value == std::floor(value);
+        }
+
+        inline void add(double value, size_t cells = 1) {
+            if (std::isnan(value))
+                return;
+            if (dense_mode_ && !has_dense_bin(value)) {
+                stale_ = true;
+                return;
+            }
+            const bool first = count_ == 0;
+            count_ += cells;
+            sum_ += value * static_cast<double>(cells);
+            if (value != 0.0)
+                nonzero_ += cells;
+            if (dense_mode_)
+                dense_[static_cast<size_t>(value)] += static_cast<uint32_t>(cells);
+            else
+                sparse_[value] += cells;
+            if (first) {
+                min_ = max_ = value;
+            } else if (!extrema_dirty_) {
+                min_ = std::min(min_, value);
+                max_ = std::max(max_, value);
+            }
+        }
+
+        inline void remove(double value, size_t cells = 1) {
+            if (std::isnan(value))
+                return;
+            // Check the bucket before touching anything, so a mismatch leaves the counters as they were
+            size_t held = 0;
+            auto it = sparse_.end();
+            if (dense_mode_) {
+                if (has_dense_bin(value))
+                    held = dense_[static_cast<size_t>(value)];
+            } else {
+                it = sparse_.find(value);
+                if (it != sparse_.end())
+                    held = it->second;
+            }
+            if (held < cells || count_ < cells || (value != 0.0 && nonzero_ < cells)) {
+                stale_ = true;
+                return;
+            }
+            count_ -= cells;
+            sum_ -= value * static_cast<double>(cells);
+            if (value != 0.0)
+                nonzero_ -= cells;
+            const size_t remaining = held - cells;
+            if (dense_mode_) {
+                dense_[static_cast<size_t>(value)] = static_cast<uint32_t>(remaining);
+            } else if (remaining == 0) {
+                sparse_.erase(it);
+            } else {
+                it->second = remaining;
+            }
+            if (remaining == 0 && (value == min_ || value == max_))
+                extrema_dirty_ = true;
+        }
+
+        inline void recompute_extrema() {
+            extrema_dirty_ = false;
+            min_ = max_ = 0.0;
+            if (count_ == 0)
+                return;
+            if (dense_mode_) {
+                size_t lo = 0;
+                while (lo < dense_.size() && dense_[lo] == 0)
+                    ++lo;
+                if (lo == dense_.size()) {
+                    stale_ = true; // cells counted but no bucket holds them
+                    return;
+                }
+                size_t hi = dense_.size() - 1;
+                while (dense_[hi] == 0)
+                    --hi;
+                min_ = static_cast<double>(lo);
+                max_ = static_cast<double>(hi);
+            } else {
+                if (sparse_.empty()) {
+                    stale_ = true;
+                    return;
+                }
+                min_ = std::numeric_limits<double>::max();
+                max_ = std::numeric_limits<double>::lowest();
+                for (const auto &[value, n] : sparse_) {
+                    min_ = std::min(min_, value);
+                    max_ = std::max(max_, value);
+                }
+            }
+        }
+
+      public:
+        LayerStats() = default;
+
+        template <typename T> inline explicit LayerStats(const dp::Grid<T> &grid) { rebuild(grid); }
+
+        /// Full rescan (after raw writes to the layer data)
+        template <typename T> inline void rebuild(const dp::Grid<T> &grid) {
+            static_assert(std::is_arithmetic_v<T>, "LayerStats requires an arithmetic cell type");
+            count_ = nonzero_ = 0;
+            sum_ = 0.0;
+            extrema_dirty_ = false;
+            stale_ = false;
+            dense_mode_ = false;
+            dense_.clear();
+            sparse_.clear();
+            if constexpr (std::is_unsigned_v<T> && sizeof(T) <= 2) {
+                dense_mode_ = true;
+                dense_.assign(size_t{1} << (8 * sizeof(T)), 0);
+            }
+            for (const auto &value : grid.data)
+                add(static_cast<double>(value));
+        }
+
+        /// Account for `cells` cells (one by default) changing from `old_value` to `new_value`
+        inline void update(double old_value, double new_value, size_t cells = 1) {
+            if (old_value == new_value || cells == 0 || stale_)
+                return;
+            remove(old_value, cells);
+            if (extrema_dirty_ && !stale_)
+                recompute_extrema();
+            if (!stale_)
+                add(new_value, cells);
+        }
+
+        /// True once an update disagreed with the histogram; the values are unreliable until rebuild()
+        inline bool stale() const { return stale_; }
+
+        inline size_t count() const { return count_; }
+        inline size_t nonzero_count() const { return nonzero_; }
+        inline double sum() const { return sum_; }
+        inline double mean() const { return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_); }
+
+        /// Fraction of counted cells that are non-zero (coverage-style layers)
+        inline double nonzero_ratio() const {
+            return count_ == 0 ? 0.0 : static_cast<double>(nonzero_) / static_cast<double>(count_);
+        }
+
+        inline double min() const { return min_; }
+        inline double max() const { return max_; }
+
+        inline size_t count_of(double value) const {
+            if (dense_mode_) {
+                if (!has_dense_bin(value))
+                    return 0;
+                return dense_[static_cast<size_t>(value)];
+            }
+            auto it = sparse_.find(value);
+            return it == sparse_.end() ? 0 : it->second;
+        }
+
+        /// Heap bytes held by the histogram
+        inline size_t memory_bytes() const {
+            return dense_.capacity() * sizeof(uint32_t) + sparse_.bucket_count() * sizeof(void *) +
+                   sparse_.size() * (sizeof(std::pair<const double, size_t>) + sizeof(void *));
+        }
+
+        /// Occupied histogram bins in ascending value order
+        inline std::map<double, size_t> histogram() const {
+            std::map<double, size_t> result;
+            if (dense_mode_) {
+                for (size_t v = 0; v < dense_.size(); ++v) {
+                    if (dense_[v] != 0)
+                        result.emplace(static_cast<double>(v), dense_[v]);
+                }
+            } else {
+                result.insert(sparse_.begin(), sparse_.end());
+            }
+            return result;
+        }
+    };
+
+} // namespace zoneout
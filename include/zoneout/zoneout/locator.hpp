@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "plot.hpp"
+#include "utils/metrics.hpp"
+#include "utils/uuid.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Point-to-zone lookup over all zone boundaries of a plot
+     *
+     * A uniform grid covers the union of the boundaries. Each cell lists, in zone order, the zones that reach it:
+     * cells no boundary edge touches are classified once at build time (by their center), so a point landing in a
+     * cell fully inside a zone is answered without any polygon test. Cells crossed by an edge fall back to the
+     * even-odd test, but only against that zone's edges spanning the point's grid row, not the whole boundary.
+     * Results match Zone::contains (same crossing rule, same arithmetic).
+     *
+     * Positions are in the plot's local frame, as for Plot::zones_containing. The locator copies what it needs;
+     * rebuild it after zones are added, removed or reshaped.
+     */
+    class ZoneLocator {
+      public:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+      private:
+        struct Edge {
+            double ax, ay, bx, by; // a = vertices[i], b = vertices[i - 1], as Polygon::contains walks them
+        };
+
+        struct Entry {
+            uint32_t zone;
+            uint32_t inside; // 1: the whole cell is inside the zone; 0: an edge crosses the cell
+        };
+
+        struct ZoneRows {
+            uint32_t row0 = 0;
+            uint32_t rows = 0;
+            uint32_t band = 0; // first band_offsets_ index of this zone
+        };
+
+        double x0_ = 0.0, y0_ = 0.0, cell_ = 1.0, inv_cell_ = 1.0;
+        size_t cols_ = 0, rows_ = 0;
+
+        std::vector<uint32_t> cell_offsets_; // CSR over cells into entries_
+        std::vector<Entry> entries_;
+        std::vector<ZoneRows> zone_rows_;
+        std::vector<uint32_t> band_offsets_; // CSR over (zone, row) into band_edges_
+        std::vector<Edge> band_edges_;
+        std::vector<UUID> ids_;
+
+        inline long row_of(double y) const { return static_cast<long>(std::floor((y - y0_) * inv_cell_)); }
+        inline long col_of(double x) const { return static_cast<long>(std::floor((x - x0_) * inv_cell_)); }
+
+        inline bool in_band(uint32_t zone, size_t row, const dp::Point &p) const {
+            const auto &zr = zone_rows_[zone];
+            const size_t band = zr.band + (row - zr.row0);
+            bool in = false;
+            for (uint32_t k = band_offsets_[band]; k < band_offsets_[band + 1]; ++k) {
+                const auto &e = band_edges_[k];
+                if ((e.ay > p.y) != (e.by > p.y) && p.x < (e.bx - e.ax) * (p.y - e.ay) / (e.by - e.ay) + e.ax)
+                    in = !in;
+            }
+            return in;
+        }
+
+        inline bool cell_of(const dp::Point &p, size_t &cell, size_t &row) const {
+            const long r = row_of(p.y);
+            const long c = col_of(p.x);
+            if (r < 0 || c < 0 || r >= static_cast<long>(rows_) || c >= static_cast<long>(cols_))
+                return false;
+            row = static_cast<size_t>(r);
+            cell = row * cols_ + static_cast<size_t>(c);
+            return true;
+        }
+
+        inline void build(std::span<const Zone> zones, double cell_size) {
+            constexpr double eps = 1e-9;
+
+            std::vector<const dp::Polygon *> boundaries;
+            dp::AABB bounds{};
+            bool any = false;
+            size_t vertices = 0;
+            for (const auto &zone : zones) {
+                ids_.push_back(zone.id());
+                const dp::Polygon *boundary = nullptr;
+                if (zone.poly().has_field_boundary() && zone.poly().field_boundary().vertices.size() >= 3) {
+                    boundary = &zone.poly().field_boundary();
+                    const auto box = boundary->get_aabb();
+                    if (any) {
+                        bounds.expand(box);
+                    } else {
+                        bounds = box;
+                        any = true;
+                    }
+                    vertices += boundary->vertices.size();
+                }
+                boundaries.push_back(boundary);
+            }
+            if (zones.size() > std::numeric_limits<uint32_t>::max()) {
+                throw std::invalid_argument("ZoneLocator supports at most 2^32 - 1 zones");
+            }
+            zone_rows_.assign(zones.size(), ZoneRows{});
+            band_offsets_.push_back(0);
+            if (!any) {
+                cell_offsets_.assign(1, 0);
+                return;
+            }
+
+            // Default cell size: about four cells per boundary vertex over the covered area, capped at 4M cells
+            const double width = bounds.max_point.x - bounds.min_point.x;
+            const double height = bounds.max_point.y - bounds.min_point.y;
+            const double max_cells = static_cast<double>(1 << 22);
+            if (cell_size <= 0.0) {
+                const double target = std::clamp(4.0 * static_cast<double>(vertices), 1.0, max_cells);
+                cell_size = width * height > 0.0 ? std::sqrt(width * height / target) : std::max({width, height, 1.0});
+            }
+            while ((std::floor(width / cell_size) + 1) * (std::floor(height / cell_size) + 1) > max_cells) {
+                cell_size *= 1.5;
+            }
+            cell_ = cell_size;
+            inv_cell_ = 1.0 / cell_size;
+            x0_ = bounds.min_point.x;
+            y0_ = bounds.min_point.y;
+            cols_ = static_cast<size_t>(std::floor(width * inv_cell_)) + 1;
+            rows_ = static_cast<size_t>(std::floor(height * inv_cell_)) + 1;
+
+            const long last_row = static_cast<long>(rows_) - 1;
+            const long last_col = static_cast<long>(cols_) - 1;
+            auto clamp_row = [&](long r) { return static_cast<size_t>(std::clamp(r, 0L, last_row)); };
+            auto clamp_col = [&](long c) { return static_cast<size_t>(std::clamp(c, 0L, last_col)); };
+
+            struct Placed {
+                size_t cell;
+                Entry entry;
+            };
+            std::vector<Placed> placed;
+            std::vector<std::vector<Edge>> bands;
+            std::vector<uint8_t> touched;
+            std::vector<double> crossings;
+
+            for (uint32_t z = 0; z < boundaries.size(); ++z) {
+                if (boundaries[z] == nullptr)
+                    continue;
+                const auto &v = boundaries[z]->vertices;
+                const auto box = boundaries[z]->get_aabb();
+                const size_t r0 = clamp_row(row_of(box.min_point.y));
+                const size_t r1 = clamp_row(row_of(box.max_point.y));
+                const size_t c0 = clamp_col(col_of(box.min_point.x));
+                const size_t c1 = clamp_col(col_of(box.max_point.x));
+                const size_t nrows = r1 - r0 + 1;
+                const size_t ncols = c1 - c0 + 1;
+
+                bands.assign(nrows, {});
+                touched.assign(nrows * ncols, 0);
+                for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+                    const Edge e{v[i].x, v[i].y, v[j].x, v[j].y};
+                    const double ylo = std::min(e.ay, e.by);
+                    const double yhi = std::max(e.ay, e.by);
+                    const size_t ra = clamp_row(static_cast<long>(std::floor((ylo - y0_) * inv_cell_ - eps)));
+                    const size_t rb = clamp_row(static_cast<long>(std::floor((yhi - y0_) * inv_cell_ + eps)));
+                    for (size_t r = std::max(ra, r0); r <= std::min(rb, r1); ++r) {
+                        bands[r - r0].push_back(e);
+
+                        // Columns the edge covers within this row (conservatively widened)
+                        double xa = e.ax, xb = e.bx;
+                        if (e.ay != e.by) {
+                            const double lo = std::max(ylo, y0_ + static_cast<double>(r) * cell_);
+                            const double hi = std::min(yhi, y0_ + static_cast<double>(r + 1) * cell_);
+                            const double slope = (e.bx - e.ax) / (e.by - e.ay);
+                            xa = e.ax + (lo - e.ay) * slope;
+                            xb = e.ax + (hi - e.ay) * slope;
+                        }
+                        const double xlo = (std::min(xa, xb) - x0_) * inv_cell_;
+                        const double xhi = (std::max(xa, xb) - x0_) * inv_cell_;
+                        const size_t ca = clamp_col(static_cast<long>(std::floor(xlo - eps)));
+                        const size_t cb = clamp_col(static_cast<long>(std::floor(xhi + eps)));
+                        for (size_t c = std::max(ca, c0); c <= std::min(cb, c1); ++c) {
+                            touched[(r - r0) * ncols + (c - c0)] = 1;
+                        }
+                    }
+                }
+
+                zone_rows_[z] = ZoneRows{static_cast<uint32_t>(r0), static_cast<uint32_t>(nrows),
+                                         static_cast<uint32_t>(band_offsets_.size() - 1)};
+                for (size_t r = 0; r < nrows; ++r) {
+                    // Classify untouched cells by their center: one scanline through the row's band edges
+                    const dp::Point center_row{0.0, y0_ + (static_cast<double>(r0 + r) + 0.5) * cell_, 0.0};
+                    crossings.clear();
+                    for (const auto &e : bands[r]) {
+                        if ((e.ay > center_row.y) != (e.by > center_row.y))
+                            crossings.push_back((e.bx - e.ax) * (center_row.y - e.ay) / (e.by - e.ay) + e.ax);
+                    }
+                    std::sort(crossings.begin(), crossings.end());
+
+                    size_t right = 0; // crossings at or left of the current center
+                    for (size_t c = 0; c < ncols; ++c) {
+                        const double xc = x0_ + (static_cast<double>(c0 + c) + 0.5) * cell_;
+                        while (right < crossings.size() && crossings[right] <= xc)
+                            ++right;
+                        const bool edge = touched[r * ncols + c] != 0;
+                        const bool inside = (crossings.size() - right) % 2 == 1;
+                        if (edge || inside) {
+                            placed.push_back(Placed{(r0 + r) * cols_ + c0 + c, Entry{z, edge ? 0u : 1u}});
+                        }
+                    }
+
+                    band_edges_.insert(band_edges_.end(), bands[r].begin(), bands[r].end());
+                    if (band_edges_.size() > std::numeric_limits<uint32_t>::max()) {
+                        throw std::invalid_argument("ZoneLocator: too many boundary edges for the cell size");
+                    }
+                    band_offsets_.push_back(static_cast<uint32_t>(band_edges_.size()));
+                }
+            }
+
+            // Counting sort by cell; stable, so each cell keeps its zones in plot order
+            cell_offsets_.assign(rows_ * cols_ + 1, 0);
+            for (const auto &p : placed) {
+                ++cell_offsets_[p.cell + 1];
+            }
+            for (size_t i = 1; i < cell_offsets_.size(); ++i) {
+                cell_offsets_[i] += cell_offsets_[i - 1];
+            }
+            entries_.resize(placed.size());
+            std::vector<uint32_t> fill(cell_offsets_.begin(), cell_offsets_.end() - 1);
+            for (const auto &p : placed) {
+                entries_[fill[p.cell]++] = p.entry;
+            }
+        }
+
+      public:
+        /// Index `zones` (boundaries only); `cell_size` <= 0 picks one from the vertex count and covered area
+        inline explicit ZoneLocator(std::span<const Zone> zones, double cell_size = 0.0) {
+            ZONEOUT_METRIC_TIMER("locator.build");
+            build(zones, cell_size);
+        }
+
+        inline explicit ZoneLocator(const Plot &plot, double cell_size = 0.0)
+            : ZoneLocator(std::span<const Zone>(plot.zones()), cell_size) {}
+
+        /// Index of the first zone (in plot order) containing `point`, or npos
+        inline size_t locate(const dp::Point &point) const {
+            size_t cell, row;
+            if (!cell_of(point, cell, row))
+                return npos;
+            for (uint32_t k = cell_offsets_[cell]; k < cell_offsets_[cell + 1]; ++k) {
+                const auto &entry = entries_[k];
+                if (entry.inside || in_band(entry.zone, row, point))
+                    return entry.zone;
+            }
+            return npos;
+        }
+
+        /// Batched locate(): out[i] = locate(points[i])
+        inline void locate(std::span<const dp::Point> points, std::span<size_t> out) const {
+            if (out.size() != points.size()) {
+                throw std::invalid_argument("ZoneLocator::locate: output size " + std::to_string(out.size()) +
+                                            " does not match " + std::to_string(points.size()) + " points");
+            }
+            ZONEOUT_METRIC_COUNT("locator.points", points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                out[i] = locate(points[i]);
+            }
+        }
+
+        inline std::vector<size_t> locate(std::span<const dp::Point> points) const {
+            std::vector<size_t> out(points.size());
+            locate(points, out);
+            return out;
+        }
+
+        /// Every zone containing `point`, in plot order (same zones as Plot::zones_containing)
+        inline std::vector<size_t> locate_all(const dp::Point &point) const {
+            std::vector<size_t> result;
+            size_t cell, row;
+            if (!cell_of(point, cell, row))
+                return result;
+            for (uint32_t k = cell_offsets_[cell]; k < cell_offsets_[cell + 1]; ++k) {
+                const auto &entry = entries_[k];
+                if (entry.inside || in_band(entry.zone, row, point))
+                    result.push_back(entry.zone);
+            }
+            return result;
+        }
+
+        /// ID of the zone at `index` (as returned by locate)
+        inline const UUID &id(size_t index) const { return ids_.at(index); }
+
+        inline size_t zone_count() const { return ids_.size(); }
+        inline double cell_size() const { return cell_; }
+        inline size_t rows() const { return rows_; }
+        inline size_t cols() const { return cols_; }
+
+        /// Fraction of (cell, zone) entries answered without a polygon test
+        inline double inside_ratio() const {
+            if (entries_.empty())
+                return 0.0;
+            size_t inside = 0;
+            for (const auto &entry : entries_)
+                inside += entry.inside;
+            return static_cast<double>(inside) / static_cast<double>(entries_.size());
+        }
+    };
+
+} // namespace zoneout
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+#include <rastkit/rastkit.hpp>
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Level-of-detail helpers for display: polyline simplification, culling and raster downsampling
+     *
+     * Tolerances are in metres (ENU); callers pick them from the current view, e.g. the ground size of one pixel.
+     */
+    namespace lod {
+
+        namespace detail {
+
+            inline double segment_distance_sq(const dp::Point &p, const dp::Point &a, const dp::Point &b) {
+                const double dx = b.x - a.x, dy = b.y - a.y;
+                const double len_sq = dx * dx + dy * dy;
+                double t = len_sq > 0.0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len_sq : 0.0;
+                t = std::clamp(t, 0.0, 1.0);
+                const double ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+                return ex * ex + ey * ey;
+            }
+
+        } // namespace detail
+
+        /// Douglas-Peucker simplification; endpoints are always kept, so closed rings stay closed
+        inline std::vector<dp::Point> simplify(const std::vector<dp::Point> &points, double tolerance) {
+            if (tolerance <= 0.0 || points.size() < 3) {
+                return points;
+            }
+            const double tol_sq = tolerance * tolerance;
+            std::vector<char> keep(points.size(), 0);
+            keep.front() = keep.back() = 1;
+
+            std::vector<std::pair<size_t, size_t>> stack{{0, points.size() - 1}};
+            while (!stack.empty()) {
+                auto [first, last] = stack.back();
+                stack.pop_back();
+                double worst = 0.0;
+                size_t index = first;
+                for (size_t i = first + 1; i < last; ++i) {
+                    double d = detail::segment_distance_sq(points[i], points[first], points[last]);
+                    if (d > worst) {
+                        worst = d;
+                        index = i;
+                    }
+                }
+                if (worst > tol_sq) {
+                    keep[index] = 1;
+                    stack.emplace_back(first, index);
+                    stack.emplace_back(index, last);
+                }
+            }
+
+            std::vector<dp::Point> out;
+            out.reserve(static_cast<size_t>(std::count(keep.begin(), keep.end(), 1)));
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (keep[i])
+                    out.push_back(points[i]);
+            }
+            return out;
+        }
+
+        /// False when the geometry's bounding box is smaller than `tolerance` in both directions
+        inline bool visible(const std::vector<dp::Point> &points, double tolerance) {
+            if (points.empty()) {
+                return false;
+            }
+            if (tolerance <= 0.0) {
+                return true;
+            }
+            double min_x = std::numeric_limits<double>::max(), min_y = min_x;
+            double max_x = std::numeric_limits<double>::lowest(), max_y = max_x;
+            for (const auto &p : points) {
+                min_x = std::min(min_x, p.x);
+                max_x = std::max(max_x, p.x);
+                min_y = std::min(min_y, p.y);
+                max_y = std::max(max_y, p.y);
+            }
+            return max_x - min_x >= tolerance || max_y - min_y >= tolerance;
+        }
+
+        /// 8-bit grayscale preview of a raster layer, row-major
+        struct Image8 {
+            size_t width = 0;
+            size_t height = 0;
+            std::vector<uint8_t> pixels;
+        };
+
+        /**
+         * @brief Box-filter `grid` so neither side exceeds `max_side` pixels
+         *
+         * 8-bit layers keep their values; wider types are stretched from their min..max onto 0..255. NaN cells
+         * are skipped; a block with no valid cells becomes 0.
+         */
+        template <typename T> inline Image8 downsample(const dp::Grid<T> &grid, size_t max_side) {
+            static_assert(std::is_arithmetic_v<T>, "downsample needs a numeric grid");
+            if (max_side == 0) {
+                throw std::invalid_argument("downsample: max_side must be positive");
+            }
+            Image8 image;
+            if (grid.rows == 0 || grid.cols == 0) {
+                return image;
+            }
+            const size_t step = std::max<size_t>(1, (std::max(grid.rows, grid.cols) + max_side - 1) / max_side);
+            image.width = (grid.cols + step - 1) / step;
+            image.height = (grid.rows + step - 1) / step;
+            image.pixels.assign(image.width * image.height, 0);
+
+            double lo = 0.0, scale = 1.0;
+            if constexpr (!std::is_same_v<T, uint8_t>) {
+                double min_v = std::numeric_limits<double>::max(), max_v = std::numeric_limits<double>::lowest();
+                for (const auto &cell : grid.data) {
+                    const double v = static_cast<double>(cell);
+                    if (std::isnan(v))
+                        continue;
+                    min_v = std::min(min_v, v);
+                    max_v = std::max(max_v, v);
+                }
+                if (max_v > min_v) {
+                    lo = min_v;
+                    scale = 255.0 / (max_v - min_v);
+                } else if (max_v == min_v) {
+                    lo = min_v;
+                    scale = 0.0;
+                }
+            }
+
+            for (size_t y = 0; y < image.height; ++y) {
+                const size_t r_end = std::min(grid.rows, (y + 1) * step);
+                for (size_t x = 0; x < image.width; ++x) {
+                    const size_t c_end = std::min(grid.cols, (x + 1) * step);
+                    double sum = 0.0;
+                    size_t count = 0;
+                    for (size_t r = y * step; r < r_end; ++r) {
+                        for (size_t c = x * step; c < c_end; ++c) {
+                            const double v = static_cast<double>(grid(r, c));
+                            if (std::isnan(v))
+                                continue;
+                            sum += v;
+                            ++count;
+                        }
+                    }
+                    if (count > 0) {
+                        const double v = (sum / static_cast<double>(count) - lo) * scale;
+                        image.pixels[y * image.width + x] = static_cast<uint8_t>(std::clamp(v + 0.5, 0.0, 255.0));
+                    }
+                }
+            }
+            return image;
+        }
+
+        /// Downsample whichever numeric grid `layer` holds; colour layers are rejected
+        inline Image8 downsample(const rastkit::Layer &layer, size_t max_side) {
+            return std::visit(
+                [&](const auto &g) -> Image8 {
+                    using CellType = typename std::decay_t<decltype(g.data)>::value_type;
+                    if constexpr (std::is_arithmetic_v<CellType>) {
+                        return downsample(g, max_side);
+                    } else {
+                        throw std::invalid_argument("downsample: layer is not numeric");
+                    }
+                },
+                layer.grid);
+        }
+
+    } // namespace lod
+
+} // namespace zoneout
@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+#include <rastkit/rastkit.hpp>
+
+#include "microtar/microtar.hpp"
+#include "utils/binary.hpp"
+#include "utils/checksum.hpp"
+#include "utils/file_io.hpp"
+#include "utils/uuid.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Plot manifest: one small file describing a saved plot directory
+     *
+     * Written by Plot::save next to the zone_N directories. It carries the plot's own metadata (which the zone
+     * files cannot hold) and an index of the zones with their bounding boxes and file sizes/CRC32Cs, so loaders
+     * can restore the plot, or pick out a single zone, without scanning the directory or opening every zone.
+     * verify() / verify_tar() check the files against it by streaming them, without parsing GeoJSON or TIFF;
+     * the per-layer CRC32Cs of the decoded cell data let Plot::load also catch corruption the decoders accept.
+     *
+     * On disk: u32 payload length + u32 CRC32C of the payload, then the payload (magic, version, plot, zones).
+     */
+    namespace manifest {
+
+        inline constexpr char magic[4] = {'Z', 'O', 'M', '1'};
+        // Version 2 added per-layer checksums; version 1 manifests are still read
+        inline constexpr uint32_t format_version = 2;
+        inline constexpr const char *file_name = "manifest.bin";
+
+        /// A file below the plot directory
+        struct FileEntry {
+            std::string path; // relative to the plot directory, '/'-separated
+            uint64_t size = 0;
+            uint32_t crc = 0;
+        };
+
+        struct ZoneEntry {
+            UUID id{null_id};
+            std::string name;
+            std::string type;
+            dp::AABB bbox;
+            FileEntry vector;
+            FileEntry raster;
+            std::vector<uint32_t> layers; // CRC32C of each raster layer's cell data, in layer order
+        };
+
+        struct Manifest {
+            UUID id{null_id};
+            std::string name;
+            std::string type;
+            dp::Geo datum;
+            std::unordered_map<std::string, std::string> properties;
+            std::vector<ZoneEntry> zones;
+
+            inline dp::Optional<std::reference_wrapper<const ZoneEntry>> zone(const UUID &zone_id) const {
+                for (const auto &entry : zones) {
+                    if (entry.id == zone_id)
+                        return std::cref(entry);
+                }
+                return dp::nullopt;
+            }
+
+            inline dp::Optional<std::reference_wrapper<const ZoneEntry>> zone_by_name(const std::string &name) const {
+                for (const auto &entry : zones) {
+                    if (entry.name == name)
+                        return std::cref(entry);
+                }
+                return dp::nullopt;
+            }
+        };
+
+        /// What Plot::load checks against the manifest; a mismatch throws std::runtime_error
+        struct VerifyOptions {
+            bool files = false;  // stream every zone file and compare size + CRC32C before decoding
+            bool layers = false; // compare the CRC32C of each decoded raster layer
+        };
+
+        struct VerifyReport {
+            size_t files = 0;
+            uint64_t bytes = 0;
+            std::vector<std::string> errors;
+
+            inline bool ok() const { return errors.empty(); }
+        };
+
+        inline constexpr size_t stream_chunk = 256 * 1024;
+
+        /// CRC32C of a layer's raw cells (host byte order), independent of how the raster file encodes them
+        inline uint32_t layer_crc(const rastkit::Layer &layer) {
+            return std::visit(
+                [](const auto &grid) {
+                    using Cell = typename std::decay_t<decltype(grid.data)>::value_type;
+                    return crc32c(grid.data.data(), grid.data.size() * sizeof(Cell));
+                },
+                layer.grid);
+        }
+
+        /// Size and CRC32C of `root / relative`, streamed in fixed-size chunks
+        inline FileEntry describe(const std::filesystem::path &root, const std::filesystem::path &relative) {
+            std::ifstream in(root / relative, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("Could not read " + (root / relative).string());
+            }
+            FileEntry entry;
+            entry.path = relative.generic_string();
+            std::vector<char> buffer(stream_chunk);
+            while (in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in.gcount() > 0) {
+                auto n = static_cast<size_t>(in.gcount());
+                entry.crc = crc32c(buffer.data(), n, entry.crc);
+                entry.size += n;
+            }
+            return entry;
+        }
+
+        /// FileEntry for contents already in memory
+        inline FileEntry describe_data(const std::filesystem::path &relative, std::string_view data) {
+            return FileEntry{relative.generic_string(), data.size(), crc32c(data)};
+        }
+
+        namespace detail {
+
+            struct Pending {
+                size_t index;
+                std::string path; // relative to the plot directory
+                uint64_t size;    // as seen by file_size(); the CRC covers whatever is read
+            };
+
+            /**
+             * @brief Describe every pending file, calling done(index, error, entry) for each
+             *
+             * Small files are read whole in batches of at most io.batch_files files and io.batch_bytes bytes;
+             * anything larger than a batch is streamed through describe(), so memory stays bounded either way.
+             */
+            template <typename Done>
+            inline void describe_pending(const std::filesystem::path &directory, const std::vector<Pending> &todo,
+                                         const fileio::Options &io, Done &&done) {
+                const size_t max_files = std::max<size_t>(1, io.batch_files);
+                std::vector<fileio::File> files;
+                std::vector<const Pending *> batch;
+                uint64_t batch_bytes = 0;
+                auto flush = [&] {
+                    files.assign(batch.size(), {});
+                    for (size_t k = 0; k < batch.size(); ++k) {
+                        files[k].path = directory / batch[k]->path;
+                    }
+                    fileio::read(files, io);
+                    for (size_t k = 0; k < batch.size(); ++k) {
+                        const auto &file = files[k];
+                        done(batch[k]->index, file.error, file.ok() ? describe_data(batch[k]->path, file.data)
+                                                                    : FileEntry{});
+                    }
+                    batch.clear();
+                    batch_bytes = 0;
+                };
+
+                for (const auto &file : todo) {
+                    if (file.size > io.batch_bytes) {
+                        try {
+                            done(file.index, 0, describe(directory, file.path));
+                        } catch (const std::runtime_error &) {
+                            done(file.index, fileio::detail::stream_error(directory / file.path), FileEntry{});
+                        }
+                        continue;
+                    }
+                    if (!batch.empty() && (batch.size() == max_files || batch_bytes + file.size > io.batch_bytes)) {
+                        flush();
+                    }
+                    batch.push_back(&file);
+                    batch_bytes += file.size;
+                }
+                if (!batch.empty()) {
+                    flush();
+                }
+            }
+
+        } // namespace detail
+
+        /**
+         * @brief Fill in size and CRC32C of every zone file whose relative path is set, streaming them in batches
+         *
+         * For describing files already on disk; Plot::save fills the entries from the bytes it writes instead.
+         * Only the raster of a zone without layers may be missing (no TIFF is written for it); its entry gets an
+         * empty path. Any other missing or unreadable file throws std::runtime_error.
+         */
+        inline void describe_files(const std::filesystem::path &directory, Manifest &m,
+                                   const fileio::Options &io = {}) {
+            std::vector<FileEntry *> entries;
+            std::vector<bool> optional;
+            std::vector<detail::Pending> todo;
+            auto missing = [&](FileEntry &entry, bool may_be_missing, int error) {
+                if (!may_be_missing) {
+                    throw std::runtime_error("Could not read " + (directory / entry.path).string() + ": " +
+                                             std::strerror(error));
+                }
+                entry = FileEntry{};
+            };
+            for (auto &zone : m.zones) {
+                for (auto *entry : {&zone.vector, &zone.raster}) {
+                    if (entry->path.empty())
+                        continue;
+                    const bool may_be_missing = entry == &zone.raster && zone.layers.empty();
+                    std::error_code ec;
+                    auto size = std::filesystem::file_size(directory / entry->path, ec);
+                    if (ec) {
+                        missing(*entry, may_be_missing, ec.value());
+                        continue;
+                    }
+                    todo.push_back({entries.size(), entry->path, size});
+                    entries.push_back(entry);
+                    optional.push_back(may_be_missing);
+                }
+            }
+            detail::describe_pending(directory, todo, io, [&](size_t i, int error, FileEntry actual) {
+                if (error == ENOENT) {
+                    missing(*entries[i], optional[i], error);
+                } else if (error != 0) {
+                    throw std::runtime_error("Could not read " + (directory / entries[i]->path).string() + ": " +
+                                             std::strerror(error));
+                } else {
+                    *entries[i] = std::move(actual);
+                }
+            });
+        }
+
+        /// Absolute path of a zone file, or an empty path for one that was never written
+        inline std::filesystem::path resolve(const std::filesystem::path &directory, const FileEntry &entry) {
+            return entry.path.empty() ? std::filesystem::path{} : directory / entry.path;
+        }
+
+        namespace detail {
+
+            inline void write_file(binary::Writer &out, const FileEntry &file) {
+                out.str(file.path);
+                out.u64(file.size);
+                out.u32(file.crc);
+            }
+
+            inline FileEntry read_file(binary::Reader &in) {
+                FileEntry file;
+                file.path = in.str();
+                file.size = in.u64();
+                file.crc = in.u32();
+                return file;
+            }
+
+        } // namespace detail
+
+        inline std::string encode(const Manifest &m) {
+            binary::Writer payload;
+            payload.bytes(magic, sizeof(magic));
+            payload.u32(format_version);
+            payload.uuid(m.id);
+            payload.str(m.name);
+            payload.str(m.type);
+            payload.geo(m.datum);
+            payload.properties(m.properties);
+            payload.u32(static_cast<uint32_t>(m.zones.size()));
+            for (const auto &zone : m.zones) {
+                payload.uuid(zone.id);
+                payload.str(zone.name);
+                payload.str(zone.type);
+                payload.point(zone.bbox.min_point);
+                payload.point(zone.bbox.max_point);
+                detail::write_file(payload, zone.vector);
+                detail::write_file(payload, zone.raster);
+                payload.u32(static_cast<uint32_t>(zone.layers.size()));
+                for (uint32_t crc : zone.layers) {
+                    payload.u32(crc);
+                }
+            }
+
+            binary::Writer frame;
+            frame.reserve(payload.size() + 8);
+            frame.u32(static_cast<uint32_t>(payload.size()));
+            frame.u32(crc32c(payload.data()));
+            frame.bytes(payload.data().data(), payload.size());
+            return frame.release();
+        }
+
+        inline Manifest decode(std::string_view content) {
+            binary::Reader frame(content);
+            uint32_t length = frame.u32();
+            uint32_t crc = frame.u32();
+            auto payload = frame.view(length);
+            if (crc32c(payload) != crc) {
+                throw std::runtime_error("Corrupt plot manifest");
+            }
+
+            binary::Reader in(payload);
+            if (in.view(sizeof(magic)) != std::string_view(magic, sizeof(magic))) {
+                throw std::runtime_error("Not a zoneout plot manifest");
+            }
+            uint32_t version = in.u32();
+            if (version < 1 || version > format_version) {
+                throw std::runtime_error("Unsupported plot manifest version " + std::to_string(version));
+            }
+
+            Manifest m;
+            m.id = in.uuid();
+            m.name = in.str();
+            m.type = in.str();
+            m.datum = in.geo();
+            m.properties = in.properties();
+            uint32_t count = in.u32();
+            m.zones.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                ZoneEntry zone;
+                zone.id = in.uuid();
+                zone.name = in.str();
+                zone.type = in.str();
+                zone.bbox.min_point = in.point();
+                zone.bbox.max_point = in.point();
+                zone.vector = detail::read_file(in);
+                zone.raster = detail::read_file(in);
+                if (version >= 2) {
+                    uint32_t layers = in.u32();
+                    if (layers > in.remaining() / sizeof(uint32_t)) {
+                        throw std::runtime_error("Truncated binary record");
+                    }
+                    zone.layers.resize(layers);
+                    for (auto &crc : zone.layers) {
+                        crc = in.u32();
+                    }
+                }
+                m.zones.push_back(std::move(zone));
+            }
+            return m;
+        }
+
+        inline bool exists(const std::filesystem::path &directory) {
+            return std::filesystem::is_regular_file(directory / file_name);
+        }
+
+        /**
+         * @brief Write the manifest to a temporary file, fsync it, rename it into place and fsync the directory
+         *
+         * Without the file fsync the rename can reach the disk before the data does, and without the directory
+         * fsync the rename itself can be lost; either way a power loss could leave a torn or stale manifest.
+         */
+        inline void write(const std::filesystem::path &directory, const Manifest &m) {
+            auto content = encode(m);
+            auto staging = directory / (std::string(file_name) + ".tmp");
+            {
+                std::ofstream out(staging, std::ios::binary | std::ios::trunc);
+                out.write(content.data(), static_cast<std::streamsize>(content.size()));
+                out.close();
+                if (!out) {
+                    throw std::runtime_error("Could not write plot manifest: " + staging.string());
+                }
+            }
+            fileio::sync_path(staging);
+            std::filesystem::rename(staging, directory / file_name);
+            fileio::sync_path(directory);
+        }
+
+        inline Manifest read(const std::filesystem::path &directory) {
+            std::ifstream in(directory / file_name, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("Missing plot manifest in " + directory.string());
+            }
+            std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            return decode(content);
+        }
+
+        /// read(), or nothing when the manifest is missing or cannot be decoded (callers fall back to a scan)
+        inline dp::Optional<Manifest> try_read(const std::filesystem::path &directory) {
+            if (!exists(directory))
+                return dp::nullopt;
+            try {
+                return read(directory);
+            } catch (const std::exception &e) {
+                std::cerr << "Warning: Ignoring unreadable plot manifest in " << directory << ": " << e.what()
+                          << std::endl;
+                return dp::nullopt;
+            }
+        }
+
+        namespace detail {
+
+            inline void check(VerifyReport &report, const FileEntry &expected, const FileEntry &actual) {
+                ++report.files;
+                report.bytes += actual.size;
+                if (actual.size != expected.size) {
+                    report.errors.push_back(expected.path + ": size " + std::to_string(actual.size) + ", expected " +
+                                            std::to_string(expected.size));
+                } else if (actual.crc != expected.crc) {
+                    report.errors.push_back(expected.path + ": checksum mismatch");
+                }
+            }
+
+        } // namespace detail
+
+        /// Stream every file listed in `m` (relative to `directory`) in batches and compare sizes and CRC32Cs
+        inline VerifyReport verify(const std::filesystem::path &directory, const Manifest &m,
+                                   const fileio::Options &io = {}) {
+            std::vector<const FileEntry *> expected;
+            for (const auto &zone : m.zones) {
+                for (const auto *file : {&zone.vector, &zone.raster}) {
+                    if (!file->path.empty())
+                        expected.push_back(file);
+                }
+            }
+
+            // Results are collected per file and reported in manifest order
+            std::vector<FileEntry> actual(expected.size());
+            std::vector<int> errors(expected.size(), 0);
+            std::vector<detail::Pending> todo;
+            for (size_t i = 0; i < expected.size(); ++i) {
+                std::error_code ec;
+                auto size = std::filesystem::file_size(directory / expected[i]->path, ec);
+                if (ec) {
+                    errors[i] = ENOENT;
+                } else if (size != expected[i]->size) {
+                    actual[i] = FileEntry{expected[i]->path, size, 0}; // cheap reject without reading the file
+                } else {
+                    todo.push_back({i, expected[i]->path, size});
+                }
+            }
+            detail::describe_pending(directory, todo, io, [&](size_t i, int error, FileEntry entry) {
+                errors[i] = error;
+                actual[i] = std::move(entry);
+            });
+
+            VerifyReport report;
+            for (size_t i = 0; i < expected.size(); ++i) {
+                if (errors[i] == ENOENT) {
+                    report.errors.push_back(expected[i]->path + ": missing");
+                } else if (errors[i] != 0) {
+                    report.errors.push_back(expected[i]->path + ": " + std::strerror(errors[i]));
+                } else {
+                    detail::check(report, *expected[i], actual[i]);
+                }
+            }
+            return report;
+        }
+
+        /// Verify a saved plot directory against its manifest; a missing or corrupt manifest is reported as an error
+        inline VerifyReport verify(const std::filesystem::path &directory, const fileio::Options &io = {}) {
+            try {
+                return verify(directory, read(directory), io);
+            } catch (const std::exception &e) {
+                VerifyReport report;
+                report.errors.push_back(std::string(file_name) + ": " + e.what());
+                return report;
+            }
+        }
+
+        /// Verify a Plot::save_tar archive in one streaming pass, without extracting it
+        inline VerifyReport verify_tar(const std::filesystem::path &tar_file) {
+            VerifyReport report;
+            mtar_t tar;
+            int err = mtar_open(&tar, tar_file.string().c_str(), "r");
+            if (err != MTAR_ESUCCESS) {
+                report.errors.push_back(tar_file.string() + ": " + mtar_strerror(err));
+                return report;
+            }
+
+            std::string manifest_bytes;
+            std::unordered_map<std::string, FileEntry> seen;
+            std::vector<char> buffer(stream_chunk);
+            mtar_header_t header;
+            while ((err = mtar_read_header(&tar, &header)) == MTAR_ESUCCESS) {
+                const std::string name = header.name;
+                FileEntry actual{name, header.size, 0};
+                for (size_t remaining = header.size; remaining > 0 && err == MTAR_ESUCCESS;) {
+                    size_t n = std::min(buffer.size(), remaining);
+                    err = mtar_read_data(&tar, buffer.data(), static_cast<unsigned>(n));
+                    if (name == file_name) {
+                        manifest_bytes.append(buffer.data(), n);
+                    } else {
+                        actual.crc = crc32c(buffer.data(), n, actual.crc);
+                    }
+                    remaining -= n;
+                }
+                if (err != MTAR_ESUCCESS) {
+                    break;
+                }
+                seen[name] = actual;
+                err = mtar_next(&tar);
+                if (err != MTAR_ESUCCESS) {
+                    break;
+                }
+            }
+            mtar_close(&tar);
+            if (err != MTAR_ENULLRECORD) {
+                report.errors.push_back(tar_file.string() + ": " + mtar_strerror(err));
+            }
+
+            Manifest m;
+            try {
+                m = decode(manifest_bytes);
+            } catch (const std::exception &e) {
+                report.errors.push_back(std::string(file_name) + ": " + e.what());
+                return report;
+            }
+            for (const auto &zone : m.zones) {
+                for (const auto *file : {&zone.vector, &zone.raster}) {
+                    if (file->path.empty())
+                        continue;
+                    auto it = seen.find(file->path);
+                    if (it == seen.end()) {
+                        report.errors.push_back(file->path + ": missing");
+                    } else {
+                        detail::check(report, *file, it->second);
+                    }
+                }
+            }
+            return report;
+        }
+
+    } // namespace manifest
+
+} // namespace zoneout
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <algorithm>
-#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <optional>
+#include <stop_token>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,7 +15,10 @@
 #include <concord/concord.hpp>
 #include <datapod/datapod.hpp>
 
+#include "manifest.hpp"
 #include "microtar/microtar.hpp"
+#include "utils/async.hpp"
+#include "utils/metrics.hpp"
 #include "utils/uuid.hpp"
 #include "zone.hpp"
 
@@ -22,6 +26,12 @@ namespace dp = datapod;
 
 namespace zoneout {
 
+    struct AsyncLoadOptions {
+        size_t threads = 0; // decode workers; 0 uses the executor's full concurrency
+        manifest::VerifyOptions verify;
+        fileio::Options io; // tar extraction and file verification
+    };
+
     class Plot {
       private:
         UUID id_;
@@ -31,6 +41,209 @@ namespace zoneout {
         std::unordered_map<std::string, std::string> properties_;
         dp::Geo datum_;
 
+        /// Unpack a save_tar archive into a fresh temporary directory (removed again on failure)
+        inline static std::filesystem::path extract_tar(const std::filesystem::path &tar_file,
+                                                        const std::stop_token &stop, const fileio::Options &io) {
+            mtar_t tar;
+            int err = mtar_open(&tar, tar_file.string().c_str(), "r");
+            if (err != MTAR_ESUCCESS) {
+                throw std::runtime_error("Could not open tar file: " + std::string(mtar_strerror(err)));
+            }
+
+            // Unique per call: concurrent loads must not share a staging directory
+            auto temp_dir = std::filesystem::temp_directory_path() / ("extract_" + generateUUID().toString());
+            std::filesystem::create_directories(temp_dir);
+            bool open = true;
+            auto cleanup = [&] {
+                if (open)
+                    mtar_close(&tar);
+                open = false;
+                std::filesystem::remove_all(temp_dir);
+            };
+
+            // Entries are buffered and written out in batches of at most io.batch_files files and io.batch_bytes
+            // bytes, creating their directories batch-wise too; entries larger than a batch are streamed to disk
+            const size_t max_files = std::max<size_t>(1, io.batch_files);
+            std::vector<fileio::File> pending;
+            uint64_t pending_bytes = 0;
+            auto flush = [&] {
+                std::vector<std::filesystem::path> dirs;
+                for (const auto &file : pending) {
+                    if (file.path.parent_path() != temp_dir)
+                        dirs.push_back(file.path.parent_path());
+                }
+                std::sort(dirs.begin(), dirs.end());
+                dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+                fileio::create_directories(dirs, io);
+                fileio::write(pending, io);
+                for (const auto &file : pending) {
+                    if (!file.ok())
+                        throw std::runtime_error("Could not extract " + file.message());
+                }
+                pending.clear();
+                pending_bytes = 0;
+            };
+            auto stream = [&](const std::filesystem::path &path, size_t size) {
+                std::filesystem::create_directories(path.parent_path());
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                std::vector<char> buffer(std::min(manifest::stream_chunk, size));
+                for (size_t remaining = size; remaining > 0 && out;) {
+                    const size_t n = std::min(buffer.size(), remaining);
+                    err = mtar_read_data(&tar, buffer.data(), static_cast<unsigned>(n));
+                    if (err != MTAR_ESUCCESS) {
+                        throw std::runtime_error("Could not read file data: " + std::string(mtar_strerror(err)));
+                    }
+                    out.write(buffer.data(), static_cast<std::streamsize>(n));
+                    remaining -= n;
+                }
+                out.close();
+                if (!out) {
+                    throw std::runtime_error("Could not extract " + path.string());
+                }
+            };
+
+            try {
+                mtar_header_t header;
+                while ((err = mtar_read_header(&tar, &header)) == MTAR_ESUCCESS) {
+                    if (stop.stop_requested()) {
+                        throw Cancelled("Plot load");
+                    }
+                    const auto path = temp_dir / header.name;
+                    if (header.size > io.batch_bytes) {
+                        stream(path, header.size);
+                    } else {
+                        if (!pending.empty() &&
+                            (pending.size() == max_files || pending_bytes + header.size > io.batch_bytes)) {
+                            flush();
+                        }
+                        fileio::File file;
+                        file.path = path;
+                        file.data.resize(header.size);
+                        err = mtar_read_data(&tar, file.data.data(), header.size);
+                        if (err != MTAR_ESUCCESS) {
+                            throw std::runtime_error("Could not read file data: " + std::string(mtar_strerror(err)));
+                        }
+                        pending_bytes += header.size;
+                        pending.push_back(std::move(file));
+                    }
+
+                    err = mtar_next(&tar);
+                    if (err != MTAR_ESUCCESS && err != MTAR_ENULLRECORD) {
+                        throw std::runtime_error("Could not advance to next file: " + std::string(mtar_strerror(err)));
+                    }
+                }
+                mtar_close(&tar);
+                open = false;
+                if (!pending.empty()) {
+                    flush();
+                }
+            } catch (...) {
+                cleanup();
+                throw;
+            }
+            return temp_dir;
+        }
+
+        inline static void check_layers(const manifest::ZoneEntry &entry, const Zone &zone) {
+            const auto &layers = zone.raster_data().layers;
+            // Version 1 manifests carry no layer checksums
+            if (!entry.layers.empty() && entry.layers.size() != layers.size()) {
+                throw std::runtime_error("Plot verification failed: zone " + entry.name + " has " +
+                                         std::to_string(layers.size()) + " layers, expected " +
+                                         std::to_string(entry.layers.size()));
+            }
+            for (size_t i = 0; i < entry.layers.size(); ++i) {
+                if (manifest::layer_crc(layers[i]) != entry.layers[i]) {
+                    throw std::runtime_error("Plot verification failed: zone " + entry.name + " layer " +
+                                             std::to_string(i) + " checksum mismatch");
+                }
+            }
+        }
+
+        /// Decode every zone's GeoJSON and TIFF as independent tasks, then assemble the zones in order
+        inline static Plot load_parallel(const std::filesystem::path &directory, const std::string &name,
+                                         const std::string &type, const dp::Geo &datum, const std::stop_token &stop,
+                                         const AsyncLoadOptions &options) {
+            ZONEOUT_METRIC_TIMER("plot.load_async");
+            dp::Optional<manifest::Manifest> m;
+            std::vector<std::pair<std::filesystem::path, std::filesystem::path>> files;
+            if (options.verify.files || options.verify.layers) {
+                if (!manifest::exists(directory)) {
+                    throw std::runtime_error("Cannot verify plot without a manifest: " + directory.string());
+                }
+                m = manifest::read(directory);
+            } else {
+                m = manifest::try_read(directory);
+            }
+            if (m.has_value()) {
+                if (options.verify.files) {
+                    auto report = manifest::verify(directory, *m, options.io);
+                    if (!report.ok()) {
+                        throw std::runtime_error("Plot verification failed: " + report.errors.front());
+                    }
+                }
+                for (const auto &entry : m->zones) {
+                    files.emplace_back(manifest::resolve(directory, entry.vector),
+                                       manifest::resolve(directory, entry.raster));
+                }
+            } else if (std::filesystem::exists(directory)) {
+                for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+                    if (entry.is_directory() && entry.path().filename().string().starts_with("zone_")) {
+                        files.emplace_back(entry.path() / "vector.geojson", entry.path() / "raster.tiff");
+                    }
+                }
+            }
+
+            // Task 2z decodes zone z's vector file, task 2z + 1 its raster file
+            const size_t count = files.size();
+            std::vector<Poly> polys(count, Poly(null_id));
+            std::vector<Grid> grids(count, Grid(null_id));
+            std::vector<uint8_t> present(2 * count, 0);
+            std::vector<std::string> errors(2 * count);
+            async::run(2 * count, options.threads, stop, "Plot load", [&](size_t task) {
+                const size_t z = task / 2;
+                const auto &path = task % 2 == 0 ? files[z].first : files[z].second;
+                if (!std::filesystem::exists(path))
+                    return;
+                try {
+                    if (task % 2 == 0)
+                        polys[z] = Poly::from_file(path);
+                    else
+                        grids[z] = Grid::from_file(path);
+                    present[task] = 1;
+                } catch (const std::exception &e) {
+                    errors[task] = e.what();
+                }
+            });
+
+            Plot plot = m.has_value() ? Plot(m->id, m->name, m->type, m->datum) : Plot(name, type, datum);
+            if (m.has_value())
+                plot.properties_ = m->properties;
+            plot.zones_.reserve(count);
+            dp::Geo plot_datum;
+            for (size_t z = 0; z < count; ++z) {
+                try {
+                    for (const auto &error : {errors[2 * z], errors[2 * z + 1]}) {
+                        if (!error.empty())
+                            throw std::runtime_error(error);
+                    }
+                    checkPolyGrid(polys[z], grids[z], present[2 * z], present[2 * z + 1]);
+                    plot.add_zone(Zone::from_parts(std::move(polys[z]), std::move(grids[z])));
+                } catch (const std::exception &e) {
+                    std::cerr << "Warning: Failed to load zone from " << files[z].first.parent_path() << ": "
+                              << e.what() << std::endl;
+                    continue;
+                }
+                plot_datum = plot.zones_.back().datum();
+                if (m.has_value() && options.verify.layers) {
+                    check_layers(m->zones[z], plot.zones_.back());
+                }
+            }
+            if (!m.has_value())
+                plot.datum_ = plot_datum;
+            return plot;
+        }
+
       public:
         inline Plot(const std::string &name, const std::string &type, const dp::Geo &datum)
             : id_(generateUUID()), name_(name), type_(type), datum_(datum) {}
@@ -50,6 +263,7 @@ namespace zoneout {
         inline void set_datum(const dp::Geo &datum) { datum_ = datum; }
 
         inline void add_zone(const Zone &zone) { zones_.push_back(zone); }
+        inline void add_zone(Zone &&zone) { zones_.push_back(std::move(zone)); }
 
         inline bool remove_zone(const UUID &zone_id) {
             auto it = std::find_if(zones_.begin(), zones_.end(),
@@ -139,7 +353,7 @@ namespace zoneout {
 
         // ============ Spatial Queries ============
 
-        /// Get all zones that contain the given point
+        /// Get all zones that contain the given point (tests every boundary; ZoneLocator serves streams of points)
         inline std::vector<std::reference_wrapper<Zone>> zones_containing(const dp::Point &point) {
             std::vector<std::reference_wrapper<Zone>> result;
             for (auto &z : zones_) {
@@ -211,126 +425,246 @@ namespace zoneout {
 
         inline bool is_valid() const { return !name_.empty() && !type_.empty(); }
 
-        inline void save(const std::filesystem::path &directory) const {
+        /// Estimated heap footprint of all zones plus the plot's own properties (see Zone::memory_usage)
+        inline MemoryUsage memory_usage() const {
+            MemoryUsage usage;
+            usage.object_bytes = sizeof(Plot) + (zones_.capacity() - zones_.size()) * sizeof(Zone);
+            usage.property_bytes += memory::map_heap(properties_) + memory::string_heap(name_) +
+                                    memory::string_heap(type_);
+            for (const auto &zone : zones_) {
+                usage += zone.memory_usage();
+            }
+            return usage;
+        }
+
+        /// Plot metadata and zone index as stored in manifest.bin (file entries are filled in by save())
+        inline manifest::Manifest manifest() const {
+            manifest::Manifest m;
+            m.id = id_;
+            m.name = name_;
+            m.type = type_;
+            m.datum = datum_;
+            m.properties = properties_;
+            m.zones.reserve(zones_.size());
+            for (const auto &zone : zones_) {
+                manifest::ZoneEntry entry;
+                entry.id = zone.id();
+                entry.name = zone.name();
+                entry.type = zone.type();
+                entry.bbox = zone.bounding_box();
+                m.zones.push_back(std::move(entry));
+            }
+            return m;
+        }
+
+        /**
+         * @brief Writes zone_N/{vector.geojson,raster.tiff} per zone, then manifest.bin describing them
+         *
+         * Zones are handled in batches of io.batch_files / 2: each zone is encoded into memory
+         * (Zone::encode_files) on up to `io.threads` executor workers, its manifest entry is filled from those
+         * bytes, and the batch's files are then written with one fileio::write (io_uring on Linux). Nothing is
+         * read back from the plot directory.
+         */
+        inline void save(const std::filesystem::path &directory, const fileio::Options &io = {}) const {
+            ZONEOUT_METRIC_TIMER("plot.save");
             std::filesystem::create_directories(directory);
 
+            std::vector<std::filesystem::path> zone_dirs;
+            zone_dirs.reserve(zones_.size());
             for (size_t i = 0; i < zones_.size(); ++i) {
-                auto zone_dir = directory / ("zone_" + std::to_string(i));
-                std::filesystem::create_directories(zone_dir);
-                auto vector_path = zone_dir / "vector.geojson";
-                auto raster_path = zone_dir / "raster.tiff";
-                zones_[i].to_files(vector_path, raster_path);
+                zone_dirs.push_back(directory / ("zone_" + std::to_string(i)));
             }
+            fileio::create_directories(zone_dirs, io);
+
+            auto m = manifest();
+            const size_t batch_zones = std::max<size_t>(1, io.batch_files / 2);
+            std::vector<fileio::File> files;
+            for (size_t first = 0; first < zones_.size(); first += batch_zones) {
+                const size_t count = std::min(batch_zones, zones_.size() - first);
+                files.assign(2 * count, {});
+                // Each task encodes one zone and fills only that zone's manifest entry and file slots
+                async::run(count, io.threads, {}, "Plot save", [&](size_t k) {
+                    const size_t i = first + k;
+                    auto encoded = zones_[i].encode_files();
+                    auto &entry = m.zones[i];
+                    const std::string prefix = "zone_" + std::to_string(i) + "/";
+                    entry.vector = manifest::describe_data(prefix + "vector.geojson", encoded.vector);
+                    files[2 * k].path = directory / entry.vector.path;
+                    files[2 * k].data = std::move(encoded.vector);
+                    if (zones_[i].layer_count() > 0) {
+                        entry.raster = manifest::describe_data(prefix + "raster.tiff", encoded.raster);
+                        files[2 * k + 1].path = directory / entry.raster.path;
+                        files[2 * k + 1].data = std::move(encoded.raster);
+                    }
+                    for (const auto &layer : zones_[i].raster_data().layers) {
+                        entry.layers.push_back(manifest::layer_crc(layer));
+                    }
+                });
+                // A zone without layers writes no TIFF
+                std::erase_if(files, [](const fileio::File &file) { return file.path.empty(); });
+                fileio::write(files, io);
+                for (const auto &file : files) {
+                    if (!file.ok()) {
+                        throw std::runtime_error("Could not write zone file " + file.message());
+                    }
+                }
+            }
+            manifest::write(directory, m);
         }
 
-        inline void save_tar(const std::filesystem::path &tar_file) const {
+        inline void save_tar(const std::filesystem::path &tar_file, const fileio::Options &io = {}) const {
+            ZONEOUT_METRIC_TIMER("plot.save_tar");
             mtar_t tar;
             int err = mtar_open(&tar, tar_file.string().c_str(), "w");
             if (err != MTAR_ESUCCESS) {
                 throw std::runtime_error("Could not create tar file: " + std::string(mtar_strerror(err)));
             }
 
-            auto temp_dir = std::filesystem::temp_directory_path() / ("plot_" + id_.toString());
-            save(temp_dir);
-
-            for (const auto &entry : std::filesystem::recursive_directory_iterator(temp_dir)) {
-                if (entry.is_regular_file()) {
-                    auto relative_path = std::filesystem::relative(entry.path(), temp_dir);
-                    std::ifstream file(entry.path(), std::ios::binary);
-
-                    if (file.is_open()) {
-                        file.seekg(0, std::ios::end);
-                        size_t file_size = file.tellg();
-                        file.seekg(0, std::ios::beg);
+            // Unique per call: concurrent saves of the same plot must not share a staging directory
+            auto temp_dir = std::filesystem::temp_directory_path() / ("plot_" + generateUUID().toString());
+            bool open = true;
+            auto check = [](int code, const char *what) {
+                if (code != MTAR_ESUCCESS) {
+                    throw std::runtime_error(std::string(what) + ": " + mtar_strerror(code));
+                }
+            };
+
+            try {
+                save(temp_dir, io);
+
+                // Manifest first, so readers streaming the archive learn its layout before any zone data
+                struct Entry {
+                    std::string name;
+                    uint64_t size;
+                };
+                std::vector<Entry> entries{
+                    {manifest::file_name, std::filesystem::file_size(temp_dir / manifest::file_name)}};
+                for (const auto &zone : manifest::read(temp_dir).zones) {
+                    for (const auto *entry : {&zone.vector, &zone.raster}) {
+                        if (!entry->path.empty())
+                            entries.push_back({entry->path, entry->size});
+                    }
+                }
 
-                        err = mtar_write_file_header(&tar, relative_path.string().c_str(), file_size);
-                        if (err != MTAR_ESUCCESS) {
-                            file.close();
-                            mtar_close(&tar);
-                            std::filesystem::remove_all(temp_dir);
-                            throw std::runtime_error("Could not write file header: " + std::string(mtar_strerror(err)));
+                // Small files are read in batches bounded like describe_pending's; larger ones are streamed
+                const size_t max_files = std::max<size_t>(1, io.batch_files);
+                std::vector<const Entry *> batch;
+                uint64_t batch_bytes = 0;
+                std::vector<fileio::File> files;
+                auto flush = [&] {
+                    files.assign(batch.size(), {});
+                    for (size_t k = 0; k < batch.size(); ++k) {
+                        files[k].path = temp_dir / batch[k]->name;
+                    }
+                    fileio::read(files, io);
+                    for (size_t k = 0; k < batch.size(); ++k) {
+                        const auto &file = files[k];
+                        if (!file.ok()) {
+                            throw std::runtime_error("Could not read " + file.message());
                         }
+                        const auto size = static_cast<unsigned>(file.data.size());
+                        check(mtar_write_file_header(&tar, batch[k]->name.c_str(), size),
+                              "Could not write file header");
+                        check(mtar_write_data(&tar, file.data.data(), size), "Could not write file data");
+                    }
+                    batch.clear();
+                    batch_bytes = 0;
+                };
+                auto stream = [&](const Entry &entry) {
+                    const auto path = temp_dir / entry.name;
+                    std::ifstream in(path, std::ios::binary);
+                    if (!in) {
+                        throw std::runtime_error("Could not read " + path.string());
+                    }
+                    check(mtar_write_file_header(&tar, entry.name.c_str(), static_cast<unsigned>(entry.size)),
+                          "Could not write file header");
+                    std::vector<char> buffer(
+                        static_cast<size_t>(std::min<uint64_t>(manifest::stream_chunk, entry.size)));
+                    for (uint64_t remaining = entry.size; remaining > 0;) {
+                        const auto n = static_cast<size_t>(std::min<uint64_t>(buffer.size(), remaining));
+                        if (!in.read(buffer.data(), static_cast<std::streamsize>(n))) {
+                            throw std::runtime_error("Could not read " + path.string());
+                        }
+                        check(mtar_write_data(&tar, buffer.data(), static_cast<unsigned>(n)),
+                              "Could not write file data");
+                        remaining -= n;
+                    }
+                };
 
-                        const size_t chunk_size = 8192;
-                        std::vector<char> buffer(chunk_size);
-                        while (file.read(buffer.data(), chunk_size) || file.gcount() > 0) {
-                            err = mtar_write_data(&tar, buffer.data(), file.gcount());
-                            if (err != MTAR_ESUCCESS) {
-                                file.close();
-                                mtar_close(&tar);
-                                std::filesystem::remove_all(temp_dir);
-                                throw std::runtime_error("Could not write file data: " +
-                                                         std::string(mtar_strerror(err)));
-                            }
+                for (const auto &entry : entries) {
+                    if (entry.size > io.batch_bytes) {
+                        if (!batch.empty()) {
+                            flush();
                         }
-                        file.close();
+                        stream(entry);
+                        continue;
                     }
+                    if (!batch.empty() && (batch.size() == max_files || batch_bytes + entry.size > io.batch_bytes)) {
+                        flush();
+                    }
+                    batch.push_back(&entry);
+                    batch_bytes += entry.size;
+                }
+                if (!batch.empty()) {
+                    flush();
                 }
-            }
 
-            mtar_finalize(&tar);
-            mtar_close(&tar);
+                check(mtar_finalize(&tar), "Could not finalize tar file");
+                open = false;
+                check(mtar_close(&tar), "Could not close tar file");
+            } catch (...) {
+                if (open)
+                    mtar_close(&tar);
+                // A partial archive would only fail later, on load
+                std::error_code ec;
+                std::filesystem::remove(tar_file, ec);
+                std::filesystem::remove_all(temp_dir, ec);
+                throw;
+            }
             std::filesystem::remove_all(temp_dir);
+            ZONEOUT_METRIC_COUNT("plot.tar_bytes_written", metrics::file_bytes(tar_file));
         }
 
         inline void to_files(const std::filesystem::path &directory) const { save(directory); }
 
         inline static Plot load_tar(const std::filesystem::path &tar_file, const std::string &name,
-                                    const std::string &type, const dp::Geo &datum) {
-            mtar_t tar;
-            int err = mtar_open(&tar, tar_file.string().c_str(), "r");
-            if (err != MTAR_ESUCCESS) {
-                throw std::runtime_error("Could not open tar file: " + std::string(mtar_strerror(err)));
+                                    const std::string &type, const dp::Geo &datum,
+                                    const manifest::VerifyOptions &verify = {}, const fileio::Options &io = {}) {
+            ZONEOUT_METRIC_TIMER("plot.load_tar");
+            auto temp_dir = extract_tar(tar_file, {}, io);
+            try {
+                Plot plot = load(temp_dir, name, type, datum, verify);
+                std::filesystem::remove_all(temp_dir);
+                return plot;
+            } catch (...) {
+                std::filesystem::remove_all(temp_dir);
+                throw;
             }
+        }
 
-            auto temp_dir = std::filesystem::temp_directory_path() / ("extract_" + std::to_string(std::time(nullptr)));
-            std::filesystem::create_directories(temp_dir);
-
-            mtar_header_t header;
-            while ((err = mtar_read_header(&tar, &header)) == MTAR_ESUCCESS) {
-                auto file_path = temp_dir / header.name;
-                std::filesystem::create_directories(file_path.parent_path());
-
-                std::ofstream file(file_path, std::ios::binary);
-                if (file.is_open()) {
-                    const size_t chunk_size = 8192;
-                    std::vector<char> buffer(chunk_size);
-                    size_t remaining = header.size;
-
-                    while (remaining > 0) {
-                        size_t to_read = std::min(chunk_size, remaining);
-                        err = mtar_read_data(&tar, buffer.data(), to_read);
-                        if (err != MTAR_ESUCCESS) {
-                            file.close();
-                            mtar_close(&tar);
-                            std::filesystem::remove_all(temp_dir);
-                            throw std::runtime_error("Could not read file data: " + std::string(mtar_strerror(err)));
-                        }
-                        file.write(buffer.data(), to_read);
-                        remaining -= to_read;
-                    }
-                    file.close();
-                }
-
-                err = mtar_next(&tar);
-                if (err != MTAR_ESUCCESS && err != MTAR_ENULLRECORD) {
-                    mtar_close(&tar);
-                    std::filesystem::remove_all(temp_dir);
-                    throw std::runtime_error("Could not advance to next file: " + std::string(mtar_strerror(err)));
+        /**
+         * @brief Load a plot saved with save()
+         *
+         * With a manifest.bin present the plot's id, name, type, datum and properties come from it (overriding the
+         * arguments) and zones are loaded in their saved order. Older directories without a manifest, or with one
+         * that cannot be decoded, fall back to scanning for zone_N subdirectories. `verify` checks files and/or
+         * decoded layers against the manifest and throws std::runtime_error on the first mismatch (or when there is
+         * no readable manifest to check against).
+         */
+        inline static Plot load(const std::filesystem::path &directory, const std::string &name,
+                                const std::string &type, const dp::Geo &datum = dp::Geo{0.001, 0.001, 1.0},
+                                const manifest::VerifyOptions &verify = {}) {
+            ZONEOUT_METRIC_TIMER("plot.load");
+            if (verify.files || verify.layers) {
+                if (!manifest::exists(directory)) {
+                    throw std::runtime_error("Cannot verify plot without a manifest: " + directory.string());
                 }
+                return load(directory, manifest::read(directory), verify);
+            }
+            if (auto m = manifest::try_read(directory)) {
+                return load(directory, *m);
             }
 
-            mtar_close(&tar);
-
-            Plot plot = load(temp_dir, name, type, datum);
-
-            std::filesystem::remove_all(temp_dir);
-
-            return plot;
-        }
-
-        inline static Plot load(const std::filesystem::path &directory, const std::string &name,
-                                const std::string &type, const dp::Geo &datum = dp::Geo{0.001, 0.001, 1.0}) {
             Plot plot(name, type, datum);
             dp::Geo plot_datum;
 
@@ -354,6 +688,99 @@ namespace zoneout {
             return plot;
         }
 
+        inline static Plot load(const std::filesystem::path &directory, const manifest::Manifest &m,
+                                const manifest::VerifyOptions &verify = {}) {
+            if (verify.files) {
+                auto report = manifest::verify(directory, m);
+                if (!report.ok()) {
+                    throw std::runtime_error("Plot verification failed: " + report.errors.front());
+                }
+            }
+
+            Plot plot(m.id, m.name, m.type, m.datum);
+            plot.properties_ = m.properties;
+            plot.zones_.reserve(m.zones.size());
+            for (const auto &entry : m.zones) {
+                try {
+                    plot.add_zone(Zone::from_files(manifest::resolve(directory, entry.vector),
+                                                   manifest::resolve(directory, entry.raster)));
+                } catch (const std::exception &e) {
+                    std::cerr << "Warning: Failed to load zone " << entry.name << " from " << directory << ": "
+                              << e.what() << std::endl;
+                    continue;
+                }
+                if (verify.layers) {
+                    check_layers(entry, plot.zones_.back());
+                }
+            }
+            return plot;
+        }
+
+        /// Check a saved plot directory or save_tar archive against its manifest without loading it
+        inline static manifest::VerifyReport verify(const std::filesystem::path &path) {
+            ZONEOUT_METRIC_TIMER("plot.verify");
+            auto report = std::filesystem::is_directory(path) ? manifest::verify(path) : manifest::verify_tar(path);
+            ZONEOUT_METRIC_COUNT("plot.verify_bytes", report.bytes);
+            return report;
+        }
+
+        /**
+         * @brief Load a plot in the background (same result as load())
+         *
+         * Each zone's GeoJSON and TIFF are decoded as separate tasks on up to `options.threads` workers of the
+         * default executor, so parsing overlaps across zones. Triggering `stop` makes the future throw Cancelled
+         * once the running tasks finish.
+         */
+        inline static std::future<Plot> load_async(const std::filesystem::path &directory, const std::string &name,
+                                                   const std::string &type, const dp::Geo &datum,
+                                                   std::stop_token stop = {}, const AsyncLoadOptions &options = {}) {
+            return async::submit([=] {
+                return load_parallel(directory, name, type, datum, stop, options);
+            });
+        }
+
+        /// load_async() for save_tar archives; extraction also stops between archive entries
+        inline static std::future<Plot> load_tar_async(const std::filesystem::path &tar_file,
+                                                       const std::string &name, const std::string &type,
+                                                       const dp::Geo &datum, std::stop_token stop = {},
+                                                       const AsyncLoadOptions &options = {}) {
+            return async::submit([=] {
+                auto temp_dir = extract_tar(tar_file, stop, options.io);
+                try {
+                    Plot plot = load_parallel(temp_dir, name, type, datum, stop, options);
+                    std::filesystem::remove_all(temp_dir);
+                    return plot;
+                } catch (...) {
+                    std::filesystem::remove_all(temp_dir);
+                    throw;
+                }
+            });
+        }
+
+        /// Load a single zone from a saved plot directory, opening only that zone's files when a manifest exists
+        inline static dp::Optional<Zone> load_zone(const std::filesystem::path &directory, const UUID &zone_id) {
+            ZONEOUT_METRIC_TIMER("plot.load_zone");
+            if (auto m = manifest::try_read(directory)) {
+                auto entry = m->zone(zone_id);
+                if (!entry.has_value())
+                    return dp::nullopt;
+                const auto &zone = entry->get();
+                return Zone::from_files(manifest::resolve(directory, zone.vector),
+                                        manifest::resolve(directory, zone.raster));
+            }
+
+            if (std::filesystem::exists(directory)) {
+                for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+                    if (entry.is_directory() && entry.path().filename().string().starts_with("zone_")) {
+                        auto zone = Zone::load(entry.path());
+                        if (zone.id() == zone_id)
+                            return zone;
+                    }
+                }
+            }
+            return dp::nullopt;
+        }
+
         inline static Plot from_files(const std::filesystem::path &directory, const std::string &name,
                                       const std::string &type, const dp::Geo &datum) {
             return load(directory, name, type, datum);
@@ -378,6 +805,7 @@ namespace zoneout {
 
         // Zone builders for deferred construction
         std::vector<std::function<void(ZoneBuilder &)>> zone_configs_;
+        size_t build_threads_ = 1;
 
       public:
         PlotBuilder() = default;
@@ -436,6 +864,18 @@ namespace zoneout {
             return *this;
         }
 
+        /**
+         * @brief Run the deferred zone configurators and their builds on `threads` executor workers (0 = all of
+         * them, 1 = sequential, the default)
+         *
+         * Zones keep their declaration order. With more than one thread the configurators run concurrently, so they
+         * must not mutate shared state without synchronisation.
+         */
+        inline PlotBuilder &with_build_threads(size_t threads) {
+            build_threads_ = threads;
+            return *this;
+        }
+
         // Validation and building
         inline bool is_valid() const { return validation_error().empty(); }
 
@@ -475,15 +915,16 @@ namespace zoneout {
                 plot.add_zone(zone);
             }
 
-            // Build and add deferred zones from configurators
-            for (const auto &config : zone_configs_) {
+            // Build deferred zones from configurators, possibly in parallel, then add them in declaration order
+            std::vector<std::optional<Zone>> built(zone_configs_.size());
+            async::run(zone_configs_.size(), build_threads_, {}, "Plot build", [&](size_t i) {
                 ZoneBuilder builder;
 
                 // Use the plot's datum as default if zone doesn't specify one
                 builder.with_datum(datum_.value());
 
                 // Apply configuration
-                config(builder);
+                zone_configs_[i](builder);
 
                 // Validate and build zone
                 if (!builder.is_valid()) {
@@ -491,7 +932,10 @@ namespace zoneout {
                                                 builder.validation_error());
                 }
 
-                plot.add_zone(builder.build());
+                built[i].emplace(builder.build());
+            });
+            for (auto &zone : built) {
+                plot.add_zone(std::move(*zone));
             }
 
             return plot;
@@ -505,6 +949,7 @@ namespace zoneout {
             properties_.clear();
             zones_.clear();
             zone_configs_.clear();
+            build_threads_ = 1;
         }
 
         // Utility: Get current zone count (including pending builders)
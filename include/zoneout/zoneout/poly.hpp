@@ -1,9 +1,12 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -11,6 +14,7 @@
 #include <datapod/datapod.hpp>
 #include <vectkit/vectkit.hpp>
 
+#include "utils/memory.hpp"
 #include "utils/meta.hpp"
 #include "utils/uuid.hpp"
 
@@ -18,16 +22,22 @@ namespace dp = datapod;
 
 namespace zoneout {
 
+    /// Element property map; nodes, keys and values are all allocated from the owning Poly's arena (copies fall
+    /// back to the default heap)
+    using ElementProperties = std::pmr::unordered_map<std::pmr::string, std::pmr::string>;
+
     struct StructuredElement {
         UUID uuid;
         std::string name;
         std::string type;
         std::string subtype;
-        std::unordered_map<std::string, std::string> properties;
+        ElementProperties properties;
 
+        template <typename Map = std::unordered_map<std::string, std::string>>
         inline StructuredElement(const UUID &id, const std::string &n, const std::string &t, const std::string &st,
-                                 const std::unordered_map<std::string, std::string> &props = {})
-            : uuid(id), name(n), type(t), subtype(st), properties(props) {}
+                                 const Map &props = {},
+                                 std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : uuid(id), name(n), type(t), subtype(st), properties(props.begin(), props.end(), props.size(), resource) {}
 
         inline static bool isValid(const vectkit::Feature &feature) {
             const auto &props = feature.properties;
@@ -45,7 +55,7 @@ namespace zoneout {
         }
 
         inline std::unordered_map<std::string, std::string> toProperties() const {
-            auto props = properties;
+            std::unordered_map<std::string, std::string> props(properties.begin(), properties.end());
             props["uuid"] = uuid.toString();
             props["name"] = name;
             props["type"] = type;
@@ -60,29 +70,43 @@ namespace zoneout {
     struct PolygonElement : public StructuredElement {
         dp::Polygon geometry;
 
+        template <typename Map = std::unordered_map<std::string, std::string>>
         inline PolygonElement(const UUID &id, const std::string &n, const std::string &t, const std::string &st,
-                              const dp::Polygon &geom, const std::unordered_map<std::string, std::string> &props = {})
-            : StructuredElement(id, n, t, st, props), geometry(geom) {}
+                              const dp::Polygon &geom, const Map &props = {},
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : StructuredElement(id, n, t, st, props, resource), geometry(geom) {}
     };
 
     struct LineElement : public StructuredElement {
         dp::Segment geometry;
 
+        template <typename Map = std::unordered_map<std::string, std::string>>
         inline LineElement(const UUID &id, const std::string &n, const std::string &t, const std::string &st,
-                           const dp::Segment &geom, const std::unordered_map<std::string, std::string> &props = {})
-            : StructuredElement(id, n, t, st, props), geometry(geom) {}
+                           const dp::Segment &geom, const Map &props = {},
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : StructuredElement(id, n, t, st, props, resource), geometry(geom) {}
     };
 
     struct PointElement : public StructuredElement {
         dp::Point geometry;
 
+        template <typename Map = std::unordered_map<std::string, std::string>>
         inline PointElement(const UUID &id, const std::string &n, const std::string &t, const std::string &st,
-                            const dp::Point &geom, const std::unordered_map<std::string, std::string> &props = {})
-            : StructuredElement(id, n, t, st, props), geometry(geom) {}
+                            const dp::Point &geom, const Map &props = {},
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : StructuredElement(id, n, t, st, props, resource), geometry(geom) {}
     };
 
+    // Vector growth must move elements (a copy would reallocate their property maps off the arena)
+    static_assert(std::is_nothrow_move_constructible_v<PolygonElement>);
+    static_assert(std::is_nothrow_move_constructible_v<LineElement>);
+    static_assert(std::is_nothrow_move_constructible_v<PointElement>);
+
     class Poly {
       private:
+        // Element property maps are carved from this arena and released in one shot on reload/compaction.
+        // Declared first so it outlives the element vectors that point into it.
+        std::shared_ptr<std::pmr::monotonic_buffer_resource> arena_;
         vectkit::FeatureCollection collection_;
         dp::Polygon field_boundary_;
         Meta meta_;
@@ -91,6 +115,21 @@ namespace zoneout {
         std::vector<LineElement> line_elements_;
         std::vector<PointElement> point_elements_;
 
+        // Elements removed since the arena was last rebuilt; their property maps still occupy it
+        size_t retired_ = 0;
+        static constexpr size_t compact_min_retired = 256;
+
+        inline size_t element_count() const {
+            return polygon_elements_.size() + line_elements_.size() + point_elements_.size();
+        }
+
+        /// Count `n` removed elements and compact once they outnumber the live ones
+        inline void retire_elements(size_t n) {
+            retired_ += n;
+            if (retired_ >= compact_min_retired && retired_ > element_count())
+                compact_elements();
+        }
+
         inline void sync_to_global_properties() {
             collection_.global_properties["name"] = meta_.name;
             collection_.global_properties["type"] = meta_.type;
@@ -98,41 +137,82 @@ namespace zoneout {
             collection_.global_properties["uuid"] = meta_.id.toString();
         }
 
-        inline void load_structured_elements() {
+        inline std::pmr::memory_resource *resource() {
+            if (!arena_)
+                arena_ = std::make_shared<std::pmr::monotonic_buffer_resource>();
+            return arena_.get();
+        }
+
+        /// Drop every element and hand the arena's blocks back in one go
+        inline void release_elements() {
             polygon_elements_.clear();
             line_elements_.clear();
             point_elements_.clear();
+            retired_ = 0;
+            if (arena_)
+                arena_->release();
+        }
 
-            for (size_t i = 0; i < collection_.features.size(); ++i) {
-                const auto &feature = collection_.features[i];
+        inline void load_structured_elements() {
+            release_elements();
+            auto *res = resource();
 
+            for (const auto &feature : collection_.features) {
                 if (!StructuredElement::isValid(feature)) {
                     continue;
                 }
 
-                auto structured = StructuredElement::fromFeature(feature);
-                if (!structured.has_value())
-                    continue;
-
-                if (std::holds_alternative<dp::Polygon>(feature.geometry)) {
-                    auto polygon = std::get<dp::Polygon>(feature.geometry);
-                    polygon_elements_.emplace_back(structured->uuid, structured->name, structured->type,
-                                                   structured->subtype, polygon, structured->properties);
-                } else if (std::holds_alternative<dp::Segment>(feature.geometry)) {
-                    auto segment = std::get<dp::Segment>(feature.geometry);
-                    line_elements_.emplace_back(structured->uuid, structured->name, structured->type,
-                                                structured->subtype, segment, structured->properties);
-                } else if (std::holds_alternative<dp::Point>(feature.geometry)) {
-                    auto point = std::get<dp::Point>(feature.geometry);
-                    point_elements_.emplace_back(structured->uuid, structured->name, structured->type,
-                                                 structured->subtype, point, structured->properties);
+                const auto &props = feature.properties;
+                const UUID id(props.at("uuid"));
+                if (const auto *polygon = std::get_if<dp::Polygon>(&feature.geometry)) {
+                    polygon_elements_.emplace_back(id, props.at("name"), props.at("type"), props.at("subtype"),
+                                                   *polygon, props, res);
+                } else if (const auto *segment = std::get_if<dp::Segment>(&feature.geometry)) {
+                    line_elements_.emplace_back(id, props.at("name"), props.at("type"), props.at("subtype"), *segment,
+                                                props, res);
+                } else if (const auto *point = std::get_if<dp::Point>(&feature.geometry)) {
+                    point_elements_.emplace_back(id, props.at("name"), props.at("type"), props.at("subtype"), *point,
+                                                 props, res);
                 }
             }
         }
 
+        /// Rebuild `polygons`, `lines` and `points` into a fresh arena owned by this Poly
+        inline void adopt_elements(const std::vector<PolygonElement> &polygons, const std::vector<LineElement> &lines,
+                                   const std::vector<PointElement> &points) {
+            auto fresh = std::make_shared<std::pmr::monotonic_buffer_resource>();
+            std::vector<PolygonElement> new_polygons;
+            std::vector<LineElement> new_lines;
+            std::vector<PointElement> new_points;
+            new_polygons.reserve(polygons.size());
+            new_lines.reserve(lines.size());
+            new_points.reserve(points.size());
+            for (const auto &e : polygons)
+                new_polygons.emplace_back(e.uuid, e.name, e.type, e.subtype, e.geometry, e.properties, fresh.get());
+            for (const auto &e : lines)
+                new_lines.emplace_back(e.uuid, e.name, e.type, e.subtype, e.geometry, e.properties, fresh.get());
+            for (const auto &e : points)
+                new_points.emplace_back(e.uuid, e.name, e.type, e.subtype, e.geometry, e.properties, fresh.get());
+
+            polygon_elements_.clear();
+            line_elements_.clear();
+            point_elements_.clear();
+            arena_ = std::move(fresh);
+            retired_ = 0;
+            polygon_elements_ = std::move(new_polygons);
+            line_elements_ = std::move(new_lines);
+            point_elements_ = std::move(new_points);
+        }
+
       public:
         inline Poly() : collection_(), field_boundary_(), meta_("", "other", "default") { sync_to_global_properties(); }
 
+        /// Empty Poly with a null id (no random draw); used for temporaries that are filled in from a file
+        inline explicit Poly(NullIdTag)
+            : collection_(), field_boundary_(), meta_(UUID(null_id), "", "other", "default") {
+            sync_to_global_properties();
+        }
+
         inline Poly(const std::string &name, const std::string &type, const std::string &subtype = "default")
             : collection_(), field_boundary_(), meta_(name, type, subtype) {
             sync_to_global_properties();
@@ -155,6 +235,42 @@ namespace zoneout {
             load_structured_elements();
         }
 
+        // A copy gets its own arena; the source's arena is never shared
+        inline Poly(const Poly &other)
+            : collection_(other.collection_), field_boundary_(other.field_boundary_), meta_(other.meta_) {
+            adopt_elements(other.polygon_elements_, other.line_elements_, other.point_elements_);
+        }
+
+        inline Poly(Poly &&other) noexcept = default;
+
+        inline Poly &operator=(const Poly &other) {
+            if (this != &other) {
+                collection_ = other.collection_;
+                field_boundary_ = other.field_boundary_;
+                meta_ = other.meta_;
+                adopt_elements(other.polygon_elements_, other.line_elements_, other.point_elements_);
+            }
+            return *this;
+        }
+
+        // Elements go before the arena they were allocated from
+        inline Poly &operator=(Poly &&other) noexcept {
+            if (this != &other) {
+                release_elements();
+                collection_ = std::move(other.collection_);
+                field_boundary_ = std::move(other.field_boundary_);
+                meta_ = std::move(other.meta_);
+                polygon_elements_ = std::move(other.polygon_elements_);
+                line_elements_ = std::move(other.line_elements_);
+                point_elements_ = std::move(other.point_elements_);
+                arena_ = std::move(other.arena_);
+                retired_ = other.retired_;
+            }
+            return *this;
+        }
+
+        inline ~Poly() = default;
+
         // Access to the underlying FeatureCollection
         inline vectkit::FeatureCollection &collection() { return collection_; }
         inline const vectkit::FeatureCollection &collection() const { return collection_; }
@@ -243,7 +359,7 @@ namespace zoneout {
         inline void add_polygon_element(const UUID &id, const std::string &name, const std::string &type,
                                         const std::string &subtype, const dp::Polygon &geometry,
                                         const std::unordered_map<std::string, std::string> &props = {}) {
-            polygon_elements_.emplace_back(id, name, type, subtype, geometry, props);
+            polygon_elements_.emplace_back(id, name, type, subtype, geometry, props, resource());
             vectkit::Feature feature;
             feature.geometry = geometry;
             feature.properties = polygon_elements_.back().toProperties();
@@ -259,7 +375,7 @@ namespace zoneout {
         inline void add_line_element(const UUID &id, const std::string &name, const std::string &type,
                                      const std::string &subtype, const dp::Segment &geometry,
                                      const std::unordered_map<std::string, std::string> &props = {}) {
-            line_elements_.emplace_back(id, name, type, subtype, geometry, props);
+            line_elements_.emplace_back(id, name, type, subtype, geometry, props, resource());
             vectkit::Feature feature;
             feature.geometry = geometry;
             feature.properties = line_elements_.back().toProperties();
@@ -275,7 +391,7 @@ namespace zoneout {
         inline void add_point_element(const UUID &id, const std::string &name, const std::string &type,
                                       const std::string &subtype, const dp::Point &geometry,
                                       const std::unordered_map<std::string, std::string> &props = {}) {
-            point_elements_.emplace_back(id, name, type, subtype, geometry, props);
+            point_elements_.emplace_back(id, name, type, subtype, geometry, props, resource());
             vectkit::Feature feature;
             feature.geometry = geometry;
             feature.properties = point_elements_.back().toProperties();
@@ -329,6 +445,7 @@ namespace zoneout {
         }
 
         // ============ Element Removal ============
+        // Removing may compact the arena (see compact_elements), which invalidates references to every element.
 
         /// Remove a polygon element by UUID. Returns true if found and removed.
         inline bool remove_polygon_element(const UUID &id) {
@@ -339,12 +456,13 @@ namespace zoneout {
                 auto feat_it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&id](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == id.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(id, uuid_it->second);
                     });
                 if (feat_it != collection_.features.end()) {
                     collection_.features.erase(feat_it);
                 }
                 polygon_elements_.erase(it);
+                retire_elements(1);
                 return true;
             }
             return false;
@@ -358,12 +476,13 @@ namespace zoneout {
                 auto feat_it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&id](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == id.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(id, uuid_it->second);
                     });
                 if (feat_it != collection_.features.end()) {
                     collection_.features.erase(feat_it);
                 }
                 line_elements_.erase(it);
+                retire_elements(1);
                 return true;
             }
             return false;
@@ -377,12 +496,13 @@ namespace zoneout {
                 auto feat_it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&id](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == id.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(id, uuid_it->second);
                     });
                 if (feat_it != collection_.features.end()) {
                     collection_.features.erase(feat_it);
                 }
                 point_elements_.erase(it);
+                retire_elements(1);
                 return true;
             }
             return false;
@@ -394,13 +514,15 @@ namespace zoneout {
                 auto it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&elem](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == elem.uuid.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(elem.uuid, uuid_it->second);
                     });
                 if (it != collection_.features.end()) {
                     collection_.features.erase(it);
                 }
             }
+            const size_t removed = polygon_elements_.size();
             polygon_elements_.clear();
+            retire_elements(removed);
         }
 
         /// Clear all line elements
@@ -409,13 +531,15 @@ namespace zoneout {
                 auto it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&elem](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == elem.uuid.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(elem.uuid, uuid_it->second);
                     });
                 if (it != collection_.features.end()) {
                     collection_.features.erase(it);
                 }
             }
+            const size_t removed = line_elements_.size();
             line_elements_.clear();
+            retire_elements(removed);
         }
 
         /// Clear all point elements
@@ -424,13 +548,15 @@ namespace zoneout {
                 auto it =
                     std::find_if(collection_.features.begin(), collection_.features.end(), [&elem](const auto &f) {
                         auto uuid_it = f.properties.find("uuid");
-                        return uuid_it != f.properties.end() && uuid_it->second == elem.uuid.toString();
+                        return uuid_it != f.properties.end() && uuidEquals(elem.uuid, uuid_it->second);
                     });
                 if (it != collection_.features.end()) {
                     collection_.features.erase(it);
                 }
             }
+            const size_t removed = point_elements_.size();
             point_elements_.clear();
+            retire_elements(removed);
         }
 
         /// Clear all elements (polygons, lines, points)
@@ -438,6 +564,18 @@ namespace zoneout {
             clear_polygon_elements();
             clear_line_elements();
             clear_point_elements();
+            release_elements();
+        }
+
+        /// Rebuild the remaining elements into a fresh arena. Removals leave their property maps behind in the
+        /// arena; the remove/clear calls run this on their own once removed elements outnumber live ones (and
+        /// number at least 256), so calling it by hand is only needed to reclaim space sooner.
+        inline void compact_elements() {
+            auto previous = arena_; // keeps the old maps valid until the moved-out vectors below are gone
+            auto polygons = std::move(polygon_elements_);
+            auto lines = std::move(line_elements_);
+            auto points = std::move(point_elements_);
+            adopt_elements(polygons, lines, points);
         }
 
         /// Find polygon element by UUID
@@ -476,6 +614,41 @@ namespace zoneout {
         inline bool has_field_boundary() const { return !field_boundary_.vertices.empty(); }
         inline bool is_valid() const { return has_field_boundary() && !meta_.name.empty(); }
 
+        // Memory Accounting
+        /// Add the boundary, structured elements and feature collection footprint to `usage`
+        inline void memory_usage(MemoryUsage &usage) const {
+            auto element_strings = [](const StructuredElement &e) {
+                return memory::string_heap(e.name) + memory::string_heap(e.type) + memory::string_heap(e.subtype) +
+                       memory::map_heap(e.properties);
+            };
+            usage.element_geometry_bytes += memory::vector_heap(field_boundary_.vertices);
+
+            usage.element_property_bytes +=
+                polygon_elements_.capacity() * (sizeof(PolygonElement) - sizeof(dp::Polygon)) +
+                line_elements_.capacity() * (sizeof(LineElement) - sizeof(dp::Segment)) +
+                point_elements_.capacity() * (sizeof(PointElement) - sizeof(dp::Point));
+            usage.element_geometry_bytes += polygon_elements_.capacity() * sizeof(dp::Polygon) +
+                                            line_elements_.capacity() * sizeof(dp::Segment) +
+                                            point_elements_.capacity() * sizeof(dp::Point);
+            for (const auto &e : polygon_elements_) {
+                usage.element_geometry_bytes += memory::vector_heap(e.geometry.vertices);
+                usage.element_property_bytes += element_strings(e);
+            }
+            for (const auto &e : line_elements_)
+                usage.element_property_bytes += element_strings(e);
+            for (const auto &e : point_elements_)
+                usage.element_property_bytes += element_strings(e);
+
+            usage.feature_collection_bytes += memory::vector_heap(collection_.features);
+            for (const auto &feature : collection_.features) {
+                if (const auto *polygon = std::get_if<dp::Polygon>(&feature.geometry))
+                    usage.feature_collection_bytes += memory::vector_heap(polygon->vertices);
+                usage.feature_collection_bytes += memory::map_heap(feature.properties);
+            }
+            usage.property_bytes += memory::map_heap(collection_.global_properties) + memory::string_heap(meta_.name) +
+                                    memory::string_heap(meta_.type) + memory::string_heap(meta_.subtype);
+        }
+
         // File I/O
         inline static Poly from_file(const std::filesystem::path &file_path) {
             if (!std::filesystem::exists(file_path)) {
@@ -484,11 +657,11 @@ namespace zoneout {
 
             vectkit::FeatureCollection fc = vectkit::read(file_path);
 
-            Poly poly;
-            poly.collection_ = fc;
+            Poly poly(null_id);
+            poly.collection_ = std::move(fc);
 
             // Extract global properties
-            auto global_props = fc.global_properties;
+            const auto &global_props = poly.collection_.global_properties;
 
             auto name_it = global_props.find("name");
             if (name_it != global_props.end()) {
@@ -508,10 +681,12 @@ namespace zoneout {
             auto uuid_it = global_props.find("uuid");
             if (uuid_it != global_props.end()) {
                 poly.meta_.id = UUID(uuid_it->second);
+            } else {
+                poly.meta_.id.generate();
             }
 
             // Find and extract field boundary from features
-            for (const auto &feature : fc.features) {
+            for (const auto &feature : poly.collection_.features) {
                 auto border_it = feature.properties.find("border");
                 if (border_it != feature.properties.end() && border_it->second == "true") {
                     if (std::holds_alternative<dp::Polygon>(feature.geometry)) {
@@ -531,13 +706,14 @@ namespace zoneout {
 
             // Add field boundary as a feature if it exists
             if (has_field_boundary()) {
+                const std::string uuid_str = meta_.id.toString();
                 // Check if boundary feature already exists
                 bool boundary_exists = false;
                 for (auto &feature : const_cast<Poly *>(this)->collection_.features) {
                     auto border_it = feature.properties.find("border");
                     if (border_it != feature.properties.end() && border_it->second == "true") {
                         boundary_exists = true;
-                        feature.properties["uuid"] = meta_.id.toString();
+                        feature.properties["uuid"] = uuid_str;
                         feature.properties["name"] = meta_.name + "_boundary";
                         feature.properties["subtype"] = meta_.subtype;
                         break;
@@ -549,7 +725,7 @@ namespace zoneout {
                     vectkit::Feature boundary_feature;
                     boundary_feature.geometry = field_boundary_;
                     boundary_feature.properties["border"] = "true";
-                    boundary_feature.properties["uuid"] = meta_.id.toString();
+                    boundary_feature.properties["uuid"] = uuid_str;
                     boundary_feature.properties["name"] = meta_.name + "_boundary";
                     boundary_feature.properties["subtype"] = meta_.subtype;
                     const_cast<Poly *>(this)->collection_.features.push_back(boundary_feature);
@@ -6,44 +6,45 @@
 #include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace zoneout {
 
+    /// Consistency checks between the two halves of a zone loaded from separate files
+    inline void checkPolyGrid(const Poly &poly, const Grid &grid, bool has_vector, bool has_raster) {
+        if (has_vector && has_raster && poly.id() != grid.id()) {
+            throw std::runtime_error("UUID mismatch between vector (" + poly.id().toString() + ") and raster (" +
+                                     grid.id().toString() + ") data files");
+        }
+
+        if (!poly.name().empty() && !grid.name().empty()) {
+            if (poly.name() != grid.name()) {
+                throw std::runtime_error("Name mismatch between vector ('" + poly.name() + "') and raster ('" +
+                                         grid.name() + "') data files");
+            }
+        }
+    }
+
     inline std::pair<Poly, Grid> loadPolyGrid(const std::filesystem::path &vector_path,
                                               const std::filesystem::path &raster_path) {
-        Poly poly;
-        Grid grid;
+        // Missing files leave the corresponding half empty with a null id
+        Poly poly(null_id);
+        Grid grid(null_id);
 
-        std::string vector_name, vector_uuid;
-        std::string raster_name, raster_uuid;
+        bool has_vector = false, has_raster = false;
 
         if (std::filesystem::exists(vector_path)) {
             poly = Poly::from_file(vector_path);
-            vector_name = poly.name();
-            vector_uuid = poly.id().toString();
+            has_vector = true;
         }
 
         if (std::filesystem::exists(raster_path)) {
             grid = Grid::from_file(raster_path);
-            raster_name = grid.name();
-            raster_uuid = grid.id().toString();
-        }
-
-        if (!vector_uuid.empty() && !raster_uuid.empty()) {
-            if (vector_uuid != raster_uuid) {
-                throw std::runtime_error("UUID mismatch between vector (" + vector_uuid + ") and raster (" +
-                                         raster_uuid + ") data files");
-            }
-        }
-
-        if (!vector_name.empty() && !raster_name.empty()) {
-            if (vector_name != raster_name) {
-                throw std::runtime_error("Name mismatch between vector ('" + vector_name + "') and raster ('" +
-                                         raster_name + "') data files");
-            }
+            has_raster = true;
         }
 
-        return {poly, grid};
+        checkPolyGrid(poly, grid, has_vector, has_raster);
+        return {std::move(poly), std::move(grid)};
     }
 
     inline void savePolyGrid(const Poly &poly, const Grid &grid, const std::filesystem::path &vector_path,
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "plot.hpp"
+#include "utils/uuid.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Immutable, versioned view of a Plot for concurrent reads that never wait on a writer
+     *
+     * Zones are held through shared_ptr<const Zone>, so consecutive versions share every zone that was not
+     * modified in between. A snapshot never changes after it has been published; any number of threads may query
+     * it concurrently while a writer prepares the next version.
+     */
+    class PlotSnapshot {
+      private:
+        uint64_t version_ = 0;
+        UUID id_;
+        std::string name_;
+        std::string type_;
+        dp::Geo datum_;
+        std::unordered_map<std::string, std::string> properties_;
+
+        std::vector<std::shared_ptr<const Zone>> zones_;
+        std::vector<dp::AABB> bounds_;
+        UUIDMap<size_t> id_index_;
+        std::unordered_map<std::string, size_t> name_index_;
+
+        friend class PlotTransaction;
+
+        inline void build_indexes() {
+            bounds_.clear();
+            id_index_.clear();
+            name_index_.clear();
+            bounds_.reserve(zones_.size());
+            id_index_.reserve(zones_.size());
+            name_index_.reserve(zones_.size());
+            for (size_t i = 0; i < zones_.size(); ++i) {
+                bounds_.push_back(zones_[i]->bounding_box());
+                id_index_.emplace(zones_[i]->id(), i);
+                // First zone wins, matching Plot::zone_by_name
+                name_index_.emplace(zones_[i]->name(), i);
+            }
+        }
+
+      public:
+        /// Take an initial snapshot of a plot (deep copies every zone once)
+        inline explicit PlotSnapshot(const Plot &plot, uint64_t version = 0)
+            : version_(version), id_(plot.id()), name_(plot.name()), type_(plot.type()), datum_(plot.datum()),
+              properties_(plot.properties()) {
+            zones_.reserve(plot.zone_count());
+            for (const auto &zone : plot.zones()) {
+                zones_.push_back(std::make_shared<const Zone>(zone));
+            }
+            build_indexes();
+        }
+
+        inline uint64_t version() const { return version_; }
+
+        inline const UUID &id() const { return id_; }
+        inline const std::string &name() const { return name_; }
+        inline const std::string &type() const { return type_; }
+        inline const dp::Geo &datum() const { return datum_; }
+
+        inline const std::unordered_map<std::string, std::string> &properties() const { return properties_; }
+
+        inline dp::Optional<std::string> property(const std::string &key) const {
+            auto it = properties_.find(key);
+            if (it != properties_.end())
+                return it->second;
+            return dp::nullopt;
+        }
+
+        inline size_t zone_count() const { return zones_.size(); }
+        inline bool empty() const { return zones_.empty(); }
+
+        /// Shared handles to the zones; a handle keeps its zone alive independently of the snapshot
+        inline const std::vector<std::shared_ptr<const Zone>> &zones() const { return zones_; }
+
+        inline dp::Optional<std::reference_wrapper<const Zone>> zone(const UUID &zone_id) const {
+            auto it = id_index_.find(zone_id);
+            if (it != id_index_.end())
+                return std::cref(*zones_[it->second]);
+            return dp::nullopt;
+        }
+
+        inline dp::Optional<std::reference_wrapper<const Zone>> zone_by_name(const std::string &zone_name) const {
+            auto it = name_index_.find(zone_name);
+            if (it != name_index_.end())
+                return std::cref(*zones_[it->second]);
+            return dp::nullopt;
+        }
+
+        inline bool has_zone(const UUID &zone_id) const { return id_index_.find(zone_id) != id_index_.end(); }
+
+        inline bool has_zone(const std::string &zone_name) const {
+            return name_index_.find(zone_name) != name_index_.end();
+        }
+
+        /// Get all zones that contain the given point (bounding boxes are checked before the polygon test)
+        inline std::vector<std::reference_wrapper<const Zone>> zones_containing(const dp::Point &point) const {
+            std::vector<std::reference_wrapper<const Zone>> result;
+            for (size_t i = 0; i < zones_.size(); ++i) {
+                const auto &bbox = bounds_[i];
+                if (point.x < bbox.min_point.x || point.x > bbox.max_point.x || point.y < bbox.min_point.y ||
+                    point.y > bbox.max_point.y) {
+                    continue;
+                }
+                if (zones_[i]->contains(point)) {
+                    result.push_back(std::cref(*zones_[i]));
+                }
+            }
+            return result;
+        }
+
+        inline dp::AABB bounding_box() const {
+            if (bounds_.empty()) {
+                return dp::AABB{};
+            }
+            auto bbox = bounds_[0];
+            for (size_t i = 1; i < bounds_.size(); ++i) {
+                bbox.expand(bounds_[i]);
+            }
+            return bbox;
+        }
+
+        /// Materialize a regular (mutable, deep-copied) Plot from this version
+        inline Plot to_plot() const {
+            Plot plot(id_, name_, type_, datum_);
+            for (const auto &[key, value] : properties_) {
+                plot.set_property(key, value);
+            }
+            for (const auto &zone : zones_) {
+                plot.add_zone(*zone);
+            }
+            return plot;
+        }
+    };
+
+    /**
+     * @brief Draft of the next PlotSnapshot version
+     *
+     * Starts out sharing every zone with the base snapshot; a zone is copied only the first time it is edited
+     * (copy-on-write), so a publish costs O(zones) pointer copies plus one deep copy per touched zone.
+     */
+    class PlotTransaction {
+      private:
+        PlotSnapshot next_;
+        // Zones cloned (or added) by this transaction, parallel to next_.zones_; null while still shared
+        std::vector<std::shared_ptr<Zone>> owned_;
+
+        inline dp::Optional<size_t> index_of(const UUID &zone_id) const {
+            for (size_t i = 0; i < next_.zones_.size(); ++i) {
+                if (next_.zones_[i]->id() == zone_id)
+                    return i;
+            }
+            return dp::nullopt;
+        }
+
+      public:
+        inline explicit PlotTransaction(const PlotSnapshot &base) : next_(base), owned_(base.zones_.size()) {}
+
+        inline const PlotSnapshot &current() const { return next_; }
+
+        inline void set_name(const std::string &name) { next_.name_ = name; }
+        inline void set_type(const std::string &type) { next_.type_ = type; }
+        inline void set_datum(const dp::Geo &datum) { next_.datum_ = datum; }
+
+        inline void set_property(const std::string &key, const std::string &value) { next_.properties_[key] = value; }
+        inline bool remove_property(const std::string &key) { return next_.properties_.erase(key) > 0; }
+
+        inline void add_zone(Zone zone) {
+            auto owned = std::make_shared<Zone>(std::move(zone));
+            next_.zones_.push_back(owned);
+            owned_.push_back(std::move(owned));
+        }
+
+        inline bool remove_zone(const UUID &zone_id) {
+            auto idx = index_of(zone_id);
+            if (!idx.has_value())
+                return false;
+            next_.zones_.erase(next_.zones_.begin() + static_cast<std::ptrdiff_t>(*idx));
+            owned_.erase(owned_.begin() + static_cast<std::ptrdiff_t>(*idx));
+            return true;
+        }
+
+        /// Mutable access to a zone; the first call for a zone clones it away from the published version
+        inline dp::Optional<std::reference_wrapper<Zone>> edit_zone(const UUID &zone_id) {
+            auto idx = index_of(zone_id);
+            if (!idx.has_value())
+                return dp::nullopt;
+            auto &owned = owned_[*idx];
+            if (!owned) {
+                owned = std::make_shared<Zone>(*next_.zones_[*idx]);
+                next_.zones_[*idx] = owned;
+            }
+            return std::ref(*owned);
+        }
+
+        /// Finalize into an immutable snapshot (the transaction must not be used afterwards)
+        inline std::shared_ptr<const PlotSnapshot> commit(uint64_t version) {
+            next_.version_ = version;
+            next_.build_indexes();
+            owned_.clear();
+            return std::make_shared<const PlotSnapshot>(std::move(next_));
+        }
+    };
+
+    /**
+     * @brief Plot shared between reader threads and a writer (RCU style)
+     *
+     * Readers call snapshot() and query the returned version without waiting on a writer; the snapshot stays
+     * valid for as long as they hold it. Writers go through update(), which serializes writers among themselves,
+     * builds the next version copy-on-write and publishes it by swapping one pointer. The published pointer sits
+     * behind its own small lock that is only held to copy or swap the shared_ptr (never while a version is
+     * built), so reads wait on a pointer copy at most, not on a writer. std::atomic<std::shared_ptr> would do
+     * the same but is missing from libc++, and the std::atomic_load overloads for shared_ptr are deprecated.
+     */
+    class SharedPlot {
+      private:
+        std::shared_ptr<const PlotSnapshot> current_;
+        mutable std::mutex current_mutex_;
+        std::mutex writer_mutex_;
+
+        inline void publish(std::shared_ptr<const PlotSnapshot> next) {
+            std::lock_guard<std::mutex> lock(current_mutex_);
+            current_.swap(next);
+            // The previous version is released by `next` after the lock is dropped
+        }
+
+      public:
+        inline explicit SharedPlot(const Plot &plot) : current_(std::make_shared<const PlotSnapshot>(plot)) {}
+
+        SharedPlot(const SharedPlot &) = delete;
+        SharedPlot &operator=(const SharedPlot &) = delete;
+
+        /// Current published version
+        inline std::shared_ptr<const PlotSnapshot> snapshot() const {
+            std::lock_guard<std::mutex> lock(current_mutex_);
+            return current_;
+        }
+
+        inline uint64_t version() const { return snapshot()->version(); }
+
+        /// Apply fn(PlotTransaction &) to a draft of the next version and publish it. Returns the new version.
+        template <typename F> inline uint64_t update(F &&fn) {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            auto base = snapshot();
+            PlotTransaction txn(*base);
+            std::forward<F>(fn)(txn);
+            const uint64_t version = base->version() + 1;
+            publish(txn.commit(version));
+            return version;
+        }
+
+        /// Replace the whole plot (e.g. after Plot::load) as a new version
+        inline uint64_t reset(const Plot &plot) {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            const uint64_t version = snapshot()->version() + 1;
+            publish(std::make_shared<const PlotSnapshot>(plot, version));
+            return version;
+        }
+    };
+
+} // namespace zoneout
@@ -0,0 +1,925 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+#include <rastkit/rastkit.hpp>
+
+#include "plot.hpp"
+#include "tile_delta.hpp"
+#include "utils/binary.hpp"
+#include "utils/checksum.hpp"
+#include "utils/time.hpp"
+#include "utils/uuid.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    namespace sync {
+
+        /// Layers are versioned in square tiles of tile_size x tile_size cells
+        inline constexpr size_t tile_size = tile_delta::tile_size;
+        inline constexpr char delta_magic[4] = {'Z', 'O', 'D', '1'};
+
+        enum class EntryKind : uint8_t { PlotMeta = 1, ZoneMeta = 2, Element = 3, LayerMeta = 4, LayerTile = 5 };
+        enum class ElementKind : uint8_t { Polygon = 1, Line = 2, Point = 3 };
+
+        /// Identifies one versioned piece of a Plot
+        struct Key {
+            EntryKind kind = EntryKind::PlotMeta;
+            UUID zone{null_id};
+            UUID element{null_id};
+            uint32_t layer = 0;
+            uint32_t tile = 0;
+
+            inline static Key plot() { return Key{}; }
+            inline static Key zone_meta(const UUID &zone_id) { return Key{EntryKind::ZoneMeta, zone_id}; }
+            inline static Key element_of(const UUID &zone_id, const UUID &element_id) {
+                return Key{EntryKind::Element, zone_id, element_id};
+            }
+            inline static Key layer_meta(const UUID &zone_id, uint32_t layer) {
+                return Key{EntryKind::LayerMeta, zone_id, UUID(null_id), layer};
+            }
+            inline static Key layer_tile(const UUID &zone_id, uint32_t layer, uint32_t tile) {
+                return Key{EntryKind::LayerTile, zone_id, UUID(null_id), layer, tile};
+            }
+
+            // Zone meta sorts before everything inside the zone, layer meta before its tiles
+            inline bool operator<(const Key &other) const {
+                return std::tie(kind, zone, layer, tile, element) <
+                       std::tie(other.kind, other.zone, other.layer, other.tile, other.element);
+            }
+        };
+
+        struct Stamp {
+            uint64_t time = 0;    ///< Lamport time of the last change
+            uint64_t replica = 0; ///< Replica that made it (tie breaker)
+            uint64_t hash = 0;    ///< Content hash, used to detect local changes
+            bool deleted = false; ///< Tombstone
+        };
+
+        /// Last writer wins: higher Lamport time, ties broken by replica id
+        inline bool newer(const Stamp &a, const Stamp &b) {
+            return a.time != b.time ? a.time > b.time : a.replica > b.replica;
+        }
+
+        inline size_t tiles_across(size_t cells) { return tile_delta::tiles_across(cells); }
+
+        template <typename Variant, size_t I = 0> inline void emplace_by_index(Variant &v, size_t index) {
+            if constexpr (I < std::variant_size_v<Variant>) {
+                if (index == I) {
+                    v.template emplace<I>();
+                    return;
+                }
+                emplace_by_index<Variant, I + 1>(v, index);
+            } else {
+                throw std::runtime_error("Unknown layer cell type index " + std::to_string(index));
+            }
+        }
+
+    } // namespace sync
+
+    /**
+     * @brief Lamport-stamped change tracking and delta sync for a Plot
+     *
+     * Each replica (robot) keeps one SyncTracker next to its Plot. The tracker versions the plot metadata,
+     * every zone, every element and every sync::tile_size square tile of every raster layer with the Lamport
+     * time of its last change. apply_delta() merges a peer's delta last-writer-wins, so replicas converge
+     * whichever order deltas arrive in.
+     *
+     * Separately, every entity records the local sequence() number at which it last changed *on this replica*,
+     * whether by a local edit or by applying a peer's delta. encode_delta() filters on that, not on the origin's
+     * Lamport time: a change relayed from A keeps A's (possibly old) time, yet must still reach C through B.
+     *
+     * Local edits are made on the Plot as usual and picked up by content hash on the next stamp() (called
+     * implicitly by encode_delta/apply_delta). Layer cells are the exception: hashing every tile of every layer on
+     * each stamp would dominate, so only the tiles of new or reshaped layers, the layer 0 tiles under new or changed
+     * polygon elements (which Zone::add_polygon_element paints), and the tiles reported through
+     * edit_raster_layer() or mark_tiles(), are rehashed.
+     */
+    class SyncTracker {
+      private:
+        struct Entry {
+            sync::Stamp stamp;
+            uint64_t seen = 0;
+            uint64_t sequence = 0; // local sequence_ when this replica last changed or received the entry
+        };
+
+        uint64_t replica_;
+        LamportClock clock_;
+        uint64_t sequence_ = 0;
+        std::map<sync::Key, Entry> entries_;
+        // Tiles reported changed since the last stamp(), keyed by their layer's LayerMeta key
+        std::map<sync::Key, TileChanges> dirty_;
+        uint64_t epoch_ = 0;
+        binary::Writer scratch_;
+
+        // ========== Encoding ==========
+
+        inline static void encode_plot_meta(binary::Writer &out, const Plot &plot) {
+            out.str(plot.name());
+            out.str(plot.type());
+            out.geo(plot.datum());
+            out.properties(plot.properties());
+        }
+
+        inline static void encode_zone_meta(binary::Writer &out, const Zone &zone) {
+            out.str(zone.name());
+            out.str(zone.type());
+            out.properties(zone.properties());
+            out.polygon(zone.poly().field_boundary());
+            out.geo(zone.datum());
+            out.pod(zone.grid().shift());
+            out.f64(zone.grid().resolution());
+        }
+
+        template <typename E>
+        inline static void encode_element(binary::Writer &out, sync::ElementKind kind, const E &element) {
+            out.u8(static_cast<uint8_t>(kind));
+            out.str(element.name);
+            out.str(element.type);
+            out.str(element.subtype);
+            out.properties(element.properties);
+            if constexpr (std::is_same_v<E, PolygonElement>) {
+                out.polygon(element.geometry);
+            } else if constexpr (std::is_same_v<E, LineElement>) {
+                out.segment(element.geometry);
+            } else {
+                out.point(element.geometry);
+            }
+        }
+
+        inline static void encode_layer_meta(binary::Writer &out, const rastkit::Layer &layer) {
+            out.u8(static_cast<uint8_t>(layer.grid.index()));
+            std::visit(
+                [&](const auto &g) {
+                    out.u64(g.rows);
+                    out.u64(g.cols);
+                    out.f64(g.resolution);
+                    out.boolean(g.centered);
+                    out.pod(g.pose);
+                },
+                layer.grid);
+            out.u16(layer.samplesPerPixel);
+            out.u16(layer.planarConfig);
+            out.geo(layer.datum);
+            out.pod(layer.shift);
+            out.f64(layer.resolution);
+            out.properties(layer.getGlobalProperties());
+        }
+
+        inline static size_t tile_count(const rastkit::Layer &layer) {
+            auto [rows, cols] = rastkit::get_grid_dimensions(layer.grid);
+            return sync::tiles_across(rows) * sync::tiles_across(cols);
+        }
+
+        inline static void encode_tile(binary::Writer &out, const rastkit::Layer &layer, size_t tile) {
+            std::visit(
+                [&](const auto &g) {
+                    using CellType = typename std::decay_t<decltype(g.data)>::value_type;
+                    auto rect = tile_delta::tile_rect(g.rows, g.cols, tile);
+                    for (size_t r = rect.r0; r < rect.r1; ++r) {
+                        out.bytes(g.data.data() + r * g.cols + rect.c0, (rect.c1 - rect.c0) * sizeof(CellType));
+                    }
+                },
+                layer.grid);
+        }
+
+        /**
+         * @brief Tiles of `layer` holding a cell centre inside any of `boxes`
+         *
+         * Zone::add_polygon_element paints the cells whose centre lies in the element, so these tiles cover
+         * everything it may have written. The cell centres of a tile lie within the hull of its four corner
+         * centres, which keeps the test conservative for rotated grids too.
+         */
+        inline static TileChanges painted_tiles(const rastkit::Layer &layer, const std::vector<dp::AABB> &boxes) {
+            return std::visit(
+                [&](const auto &g) {
+                    TileChanges painted(g.rows, g.cols);
+                    for (size_t t = 0; t < painted.tile_count(); ++t) {
+                        auto rect = tile_delta::tile_rect(g.rows, g.cols, t);
+                        const dp::Point corners[4] = {g.get_point(rect.r0, rect.c0), g.get_point(rect.r0, rect.c1 - 1),
+                                                      g.get_point(rect.r1 - 1, rect.c0),
+                                                      g.get_point(rect.r1 - 1, rect.c1 - 1)};
+                        double x0 = corners[0].x, x1 = corners[0].x, y0 = corners[0].y, y1 = corners[0].y;
+                        for (const auto &p : corners) {
+                            x0 = std::min(x0, p.x);
+                            x1 = std::max(x1, p.x);
+                            y0 = std::min(y0, p.y);
+                            y1 = std::max(y1, p.y);
+                        }
+                        for (const auto &box : boxes) {
+                            if (x1 >= box.min_point.x && x0 <= box.max_point.x && y1 >= box.min_point.y &&
+                                y0 <= box.max_point.y) {
+                                painted.mark_tile(t);
+                                break;
+                            }
+                        }
+                    }
+                    return painted;
+                },
+                layer.grid);
+        }
+
+        /// Position of every element of one zone by UUID, so encoding n element entries costs O(n), not O(n^2)
+        struct ElementIndex {
+            const Zone *zone = nullptr;
+            UUIDMap<std::pair<sync::ElementKind, size_t>> elements;
+
+            inline void build(const Zone &z) {
+                zone = &z;
+                elements.clear();
+                const auto &poly = z.poly();
+                elements.reserve(poly.polygon_elements().size() + poly.line_elements().size() +
+                                 poly.point_elements().size());
+                for (size_t i = 0; i < poly.polygon_elements().size(); ++i)
+                    elements.emplace(poly.polygon_elements()[i].uuid, std::make_pair(sync::ElementKind::Polygon, i));
+                for (size_t i = 0; i < poly.line_elements().size(); ++i)
+                    elements.emplace(poly.line_elements()[i].uuid, std::make_pair(sync::ElementKind::Line, i));
+                for (size_t i = 0; i < poly.point_elements().size(); ++i)
+                    elements.emplace(poly.point_elements()[i].uuid, std::make_pair(sync::ElementKind::Point, i));
+            }
+        };
+
+        /**
+         * @brief Encode the current content of one entity; false if it no longer exists in the plot
+         *
+         * `elements` is rebuilt whenever an element key names a different zone than the last one; keys sort by
+         * zone, so walking entries_ in order builds each zone's index once.
+         */
+        inline static bool encode(binary::Writer &out, const Plot &plot, const sync::Key &key,
+                                  ElementIndex &elements) {
+            if (key.kind == sync::EntryKind::PlotMeta) {
+                encode_plot_meta(out, plot);
+                return true;
+            }
+            auto zone_ref = plot.zone(key.zone);
+            if (!zone_ref.has_value())
+                return false;
+            const Zone &zone = zone_ref->get();
+
+            switch (key.kind) {
+            case sync::EntryKind::ZoneMeta:
+                encode_zone_meta(out, zone);
+                return true;
+            case sync::EntryKind::Element: {
+                if (elements.zone != &zone) {
+                    elements.build(zone);
+                }
+                auto it = elements.elements.find(key.element);
+                if (it == elements.elements.end())
+                    return false;
+                const auto &[kind, i] = it->second;
+                if (kind == sync::ElementKind::Polygon) {
+                    encode_element(out, kind, zone.poly().polygon_elements()[i]);
+                } else if (kind == sync::ElementKind::Line) {
+                    encode_element(out, kind, zone.poly().line_elements()[i]);
+                } else {
+                    encode_element(out, kind, zone.poly().point_elements()[i]);
+                }
+                return true;
+            }
+            case sync::EntryKind::LayerMeta:
+                if (key.layer >= zone.layer_count())
+                    return false;
+                encode_layer_meta(out, zone.layer(key.layer));
+                return true;
+            case sync::EntryKind::LayerTile:
+                if (key.layer >= zone.layer_count() || key.tile >= tile_count(zone.layer(key.layer)))
+                    return false;
+                encode_tile(out, zone.layer(key.layer), key.tile);
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        inline static void write_key(binary::Writer &out, const sync::Key &key) {
+            out.u8(static_cast<uint8_t>(key.kind));
+            if (key.kind == sync::EntryKind::PlotMeta)
+                return;
+            out.uuid(key.zone);
+            if (key.kind == sync::EntryKind::Element) {
+                out.uuid(key.element);
+            } else if (key.kind == sync::EntryKind::LayerMeta || key.kind == sync::EntryKind::LayerTile) {
+                out.u32(key.layer);
+                if (key.kind == sync::EntryKind::LayerTile)
+                    out.u32(key.tile);
+            }
+        }
+
+        inline static sync::Key read_key(binary::Reader &in) {
+            sync::Key key;
+            key.kind = static_cast<sync::EntryKind>(in.u8());
+            if (key.kind < sync::EntryKind::PlotMeta || key.kind > sync::EntryKind::LayerTile) {
+                throw std::runtime_error("Corrupt delta: unknown entry kind");
+            }
+            if (key.kind == sync::EntryKind::PlotMeta)
+                return key;
+            key.zone = in.uuid();
+            if (key.kind == sync::EntryKind::Element) {
+                key.element = in.uuid();
+            } else if (key.kind == sync::EntryKind::LayerMeta || key.kind == sync::EntryKind::LayerTile) {
+                key.layer = in.u32();
+                if (key.kind == sync::EntryKind::LayerTile)
+                    key.tile = in.u32();
+            }
+            return key;
+        }
+
+        // ========== Applying ==========
+
+        inline static Zone *find_zone(Plot &plot, const UUID &zone_id) {
+            auto zone = plot.zone(zone_id);
+            return zone.has_value() ? &zone->get() : nullptr;
+        }
+
+        inline static void apply_zone_meta(Plot &plot, const UUID &zone_id, binary::Reader &in) {
+            auto name = in.str();
+            auto type = in.str();
+            auto properties = in.properties();
+            auto boundary = in.polygon();
+            auto datum = in.geo();
+            auto shift = in.pod<dp::Pose>();
+            double resolution = in.f64();
+
+            Zone *zone = find_zone(plot, zone_id);
+            if (zone == nullptr) {
+                Zone created(null_id);
+                created.id_ = zone_id;
+                created.name_ = name;
+                created.type_ = type;
+                created.poly_data_ = Poly(name, type, "default", boundary);
+                created.grid_data_ = Grid(name, type, "default");
+                plot.add_zone(created);
+                zone = find_zone(plot, zone_id);
+            }
+
+            zone->set_name(name);
+            zone->set_type(type);
+            zone->clear_properties();
+            for (const auto &[key, value] : properties) {
+                zone->set_property(key, value);
+            }
+            zone->poly().set_field_boundary(boundary);
+            zone->set_datum(datum);
+            zone->grid().shift() = shift;
+            zone->grid().resolution() = resolution;
+            zone->sync_to_poly_grid();
+        }
+
+        inline static void apply_element(Zone &zone, const UUID &element_id, binary::Reader &in) {
+            auto kind = static_cast<sync::ElementKind>(in.u8());
+            auto name = in.str();
+            auto type = in.str();
+            auto subtype = in.str();
+            auto properties = in.properties();
+
+            auto &poly = zone.poly();
+            if (!poly.remove_polygon_element(element_id) && !poly.remove_line_element(element_id)) {
+                poly.remove_point_element(element_id);
+            }
+
+            // Raster paint of polygon elements travels separately: the sender's stamp() marks the layer 0 tiles
+            // under a new or changed polygon element, and those tiles follow as LayerTile entries
+            switch (kind) {
+            case sync::ElementKind::Polygon:
+                poly.add_polygon_element(element_id, name, type, subtype, in.polygon(), properties);
+                break;
+            case sync::ElementKind::Line:
+                poly.add_line_element(element_id, name, type, subtype, in.segment(), properties);
+                break;
+            case sync::ElementKind::Point:
+                poly.add_point_element(element_id, name, type, subtype, in.point(), properties);
+                break;
+            default:
+                throw std::runtime_error("Corrupt delta: unknown element kind");
+            }
+        }
+
+        inline static bool apply_layer_meta(Zone &zone, uint32_t index, binary::Reader &in) {
+            auto &layers = zone.grid().raster().layers;
+            if (index > layers.size()) {
+                std::cerr << "Warning: Delta skips layer index " << index << " of zone " << zone.id().toString()
+                          << std::endl;
+                return false;
+            }
+            if (index == layers.size()) {
+                layers.emplace_back();
+            }
+            size_t type_index = in.u8();
+            size_t rows = static_cast<size_t>(in.u64());
+            size_t cols = static_cast<size_t>(in.u64());
+            double grid_resolution = in.f64();
+            bool centered = in.boolean();
+            auto pose = in.pod<dp::Pose>();
+
+            // Everything but the cells comes from the delta, so the layer is rebuilt rather than patched: merging
+            // tags would keep a property the sender removed, and the entry would ping-pong between replicas
+            rastkit::Layer layer;
+            layer.width = static_cast<uint32_t>(cols);
+            layer.height = static_cast<uint32_t>(rows);
+            layer.samplesPerPixel = in.u16();
+            layer.planarConfig = in.u16();
+            layer.datum = in.geo();
+            layer.shift = in.pod<dp::Pose>();
+            layer.resolution = in.f64();
+            for (const auto &[key, value] : in.properties()) {
+                layer.setGlobalProperty(key, value);
+            }
+
+            layer.grid = std::move(layers[index].grid);
+            bool reshaped = layer.grid.index() != type_index;
+            if (reshaped) {
+                sync::emplace_by_index(layer.grid, type_index);
+            }
+            std::visit(
+                [&](auto &g) {
+                    reshaped |= g.rows != rows || g.cols != cols;
+                    g.rows = rows;
+                    g.cols = cols;
+                    g.resolution = grid_resolution;
+                    g.centered = centered;
+                    g.pose = pose;
+                    g.data.resize(rows * cols);
+                },
+                layer.grid);
+            layers[index] = std::move(layer);
+
+            // Resizing or retyping rewrites cells; statistics only survive on a layer that is still numeric
+            if (reshaped && zone.grid().has_layer_stats(index)) {
+                bool numeric = std::visit(
+                    [](const auto &g) {
+                        return std::is_arithmetic_v<typename std::decay_t<decltype(g.data)>::value_type>;
+                    },
+                    layers[index].grid);
+                if (numeric) {
+                    zone.grid().refresh_layer_stats(index);
+                } else {
+                    zone.grid().disable_layer_stats(index);
+                }
+            }
+            return true;
+        }
+
+        inline static bool apply_tile(Zone &zone, uint32_t index, uint32_t tile, std::string_view payload) {
+            if (index >= zone.layer_count()) {
+                return false;
+            }
+            auto &layer = zone.layer(index);
+            if (tile >= tile_count(layer)) {
+                return false;
+            }
+            LayerStats *stats = zone.grid().mutable_layer_stats(index);
+            const bool applied = std::visit(
+                [&](auto &g) {
+                    using CellType = typename std::decay_t<decltype(g.data)>::value_type;
+                    auto rect = tile_delta::tile_rect(g.rows, g.cols, tile);
+                    const size_t width = rect.c1 - rect.c0;
+                    const size_t row_bytes = width * sizeof(CellType);
+                    if (payload.size() != (rect.r1 - rect.r0) * row_bytes) {
+                        return false;
+                    }
+                    for (size_t r = rect.r0; r < rect.r1; ++r) {
+                        CellType *row = g.data.data() + r * g.cols + rect.c0;
+                        const char *src = payload.data() + (r - rect.r0) * row_bytes;
+                        if constexpr (std::is_arithmetic_v<CellType>) {
+                            if (stats != nullptr) {
+                                for (size_t c = 0; c < width; ++c) {
+                                    CellType value;
+                                    std::memcpy(&value, src + c * sizeof(CellType), sizeof(CellType));
+                                    stats->update(static_cast<double>(row[c]), static_cast<double>(value));
+                                    row[c] = value;
+                                }
+                                continue;
+                            }
+                        }
+                        std::memcpy(row, src, row_bytes);
+                    }
+                    return true;
+                },
+                layer.grid);
+            zone.grid().settle_layer_stats(index);
+            return applied;
+        }
+
+        inline static bool apply_entry(Plot &plot, const sync::Key &key, std::string_view payload) {
+            binary::Reader in(payload);
+            if (key.kind == sync::EntryKind::PlotMeta) {
+                plot.set_name(in.str());
+                plot.set_type(in.str());
+                plot.set_datum(in.geo());
+                plot.clear_properties();
+                for (const auto &[k, v] : in.properties()) {
+                    plot.set_property(k, v);
+                }
+                return true;
+            }
+            if (key.kind == sync::EntryKind::ZoneMeta) {
+                apply_zone_meta(plot, key.zone, in);
+                return true;
+            }
+
+            Zone *zone = find_zone(plot, key.zone);
+            if (zone == nullptr) {
+                return false;
+            }
+            switch (key.kind) {
+            case sync::EntryKind::Element:
+                apply_element(*zone, key.element, in);
+                return true;
+            case sync::EntryKind::LayerMeta:
+                return apply_layer_meta(*zone, key.layer, in);
+            case sync::EntryKind::LayerTile:
+                return apply_tile(*zone, key.layer, key.tile, payload);
+            default:
+                return false;
+            }
+        }
+
+        inline static bool apply_removal(Plot &plot, const sync::Key &key) {
+            if (key.kind == sync::EntryKind::ZoneMeta) {
+                return plot.remove_zone(key.zone);
+            }
+            Zone *zone = find_zone(plot, key.zone);
+            if (zone == nullptr) {
+                return false;
+            }
+            if (key.kind == sync::EntryKind::Element) {
+                auto &poly = zone->poly();
+                return poly.remove_polygon_element(key.element) || poly.remove_line_element(key.element) ||
+                       poly.remove_point_element(key.element);
+            }
+            if (key.kind == sync::EntryKind::LayerMeta) {
+                return zone->grid().remove_layer(key.layer);
+            }
+            return false;
+        }
+
+        // ========== Stamping ==========
+
+        inline bool touch(const sync::Key &key, uint64_t now, bool force = false) {
+            auto &entry = entries_[key];
+            entry.seen = epoch_;
+            uint64_t hash = fnv1a64(scratch_.data());
+            if (force || entry.stamp.time == 0 || entry.stamp.deleted || entry.stamp.hash != hash) {
+                entry.stamp = sync::Stamp{now, replica_, hash, false};
+                entry.sequence = ++sequence_;
+                return true;
+            }
+            return false;
+        }
+
+        /// Forget the tile entries of a layer from tile `first` on, after the layer shrank
+        inline void drop_tiles(const UUID &zone_id, uint32_t layer, uint32_t first) {
+            entries_.erase(entries_.lower_bound(sync::Key::layer_tile(zone_id, layer, first)),
+                           entries_.lower_bound(sync::Key::layer_tile(zone_id, layer + 1, 0)));
+        }
+
+      public:
+        inline explicit SyncTracker(const UUID &replica = generateUUID()) {
+            // Tie breaker only needs to be unique among peers; fold the replica UUID to 64 bits
+            std::memcpy(&replica_, replica.bytes().data(), sizeof(replica_));
+        }
+
+        inline uint64_t replica() const { return replica_; }
+
+        /// Current Lamport time of this replica
+        inline uint64_t time() const { return clock_.time(); }
+
+        /// Local change counter; pass it as `since` to the next encode_delta() for the same peer
+        inline uint64_t sequence() const { return sequence_; }
+
+        /// Number of versioned entities (including tombstones)
+        inline size_t tracked() const { return entries_.size(); }
+
+        /// Version stamp of one entity, if tracked
+        inline dp::Optional<sync::Stamp> stamp_of(const sync::Key &key) const {
+            auto it = entries_.find(key);
+            if (it != entries_.end())
+                return it->second.stamp;
+            return dp::nullopt;
+        }
+
+        /**
+         * @brief Report tiles of a layer whose cells were changed directly, for the next stamp() to rehash
+         *
+         * Needed for cell writes that bypass edit_raster_layer(), e.g. pass CoverageAccumulator::changes(). Use
+         * TileChanges::mark_all() when the changed region is unknown.
+         */
+        inline void mark_tiles(const UUID &zone_id, uint32_t layer, const TileChanges &changes) {
+            auto [it, inserted] = dirty_.try_emplace(sync::Key::layer_meta(zone_id, layer), changes);
+            if (inserted) {
+                return;
+            }
+            if (it->second.tile_count() != changes.tile_count()) {
+                it->second = TileChanges(changes.rows(), changes.cols());
+                it->second.mark_all();
+                return;
+            }
+            auto &words = it->second.words();
+            for (size_t w = 0; w < words.size(); ++w) {
+                words[w] |= changes.words()[w];
+            }
+        }
+
+        /**
+         * @brief Edit the cells of a layer in place through fn(TileEdit<T> &) and mark the tiles it touched
+         *
+         * If fn throws, the layer is restored and nothing is marked.
+         */
+        template <typename T, typename F>
+        inline void edit_raster_layer(Plot &plot, const UUID &zone_id, size_t layer_index, F &&fn) {
+            auto zone = plot.zone(zone_id);
+            if (!zone.has_value()) {
+                throw std::runtime_error("Zone not found: " + zone_id.toString());
+            }
+            if (layer_index >= zone->get().layer_count()) {
+                throw std::out_of_range("Layer index out of range: " + std::to_string(layer_index));
+            }
+            auto *grid = zone->get().layer(layer_index).template gridIf<T>();
+            if (grid == nullptr) {
+                throw std::invalid_argument("Layer " + std::to_string(layer_index) + " has a different cell type");
+            }
+
+            TileEdit<T> edit(*grid);
+            try {
+                std::forward<F>(fn)(edit);
+            } catch (...) {
+                edit.restore();
+                throw;
+            }
+            if constexpr (std::is_arithmetic_v<T>) {
+                if (auto *stats = zone->get().grid().mutable_layer_stats(layer_index)) {
+                    edit.account(*stats);
+                    zone->get().grid().settle_layer_stats(layer_index);
+                }
+            }
+            if (!edit.touched().empty()) {
+                mark_tiles(zone_id, static_cast<uint32_t>(layer_index), edit.touched());
+            }
+        }
+
+        /**
+         * @brief Detect local changes and stamp them with the next Lamport time
+         *
+         * Hashes the plot piece by piece; only entities whose content changed (or that appeared/disappeared)
+         * since the previous call get a new stamp. Layer tiles are only hashed when reported dirty or when their
+         * layer is new or reshaped. Returns the current Lamport time.
+         */
+        inline uint64_t stamp(const Plot &plot) {
+            ++epoch_;
+            const uint64_t now = clock_.time() + 1;
+            bool changed = false;
+
+            scratch_.clear();
+            encode_plot_meta(scratch_, plot);
+            changed |= touch(sync::Key::plot(), now);
+
+            for (const auto &zone : plot.zones()) {
+                scratch_.clear();
+                encode_zone_meta(scratch_, zone);
+                changed |= touch(sync::Key::zone_meta(zone.id()), now);
+
+                // New or changed polygon elements were painted into layer 0 by add_polygon_element
+                std::vector<dp::AABB> painted;
+                for (const auto &e : zone.poly().polygon_elements()) {
+                    scratch_.clear();
+                    encode_element(scratch_, sync::ElementKind::Polygon, e);
+                    if (touch(sync::Key::element_of(zone.id(), e.uuid), now)) {
+                        changed = true;
+                        painted.push_back(e.geometry.get_aabb());
+                    }
+                }
+                if (!painted.empty() && zone.layer_count() > 0) {
+                    mark_tiles(zone.id(), 0, painted_tiles(zone.layer(0), painted));
+                }
+                for (const auto &e : zone.poly().line_elements()) {
+                    scratch_.clear();
+                    encode_element(scratch_, sync::ElementKind::Line, e);
+                    changed |= touch(sync::Key::element_of(zone.id(), e.uuid), now);
+                }
+                for (const auto &e : zone.poly().point_elements()) {
+                    scratch_.clear();
+                    encode_element(scratch_, sync::ElementKind::Point, e);
+                    changed |= touch(sync::Key::element_of(zone.id(), e.uuid), now);
+                }
+
+                for (uint32_t l = 0; l < zone.layer_count(); ++l) {
+                    const auto &layer = zone.layer(l);
+                    scratch_.clear();
+                    encode_layer_meta(scratch_, layer);
+                    // A reshaped or retyped layer resends all its tiles, even ones whose bytes happen to match
+                    bool layer_changed = touch(sync::Key::layer_meta(zone.id(), l), now);
+                    changed |= layer_changed;
+
+                    const uint32_t tiles = static_cast<uint32_t>(tile_count(layer));
+                    auto stamp_tile = [&](uint32_t t) {
+                        scratch_.clear();
+                        encode_tile(scratch_, layer, t);
+                        changed |= touch(sync::Key::layer_tile(zone.id(), l, t), now, layer_changed);
+                    };
+                    auto dirty = dirty_.find(sync::Key::layer_meta(zone.id(), l));
+                    if (layer_changed || (dirty != dirty_.end() && dirty->second.tile_count() != tiles)) {
+                        for (uint32_t t = 0; t < tiles; ++t) {
+                            stamp_tile(t);
+                        }
+                        drop_tiles(zone.id(), l, tiles);
+                    } else if (dirty != dirty_.end()) {
+                        const auto &words = dirty->second.words();
+                        for (size_t w = 0; w < words.size(); ++w) {
+                            for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+                                stamp_tile(static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+                            }
+                        }
+                    }
+                }
+            }
+            dirty_.clear();
+
+            // Whatever was not visited is gone. Tiles die with their layer, everything else leaves a tombstone.
+            for (auto it = entries_.begin(); it != entries_.end();) {
+                if (it->first.kind == sync::EntryKind::LayerTile) {
+                    // Unreported tiles are not visited, so a layer's tiles are kept or dropped as one range
+                    const sync::Key key = it->first;
+                    auto next = entries_.lower_bound(sync::Key::layer_tile(key.zone, key.layer + 1, 0));
+                    auto layer = entries_.find(sync::Key::layer_meta(key.zone, key.layer));
+                    it = layer != entries_.end() && layer->second.seen == epoch_ ? next : entries_.erase(it, next);
+                    continue;
+                }
+                if (it->second.seen == epoch_) {
+                    ++it;
+                    continue;
+                }
+                if (!it->second.stamp.deleted) {
+                    it->second.stamp = sync::Stamp{now, replica_, 0, true};
+                    it->second.sequence = ++sequence_;
+                    changed = true;
+                }
+                ++it;
+            }
+
+            if (changed) {
+                clock_.tick();
+            }
+            return clock_.time();
+        }
+
+        /**
+         * @brief Binary delta of everything this replica changed or received after local sequence `since`
+         *
+         * Pass 0 for a full state transfer, or the sequence() read right after the previous delta to the same peer
+         * was encoded. Entries relayed from other replicas are included whatever their Lamport time. The plot is
+         * stamped first, so pending local edits are always included.
+         */
+        inline std::string encode_delta(const Plot &plot, uint64_t since) {
+            stamp(plot);
+
+            uint32_t count = 0;
+            for (const auto &[key, entry] : entries_) {
+                if (entry.sequence > since)
+                    ++count;
+            }
+
+            binary::Writer out;
+            out.bytes(sync::delta_magic, sizeof(sync::delta_magic));
+            out.u64(replica_);
+            out.u64(clock_.time());
+            out.u32(count);
+
+            binary::Writer payload;
+            ElementIndex elements;
+            for (const auto &[key, entry] : entries_) {
+                if (entry.sequence <= since)
+                    continue;
+                write_key(out, key);
+                out.u64(entry.stamp.time);
+                out.u64(entry.stamp.replica);
+                out.boolean(entry.stamp.deleted);
+                if (!entry.stamp.deleted) {
+                    payload.clear();
+                    encode(payload, plot, key, elements);
+                    if (key.kind == sync::EntryKind::LayerTile) {
+                        out.str(tile_delta::compress(payload.data()));
+                    } else {
+                        out.str(payload.data());
+                    }
+                }
+            }
+            out.u32(crc32c(out.data()));
+            return out.release();
+        }
+
+        /**
+         * @brief Merge a peer's delta into `plot`, last writer wins per entity
+         *
+         * Entries older than the local version are ignored; entries for zones this replica does not have (yet)
+         * are skipped and will be re-sent with the next full delta. Returns the number of entries applied.
+         */
+        inline size_t apply_delta(Plot &plot, std::string_view delta) {
+            if (delta.size() < sizeof(sync::delta_magic) + sizeof(uint32_t)) {
+                throw std::runtime_error("Truncated delta");
+            }
+            uint32_t crc;
+            std::memcpy(&crc, delta.data() + delta.size() - sizeof(crc), sizeof(crc));
+            delta.remove_suffix(sizeof(crc));
+            if (crc32c(delta) != crc) {
+                throw std::runtime_error("Corrupt delta: checksum mismatch");
+            }
+
+            binary::Reader in(delta);
+            if (in.view(sizeof(sync::delta_magic)) != std::string_view(sync::delta_magic, sizeof(sync::delta_magic))) {
+                throw std::runtime_error("Not a zoneout delta");
+            }
+            in.u64(); // sender replica
+            uint64_t sender_time = in.u64();
+            uint32_t count = in.u32();
+
+            // Local edits must be stamped before comparing against remote versions
+            stamp(plot);
+
+            size_t applied = 0;
+            std::vector<std::pair<sync::Key, sync::Stamp>> removals;
+            for (uint32_t i = 0; i < count; ++i) {
+                auto key = read_key(in);
+                sync::Stamp remote;
+                remote.time = in.u64();
+                remote.replica = in.u64();
+                remote.deleted = in.boolean();
+                std::string_view payload;
+                std::string tile_cells;
+                if (!remote.deleted) {
+                    payload = in.view(in.u32());
+                    if (key.kind == sync::EntryKind::LayerTile) {
+                        tile_cells = tile_delta::decompress(payload);
+                        payload = tile_cells;
+                    }
+                }
+
+                auto it = entries_.find(key);
+                if (it != entries_.end() && !sync::newer(remote, it->second.stamp)) {
+                    continue;
+                }
+                if (remote.deleted) {
+                    removals.emplace_back(key, remote);
+                    continue;
+                }
+                if (apply_entry(plot, key, payload)) {
+                    if (key.kind == sync::EntryKind::LayerMeta) {
+                        // stamp() will not rescan a layer whose meta it already knows
+                        const auto &layer = plot.zone(key.zone)->get().layer(key.layer);
+                        drop_tiles(key.zone, key.layer, static_cast<uint32_t>(tile_count(layer)));
+                    }
+                    remote.hash = fnv1a64(payload);
+                    auto &entry = entries_[key];
+                    entry.stamp = remote;
+                    entry.sequence = ++sequence_;
+                    ++applied;
+                }
+            }
+
+            // Removals last and in reverse key order, so layers are dropped from the highest index down
+            for (auto it = removals.rbegin(); it != removals.rend(); ++it) {
+                const auto &[key, remote] = *it;
+                apply_removal(plot, key);
+                auto &entry = entries_[key];
+                entry.stamp = remote;
+                entry.sequence = ++sequence_;
+                if (key.kind == sync::EntryKind::ZoneMeta) {
+                    // Retire the zone's contents under the same stamp, so they are not re-announced as local removals
+                    for (auto child = entries_.begin(); child != entries_.end();) {
+                        if (child->first.zone != key.zone || child->first.kind == sync::EntryKind::ZoneMeta) {
+                            ++child;
+                        } else if (child->first.kind == sync::EntryKind::LayerTile) {
+                            child = entries_.erase(child);
+                        } else {
+                            child->second.stamp = remote;
+                            child->second.sequence = sequence_;
+                            ++child;
+                        }
+                    }
+                }
+                ++applied;
+            }
+
+            clock_.update(sender_time);
+            return applied;
+        }
+    };
+
+} // namespace zoneout
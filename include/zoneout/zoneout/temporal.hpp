@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "utils/time.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Fixed-capacity time series of raster slices (ring buffer)
+     *
+     * All slices share one shape and live in a single contiguous allocation; pushing into a full layer overwrites
+     * the oldest slice, so memory stays constant during continuous operation. Slices must be pushed in time order,
+     * which keeps "at time t" lookups a binary search.
+     */
+    template <typename T> class TemporalLayer {
+      private:
+        size_t rows_ = 0;
+        size_t cols_ = 0;
+        size_t capacity_ = 0;
+        double resolution_ = 1.0;
+        bool centered_ = true;
+        dp::Pose pose_{};
+
+        std::vector<T> cells_;
+        std::vector<Timestamp> times_;
+        size_t head_ = 0; // physical index of the oldest slice
+        size_t size_ = 0;
+
+        inline size_t physical(size_t i) const { return (head_ + i) % capacity_; }
+
+        inline T *slice_ptr(size_t i) { return cells_.data() + physical(i) * cell_count(); }
+        inline const T *slice_ptr(size_t i) const { return cells_.data() + physical(i) * cell_count(); }
+
+        /// First logical index whose time is > t (times are non-decreasing)
+        inline size_t upper_bound(const Timestamp &t) const {
+            size_t lo = 0, hi = size_;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (times_[physical(mid)] <= t)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        /// First logical index whose time is >= t
+        inline size_t lower_bound(const Timestamp &t) const {
+            size_t lo = 0, hi = size_;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (times_[physical(mid)] < t)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        template <typename U> inline dp::Grid<U> make_output(U init) const {
+            return dp::make_grid<U>(rows_, cols_, resolution_, centered_, pose_, init);
+        }
+
+      public:
+        using value_type = T;
+
+        TemporalLayer() = default;
+
+        inline TemporalLayer(size_t rows, size_t cols, size_t capacity, double resolution = 1.0, bool centered = true,
+                             const dp::Pose &pose = dp::Pose{})
+            : rows_(rows), cols_(cols), capacity_(capacity), resolution_(resolution), centered_(centered),
+              pose_(pose), cells_(rows * cols * capacity), times_(capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("TemporalLayer capacity must be at least 1");
+            }
+        }
+
+        inline size_t rows() const { return rows_; }
+        inline size_t cols() const { return cols_; }
+        inline size_t cell_count() const { return rows_ * cols_; }
+        inline size_t capacity() const { return capacity_; }
+        inline size_t size() const { return size_; }
+        inline bool empty() const { return size_ == 0; }
+        inline bool full() const { return size_ == capacity_; }
+
+        /// Heap bytes held by the slice buffer and timestamps
+        inline size_t memory_bytes() const {
+            return cells_.capacity() * sizeof(T) + times_.capacity() * sizeof(Timestamp);
+        }
+
+        inline double resolution() const { return resolution_; }
+        inline bool centered() const { return centered_; }
+        inline const dp::Pose &pose() const { return pose_; }
+
+        /**
+         * @brief Append a slice stamped `time` and return its cells for filling
+         *
+         * The new slice starts as a copy of the previous latest slice (zero for the first), which suits
+         * accumulating layers. Throws if `time` is older than the latest slice, or if the layer was
+         * default-constructed and has no capacity.
+         */
+        inline std::span<T> push(const Timestamp &time) {
+            if (capacity_ == 0) {
+                throw std::logic_error("TemporalLayer has no capacity (default-constructed)");
+            }
+            if (size_ > 0 && time < latest_time()) {
+                throw std::invalid_argument("TemporalLayer slices must be pushed in time order");
+            }
+            const T *previous = size_ > 0 ? slice_ptr(size_ - 1) : nullptr;
+            size_t index;
+            if (size_ < capacity_) {
+                index = size_++;
+            } else {
+                head_ = (head_ + 1) % capacity_;
+                index = size_ - 1;
+            }
+            T *dst = slice_ptr(index);
+            if (previous != nullptr && previous != dst) {
+                std::copy(previous, previous + cell_count(), dst);
+            } else if (previous == nullptr) {
+                std::fill(dst, dst + cell_count(), T{});
+            }
+            times_[physical(index)] = time;
+            return std::span<T>(dst, cell_count());
+        }
+
+        inline void push(const Timestamp &time, const dp::Grid<T> &slice) {
+            if (slice.rows != rows_ || slice.cols != cols_) {
+                throw std::invalid_argument("TemporalLayer slice has the wrong shape");
+            }
+            auto dst = push(time);
+            std::copy(slice.data.begin(), slice.data.end(), dst.begin());
+        }
+
+        inline void clear() {
+            head_ = 0;
+            size_ = 0;
+        }
+
+        // ========== Access (index 0 is the oldest slice) ==========
+
+        inline std::span<const T> slice(size_t i) const {
+            if (i >= size_) {
+                throw std::out_of_range("TemporalLayer slice index out of range");
+            }
+            return std::span<const T>(slice_ptr(i), cell_count());
+        }
+
+        inline std::span<T> slice(size_t i) {
+            if (i >= size_) {
+                throw std::out_of_range("TemporalLayer slice index out of range");
+            }
+            return std::span<T>(slice_ptr(i), cell_count());
+        }
+
+        inline const Timestamp &time(size_t i) const {
+            if (i >= size_) {
+                throw std::out_of_range("TemporalLayer slice index out of range");
+            }
+            return times_[physical(i)];
+        }
+
+        inline std::span<const T> latest() const { return slice(size_ - 1); }
+        inline const Timestamp &latest_time() const { return time(size_ - 1); }
+
+        /// Index of the slice valid at `t` (the newest one not after t)
+        inline dp::Optional<size_t> index_at(const Timestamp &t) const {
+            size_t idx = upper_bound(t);
+            if (idx == 0)
+                return dp::nullopt;
+            return idx - 1;
+        }
+
+        /// Cells of the slice valid at `t`; empty if t predates every slice
+        inline std::span<const T> at(const Timestamp &t) const {
+            auto idx = index_at(t);
+            if (!idx.has_value())
+                return {};
+            return slice(*idx);
+        }
+
+        inline T value_at(const Timestamp &t, size_t r, size_t c) const {
+            auto cells = at(t);
+            return cells.empty() ? T{} : cells[r * cols_ + c];
+        }
+
+        /// Materialize one slice as a regular grid
+        inline dp::Grid<T> to_grid(size_t i) const {
+            auto grid = make_output<T>(T{});
+            auto cells = slice(i);
+            std::copy(cells.begin(), cells.end(), grid.data.begin());
+            return grid;
+        }
+
+        // ========== Temporal reductions over slices with from <= time <= to ==========
+
+        /// Number of slices inside [from, to]
+        inline size_t count_in(const Timestamp &from, const Timestamp &to) const {
+            return from > to ? 0 : upper_bound(to) - lower_bound(from);
+        }
+
+        /// Per-cell maximum; cells are T{} when the window holds no slice
+        inline dp::Grid<T> max_over(const Timestamp &from, const Timestamp &to) const {
+            auto result = make_output<T>(T{});
+            size_t first = lower_bound(from);
+            size_t last = from > to ? first : upper_bound(to);
+            if (first >= last)
+                return result;
+            std::copy(slice_ptr(first), slice_ptr(first) + cell_count(), result.data.begin());
+            for (size_t i = first + 1; i < last; ++i) {
+                const T *src = slice_ptr(i);
+                T *dst = result.data.data();
+                for (size_t k = 0; k < cell_count(); ++k)
+                    dst[k] = std::max(dst[k], src[k]);
+            }
+            return result;
+        }
+
+        /// Per-cell minimum; cells are T{} when the window holds no slice
+        inline dp::Grid<T> min_over(const Timestamp &from, const Timestamp &to) const {
+            auto result = make_output<T>(T{});
+            size_t first = lower_bound(from);
+            size_t last = from > to ? first : upper_bound(to);
+            if (first >= last)
+                return result;
+            std::copy(slice_ptr(first), slice_ptr(first) + cell_count(), result.data.begin());
+            for (size_t i = first + 1; i < last; ++i) {
+                const T *src = slice_ptr(i);
+                T *dst = result.data.data();
+                for (size_t k = 0; k < cell_count(); ++k)
+                    dst[k] = std::min(dst[k], src[k]);
+            }
+            return result;
+        }
+
+        /// Per-cell mean (as double); cells are 0 when the window holds no slice
+        inline dp::Grid<double> mean_over(const Timestamp &from, const Timestamp &to) const {
+            auto result = make_output<double>(0.0);
+            size_t first = lower_bound(from);
+            size_t last = from > to ? first : upper_bound(to);
+            if (first >= last)
+                return result;
+            double *dst = result.data.data();
+            for (size_t i = first; i < last; ++i) {
+                const T *src = slice_ptr(i);
+                for (size_t k = 0; k < cell_count(); ++k)
+                    dst[k] += static_cast<double>(src[k]);
+            }
+            const double scale = 1.0 / static_cast<double>(last - first);
+            for (size_t k = 0; k < cell_count(); ++k)
+                dst[k] *= scale;
+            return result;
+        }
+
+        /// Reductions over the trailing `window` ending at the latest slice
+        inline dp::Grid<T> max_over(const Duration &window) const {
+            return empty() ? make_output<T>(T{}) : max_over(latest_time() - window, latest_time());
+        }
+
+        inline dp::Grid<T> min_over(const Duration &window) const {
+            return empty() ? make_output<T>(T{}) : min_over(latest_time() - window, latest_time());
+        }
+
+        inline dp::Grid<double> mean_over(const Duration &window) const {
+            return empty() ? make_output<double>(0.0) : mean_over(latest_time() - window, latest_time());
+        }
+    };
+
+    /// Cell types supported for temporal layers stored in a Grid
+    using TemporalLayerVariant =
+        std::variant<TemporalLayer<uint8_t>, TemporalLayer<uint16_t>, TemporalLayer<float>, TemporalLayer<double>>;
+
+} // namespace zoneout
@@ -0,0 +1,451 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "layer_stats.hpp"
+#include "utils/binary.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    namespace tile_delta {
+
+        /// Change tracking granularity: square tiles of tile_size x tile_size cells
+        inline constexpr size_t tile_size = 64;
+        inline constexpr char delta_magic[4] = {'Z', 'O', 'T', '1'};
+
+        inline size_t tiles_across(size_t cells) { return (cells + tile_size - 1) / tile_size; }
+
+        // Runs shorter than this are cheaper as part of a literal
+        inline constexpr size_t min_run = 4;
+
+        /**
+         * @brief Byte run-length encoding
+         *
+         * Tokens are a varint `n`: odd n is a run of (n >> 1) copies of the following byte, even n is (n >> 1)
+         * literal bytes. XOR deltas (mostly zero) and coverage/class layers (long constant spans) shrink to a
+         * few bytes per changed strip.
+         */
+        inline void rle_encode(binary::Writer &out, const uint8_t *data, size_t size) {
+            size_t literal_start = 0;
+            size_t i = 0;
+            auto flush_literal = [&](size_t end) {
+                if (end > literal_start) {
+                    out.varint(static_cast<uint64_t>(end - literal_start) << 1);
+                    out.bytes(data + literal_start, end - literal_start);
+                }
+            };
+            while (i < size) {
+                size_t run = 1;
+                while (i + run < size && data[i + run] == data[i]) {
+                    ++run;
+                }
+                if (run >= min_run) {
+                    flush_literal(i);
+                    out.varint((static_cast<uint64_t>(run) << 1) | 1);
+                    out.u8(data[i]);
+                    i += run;
+                    literal_start = i;
+                } else {
+                    i += run;
+                }
+            }
+            flush_literal(size);
+        }
+
+        /// Decode exactly `size` bytes into `out`
+        inline void rle_decode(binary::Reader &in, uint8_t *out, size_t size) {
+            size_t pos = 0;
+            while (pos < size) {
+                uint64_t token = in.varint();
+                size_t length = static_cast<size_t>(token >> 1);
+                if (length == 0 || length > size - pos) {
+                    throw std::runtime_error("Corrupt RLE stream");
+                }
+                if (token & 1) {
+                    std::memset(out + pos, in.u8(), length);
+                } else {
+                    std::memcpy(out + pos, in.view(length).data(), length);
+                }
+                pos += length;
+            }
+        }
+
+        /// Self-describing RLE blob (decoded size prefix)
+        inline std::string compress(std::string_view raw) {
+            binary::Writer out;
+            out.varint(raw.size());
+            rle_encode(out, reinterpret_cast<const uint8_t *>(raw.data()), raw.size());
+            return out.release();
+        }
+
+        inline std::string decompress(std::string_view packed) {
+            binary::Reader in(packed);
+            std::string raw(static_cast<size_t>(in.varint()), '\0');
+            rle_decode(in, reinterpret_cast<uint8_t *>(raw.data()), raw.size());
+            return raw;
+        }
+
+        /// Cell rectangle [r0, r1) x [c0, c1) covered by tile `tile` of a rows x cols grid
+        struct TileRect {
+            size_t r0, r1, c0, c1;
+        };
+
+        inline TileRect tile_rect(size_t rows, size_t cols, size_t tile) {
+            const size_t tx = tiles_across(cols);
+            TileRect rect;
+            rect.r0 = (tile / tx) * tile_size;
+            rect.c0 = (tile % tx) * tile_size;
+            rect.r1 = std::min(rows, rect.r0 + tile_size);
+            rect.c1 = std::min(cols, rect.c0 + tile_size);
+            return rect;
+        }
+
+    } // namespace tile_delta
+
+    /**
+     * @brief Dirty-tile bitmap for one layer grid
+     *
+     * Writers mark the cells they touch (mark / mark_rect); diff_tiles() builds the same bitmap by comparing two
+     * grids. Either feeds encode_tile_delta().
+     */
+    class TileChanges {
+      private:
+        size_t rows_ = 0;
+        size_t cols_ = 0;
+        size_t tiles_x_ = 0;
+        size_t tiles_y_ = 0;
+        std::vector<uint64_t> bits_;
+
+      public:
+        TileChanges() = default;
+
+        inline TileChanges(size_t rows, size_t cols)
+            : rows_(rows), cols_(cols), tiles_x_(tile_delta::tiles_across(cols)),
+              tiles_y_(tile_delta::tiles_across(rows)), bits_((tiles_x_ * tiles_y_ + 63) / 64, 0) {}
+
+        template <typename T>
+        inline explicit TileChanges(const dp::Grid<T> &grid) : TileChanges(grid.rows, grid.cols) {}
+
+        inline size_t rows() const { return rows_; }
+        inline size_t cols() const { return cols_; }
+        inline size_t tile_count() const { return tiles_x_ * tiles_y_; }
+
+        inline void mark_tile(size_t tile) {
+            if (tile >= tile_count()) {
+                throw std::out_of_range("TileChanges::mark_tile: tile out of range");
+            }
+            bits_[tile >> 6] |= uint64_t{1} << (tile & 63);
+        }
+
+        inline bool is_dirty(size_t tile) const {
+            if (tile >= tile_count()) {
+                throw std::out_of_range("TileChanges::is_dirty: tile out of range");
+            }
+            return (bits_[tile >> 6] >> (tile & 63)) & 1;
+        }
+
+        inline void mark(size_t r, size_t c) {
+            if (r >= rows_ || c >= cols_) {
+                throw std::out_of_range("TileChanges::mark: cell out of range");
+            }
+            mark_tile((r / tile_delta::tile_size) * tiles_x_ + c / tile_delta::tile_size);
+        }
+
+        /// Mark every tile overlapping the inclusive cell range [r0, r1] x [c0, c1] (clamped to the grid)
+        inline void mark_rect(size_t r0, size_t c0, size_t r1, size_t c1) {
+            if (rows_ == 0 || cols_ == 0 || r0 > r1 || c0 > c1 || r0 >= rows_ || c0 >= cols_)
+                return;
+            r1 = std::min(r1, rows_ - 1);
+            c1 = std::min(c1, cols_ - 1);
+            for (size_t ty = r0 / tile_delta::tile_size; ty <= r1 / tile_delta::tile_size; ++ty) {
+                for (size_t tx = c0 / tile_delta::tile_size; tx <= c1 / tile_delta::tile_size; ++tx) {
+                    mark_tile(ty * tiles_x_ + tx);
+                }
+            }
+        }
+
+        inline void mark_all() {
+            for (size_t t = 0; t < tile_count(); ++t)
+                mark_tile(t);
+        }
+
+        inline size_t dirty_count() const {
+            size_t count = 0;
+            for (auto word : bits_)
+                count += static_cast<size_t>(std::popcount(word));
+            return count;
+        }
+
+        inline bool empty() const {
+            return std::all_of(bits_.begin(), bits_.end(), [](uint64_t w) { return w == 0; });
+        }
+
+        inline void clear() { std::fill(bits_.begin(), bits_.end(), 0); }
+
+        inline const std::vector<uint64_t> &words() const { return bits_; }
+        inline std::vector<uint64_t> &words() { return bits_; }
+    };
+
+    /// Tiles whose cells differ between two grids of the same shape
+    template <typename T> inline TileChanges diff_tiles(const dp::Grid<T> &base, const dp::Grid<T> &current) {
+        if (base.rows != current.rows || base.cols != current.cols) {
+            throw std::invalid_argument("diff_tiles: grids differ in shape");
+        }
+        TileChanges changes(current);
+        for (size_t t = 0; t < changes.tile_count(); ++t) {
+            auto rect = tile_delta::tile_rect(current.rows, current.cols, t);
+            const size_t row_bytes = (rect.c1 - rect.c0) * sizeof(T);
+            for (size_t r = rect.r0; r < rect.r1; ++r) {
+                const size_t offset = r * current.cols + rect.c0;
+                if (std::memcmp(base.data.data() + offset, current.data.data() + offset, row_bytes) != 0) {
+                    changes.mark_tile(t);
+                    break;
+                }
+            }
+        }
+        return changes;
+    }
+
+    namespace tile_delta {
+
+        /// Delta of `current` against base cells supplied per tile row by base_row(tile, r) (see encode_tile_delta)
+        template <typename T, typename BaseRow>
+        inline std::string encode(const dp::Grid<T> &current, const TileChanges &changes, BaseRow &&base_row) {
+            static_assert(std::is_trivially_copyable_v<T>, "Tile deltas require a trivially copyable cell type");
+            binary::Writer out;
+            out.bytes(delta_magic, sizeof(delta_magic));
+            out.u64(current.rows);
+            out.u64(current.cols);
+            out.u32(static_cast<uint32_t>(sizeof(T)));
+            out.u32(static_cast<uint32_t>(changes.words().size()));
+            out.bytes(changes.words().data(), changes.words().size() * sizeof(uint64_t));
+
+            std::vector<uint8_t> xored;
+            xored.reserve(tile_size * tile_size * sizeof(T));
+            for (size_t t = 0; t < changes.tile_count(); ++t) {
+                if (!changes.is_dirty(t))
+                    continue;
+                auto rect = tile_rect(current.rows, current.cols, t);
+                const size_t row_bytes = (rect.c1 - rect.c0) * sizeof(T);
+                xored.resize((rect.r1 - rect.r0) * row_bytes);
+                for (size_t r = rect.r0; r < rect.r1; ++r) {
+                    const auto *a = reinterpret_cast<const uint8_t *>(base_row(t, r));
+                    const auto *b =
+                        reinterpret_cast<const uint8_t *>(current.data.data() + r * current.cols + rect.c0);
+                    uint8_t *dst = xored.data() + (r - rect.r0) * row_bytes;
+                    for (size_t k = 0; k < row_bytes; ++k)
+                        dst[k] = a[k] ^ b[k];
+                }
+                rle_encode(out, xored.data(), xored.size());
+            }
+            return out.release();
+        }
+
+    } // namespace tile_delta
+
+    /**
+     * @brief Encode the change from `base` to `current` for the tiles marked in `changes`
+     *
+     * Layout: header (shape, cell size), changed-tile bitmap, then per changed tile the RLE-compressed XOR of
+     * the two versions. Unchanged cells inside a changed tile XOR to zero and collapse into runs.
+     */
+    template <typename T>
+    inline std::string encode_tile_delta(const dp::Grid<T> &base, const dp::Grid<T> &current,
+                                         const TileChanges &changes) {
+        if (base.rows != current.rows || base.cols != current.cols || changes.rows() != current.rows ||
+            changes.cols() != current.cols) {
+            throw std::invalid_argument("encode_tile_delta: grids differ in shape");
+        }
+        return tile_delta::encode(current, changes, [&](size_t t, size_t r) {
+            return base.data.data() + r * current.cols + tile_delta::tile_rect(current.rows, current.cols, t).c0;
+        });
+    }
+
+    template <typename T> inline std::string encode_tile_delta(const dp::Grid<T> &base, const dp::Grid<T> &current) {
+        return encode_tile_delta(base, current, diff_tiles(base, current));
+    }
+
+    /// Apply a delta produced by encode_tile_delta to the grid it was computed against (base -> current), keeping
+    /// the layer's statistics (if given) in step
+    template <typename T>
+    inline void apply_tile_delta(dp::Grid<T> &grid, std::string_view delta, LayerStats *stats = nullptr) {
+        binary::Reader in(delta);
+        if (in.view(sizeof(tile_delta::delta_magic)) !=
+            std::string_view(tile_delta::delta_magic, sizeof(tile_delta::delta_magic))) {
+            throw std::runtime_error("Not a tile delta");
+        }
+        const auto rows = in.u64();
+        const auto cols = in.u64();
+        const auto cell_size = in.u32();
+        if (rows != grid.rows || cols != grid.cols || cell_size != sizeof(T)) {
+            throw std::runtime_error("Tile delta does not match the target grid");
+        }
+
+        TileChanges changes(grid);
+        const uint32_t words = in.u32();
+        if (words != changes.words().size()) {
+            throw std::runtime_error("Corrupt tile delta: bitmap size");
+        }
+        in.bytes(changes.words().data(), words * sizeof(uint64_t));
+
+        std::vector<uint8_t> xored;
+        for (size_t t = 0; t < changes.tile_count(); ++t) {
+            if (!changes.is_dirty(t))
+                continue;
+            auto rect = tile_delta::tile_rect(grid.rows, grid.cols, t);
+            const size_t row_bytes = (rect.c1 - rect.c0) * sizeof(T);
+            xored.assign((rect.r1 - rect.r0) * row_bytes, 0);
+            tile_delta::rle_decode(in, xored.data(), xored.size());
+            for (size_t r = rect.r0; r < rect.r1; ++r) {
+                T *row = grid.data.data() + r * grid.cols + rect.c0;
+                const uint8_t *src = xored.data() + (r - rect.r0) * row_bytes;
+                if constexpr (std::is_arithmetic_v<T>) {
+                    if (stats != nullptr) {
+                        for (size_t c = 0; c < rect.c1 - rect.c0; ++c) {
+                            const T before = row[c];
+                            auto *cell = reinterpret_cast<uint8_t *>(row + c);
+                            for (size_t k = 0; k < sizeof(T); ++k)
+                                cell[k] ^= src[c * sizeof(T) + k];
+                            stats->update(static_cast<double>(before), static_cast<double>(row[c]));
+                        }
+                        continue;
+                    }
+                }
+                auto *dst = reinterpret_cast<uint8_t *>(row);
+                for (size_t k = 0; k < row_bytes; ++k)
+                    dst[k] ^= src[k];
+            }
+        }
+    }
+
+    /**
+     * @brief Copy-on-write editing of a layer grid, one tile at a time
+     *
+     * The first write into a tile saves that tile's previous cells and marks it dirty, so an edit that touches a
+     * strip of a large layer copies a few tiles instead of the whole grid. delta() encodes the tiles that really
+     * changed against their saved cells (same format as encode_tile_delta); restore() puts them back.
+     */
+    template <typename T> class TileEdit {
+      private:
+        dp::Grid<T> *grid_;
+        TileChanges touched_;
+        std::unordered_map<size_t, std::vector<T>> saved_;
+
+        inline void save(size_t tile) {
+            if (touched_.is_dirty(tile))
+                return;
+            auto rect = tile_delta::tile_rect(grid_->rows, grid_->cols, tile);
+            auto &cells = saved_[tile];
+            cells.reserve((rect.r1 - rect.r0) * (rect.c1 - rect.c0));
+            for (size_t r = rect.r0; r < rect.r1; ++r) {
+                const T *row = grid_->data.data() + r * grid_->cols;
+                cells.insert(cells.end(), row + rect.c0, row + rect.c1);
+            }
+            touched_.mark_tile(tile);
+        }
+
+        inline const T *saved_row(size_t tile, size_t r) const {
+            auto rect = tile_delta::tile_rect(grid_->rows, grid_->cols, tile);
+            return saved_.at(tile).data() + (r - rect.r0) * (rect.c1 - rect.c0);
+        }
+
+      public:
+        inline explicit TileEdit(dp::Grid<T> &grid) : grid_(&grid), touched_(grid) {}
+
+        inline size_t rows() const { return grid_->rows; }
+        inline size_t cols() const { return grid_->cols; }
+
+        /// Read-only view of the grid being edited
+        inline const dp::Grid<T> &grid() const { return *grid_; }
+
+        inline const T &operator()(size_t r, size_t c) const { return (*grid_)(r, c); }
+
+        inline void set(size_t r, size_t c, T value) {
+            if (r >= grid_->rows || c >= grid_->cols) {
+                throw std::out_of_range("TileEdit::set: cell out of range");
+            }
+            const size_t tiles_x = tile_delta::tiles_across(grid_->cols);
+            save((r / tile_delta::tile_size) * tiles_x + c / tile_delta::tile_size);
+            (*grid_)(r, c) = value;
+        }
+
+        /// Writable cells [c0, c1) of row `r`; every tile they cross is saved first
+        inline std::span<T> row(size_t r, size_t c0, size_t c1) {
+            if (r >= grid_->rows || c0 > c1 || c1 > grid_->cols) {
+                throw std::out_of_range("TileEdit::row: span out of range");
+            }
+            const size_t tiles_x = tile_delta::tiles_across(grid_->cols);
+            for (size_t tx = c0 / tile_delta::tile_size; c0 < c1 && tx <= (c1 - 1) / tile_delta::tile_size; ++tx) {
+                save((r / tile_delta::tile_size) * tiles_x + tx);
+            }
+            return {grid_->data.data() + r * grid_->cols + c0, c1 - c0};
+        }
+
+        /// Tiles written to, whether or not their cells ended up different
+        inline const TileChanges &touched() const { return touched_; }
+
+        /// Tiles whose cells differ from the saved ones
+        inline TileChanges changes() const {
+            TileChanges changes(*grid_);
+            for (const auto &[tile, cells] : saved_) {
+                auto rect = tile_delta::tile_rect(grid_->rows, grid_->cols, tile);
+                const size_t row_bytes = (rect.c1 - rect.c0) * sizeof(T);
+                for (size_t r = rect.r0; r < rect.r1; ++r) {
+                    const T *now = grid_->data.data() + r * grid_->cols + rect.c0;
+                    if (std::memcmp(saved_row(tile, r), now, row_bytes) != 0) {
+                        changes.mark_tile(tile);
+                        break;
+                    }
+                }
+            }
+            return changes;
+        }
+
+        /// Delta from the saved tiles to the current grid for `changes` (a subset of touched())
+        inline std::string delta(const TileChanges &changes) const {
+            return tile_delta::encode(*grid_, changes, [&](size_t t, size_t r) { return saved_row(t, r); });
+        }
+
+        /// Account every cell this edit changed in the layer's statistics; call once, after the edit is final
+        inline void account(LayerStats &stats) const {
+            static_assert(std::is_arithmetic_v<T>, "LayerStats requires an arithmetic cell type");
+            for (const auto &[tile, cells] : saved_) {
+                auto rect = tile_delta::tile_rect(grid_->rows, grid_->cols, tile);
+                for (size_t r = rect.r0; r < rect.r1; ++r) {
+                    const T *before = saved_row(tile, r);
+                    const T *now = grid_->data.data() + r * grid_->cols + rect.c0;
+                    for (size_t c = 0; c < rect.c1 - rect.c0; ++c)
+                        stats.update(static_cast<double>(before[c]), static_cast<double>(now[c]));
+                }
+            }
+        }
+
+        /// Undo every write made through this edit
+        inline void restore() {
+            for (const auto &[tile, cells] : saved_) {
+                auto rect = tile_delta::tile_rect(grid_->rows, grid_->cols, tile);
+                const size_t width = rect.c1 - rect.c0;
+                for (size_t r = rect.r0; r < rect.r1; ++r) {
+                    std::copy_n(saved_row(tile, r), width, grid_->data.data() + r * grid_->cols + rect.c0);
+                }
+            }
+            saved_.clear();
+            touched_.clear();
+        }
+    };
+
+} // namespace zoneout
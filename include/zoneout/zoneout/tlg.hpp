@@ -0,0 +1,522 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "isoxml.hpp"
+#include "utils/geodesy.hpp"
+#include "utils/metrics.hpp"
+#include "utils/time.hpp"
+#include "zone.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    namespace isoxml {
+
+        /**
+         * @brief Layout of an ISOXML time log (TLGnnnnn.XML), describing each record of the matching .BIN
+         *
+         * An attribute present with an empty value is stored per record in the binary; one with a value is fixed for
+         * the whole log; an absent one is not logged. Position fields are PTN A..I, in that order.
+         */
+        struct TlgHeader {
+            bool time_in_binary = true;
+            Timestamp fixed_time{};
+            std::array<bool, 9> position_in_binary{}; // PTN A..I
+            double fixed_north = std::numeric_limits<double>::quiet_NaN();
+            double fixed_east = std::numeric_limits<double>::quiet_NaN();
+            double fixed_up = 0.0;      // metres
+            std::vector<uint16_t> ddis; // DLV order, the index used in records
+
+            /// Bytes of the fixed part of a record (time and position), before the DLV count
+            inline size_t fixed_bytes() const {
+                static constexpr std::array<size_t, 9> sizes{4, 4, 4, 1, 2, 2, 1, 4, 2};
+                size_t bytes = time_in_binary ? 6 : 0;
+                for (size_t i = 0; i < sizes.size(); ++i)
+                    bytes += position_in_binary[i] ? sizes[i] : 0;
+                return bytes;
+            }
+
+            /// Largest possible record
+            inline size_t max_record_bytes() const { return fixed_bytes() + 1 + 255 * 5; }
+
+            inline dp::Optional<size_t> ddi_index(uint16_t ddi) const {
+                auto it = std::find(ddis.begin(), ddis.end(), ddi);
+                if (it == ddis.end())
+                    return dp::nullopt;
+                return static_cast<size_t>(it - ddis.begin());
+            }
+        };
+
+        /// One decoded time log record; `values[i]` belongs to header DLV i and is valid when `present[i]` is set
+        struct TlgRecord {
+            Timestamp time{};
+            double latitude = std::numeric_limits<double>::quiet_NaN();
+            double longitude = std::numeric_limits<double>::quiet_NaN();
+            double altitude = 0.0;
+            uint8_t status = 1; // PTN D; 1 (GNSS fix) when not logged
+            std::vector<int32_t> values;
+            std::vector<uint8_t> present;
+
+            /// Position status 0 (no fix), 14 (error) and 15 (not available) carry no usable position
+            inline bool has_fix() const {
+                return status != 0 && status != 14 && status != 15 && !std::isnan(latitude) && !std::isnan(longitude);
+            }
+        };
+
+        namespace detail {
+
+            /// Attributes of the first `<tag ...>` at or after `from`; `from` moves past it, or to npos if none is left
+            inline std::vector<std::pair<std::string, std::string>> tag_attributes(const std::string &xml,
+                                                                                  const std::string &tag,
+                                                                                  size_t &from) {
+                std::vector<std::pair<std::string, std::string>> attrs;
+                const std::string open = "<" + tag;
+                size_t pos = from;
+                while (true) {
+                    pos = xml.find(open, pos);
+                    if (pos == std::string::npos) {
+                        from = std::string::npos;
+                        return attrs;
+                    }
+                    const char next = pos + open.size() < xml.size() ? xml[pos + open.size()] : '\0';
+                    if (next == ' ' || next == '/' || next == '>' || next == '\t' || next == '\n' || next == '\r')
+                        break;
+                    pos += open.size();
+                }
+                const size_t end = xml.find('>', pos);
+                if (end == std::string::npos) {
+                    throw std::runtime_error("Malformed ISOXML: unterminated <" + tag + ">");
+                }
+                size_t i = pos + open.size();
+                while (i < end) {
+                    const size_t eq = xml.find('=', i);
+                    if (eq == std::string::npos || eq > end)
+                        break;
+                    size_t name_begin = xml.find_first_not_of(" \t\r\n", i);
+                    std::string name = xml.substr(name_begin, eq - name_begin);
+                    name.erase(name.find_last_not_of(" \t\r\n") + 1);
+                    const size_t quote = xml.find_first_of("\"'", eq);
+                    if (quote == std::string::npos || quote > end)
+                        break;
+                    const size_t close = xml.find(xml[quote], quote + 1);
+                    if (close == std::string::npos) {
+                        throw std::runtime_error("Malformed ISOXML: unterminated attribute in <" + tag + ">");
+                    }
+                    attrs.emplace_back(std::move(name), xml.substr(quote + 1, close - quote - 1));
+                    i = close + 1;
+                }
+                from = end + 1;
+                return attrs;
+            }
+
+            inline const std::string *find_attribute(const std::vector<std::pair<std::string, std::string>> &attrs,
+                                                     const std::string &name) {
+                for (const auto &[key, value] : attrs) {
+                    if (key == name)
+                        return &value;
+                }
+                return nullptr;
+            }
+
+            template <typename T> inline T read_le(const char *p) {
+                std::make_unsigned_t<T> v = 0;
+                for (size_t b = sizeof(T); b-- > 0;)
+                    v = static_cast<std::make_unsigned_t<T>>((v << 8) | static_cast<uint8_t>(p[b]));
+                return static_cast<T>(v);
+            }
+
+            /// ISOXML dates count days from 1980-01-01, times milliseconds from midnight
+            inline Timestamp tlg_time(uint32_t ms_of_day, uint16_t days) {
+                constexpr int64_t epoch_1980 = 315532800;
+                return Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                    std::chrono::seconds(epoch_1980 + int64_t{days} * 86400) + std::chrono::milliseconds(ms_of_day)));
+            }
+
+            /// Decode the record at `p` into `record` if all of it lies before `end`; returns its size or 0
+            inline size_t decode_record(const TlgHeader &header, const char *p, const char *end, TlgRecord &record) {
+                const size_t fixed = header.fixed_bytes();
+                if (static_cast<size_t>(end - p) < fixed + 1)
+                    return 0;
+                const size_t count = static_cast<uint8_t>(p[fixed]);
+                const size_t size = fixed + 1 + count * 5;
+                if (static_cast<size_t>(end - p) < size)
+                    return 0;
+
+                const char *q = p;
+                if (header.time_in_binary) {
+                    const auto ms = read_le<uint32_t>(q);
+                    const auto days = read_le<uint16_t>(q + 4);
+                    record.time = tlg_time(ms, days);
+                    q += 6;
+                } else {
+                    record.time = header.fixed_time;
+                }
+                record.latitude = header.fixed_north;
+                record.longitude = header.fixed_east;
+                record.altitude = header.fixed_up;
+                record.status = 1;
+                const auto &bin = header.position_in_binary;
+                if (bin[0]) {
+                    record.latitude = read_le<int32_t>(q) * 1e-7;
+                    q += 4;
+                }
+                if (bin[1]) {
+                    record.longitude = read_le<int32_t>(q) * 1e-7;
+                    q += 4;
+                }
+                if (bin[2]) {
+                    record.altitude = read_le<int32_t>(q) * 1e-3;
+                    q += 4;
+                }
+                if (bin[3]) {
+                    record.status = static_cast<uint8_t>(*q);
+                    q += 1;
+                }
+                // PDOP, HDOP, satellites, GPS time and date are skipped
+                q += (bin[4] ? 2 : 0) + (bin[5] ? 2 : 0) + (bin[6] ? 1 : 0) + (bin[7] ? 4 : 0) + (bin[8] ? 2 : 0);
+
+                std::fill(record.present.begin(), record.present.end(), uint8_t{0});
+                q += 1;
+                for (size_t i = 0; i < count; ++i, q += 5) {
+                    const auto index = static_cast<uint8_t>(q[0]);
+                    if (index < record.values.size()) {
+                        record.values[index] = read_le<int32_t>(q + 1);
+                        record.present[index] = 1;
+                    }
+                }
+                return size;
+            }
+
+            inline std::filesystem::path binary_for(const std::filesystem::path &header_path) {
+                auto bin = header_path;
+                bin.replace_extension(".BIN");
+                if (!std::filesystem::exists(bin)) {
+                    bin.replace_extension(".bin");
+                }
+                return bin;
+            }
+
+        } // namespace detail
+
+        inline TlgHeader parse_tlg_header(const std::string &xml) {
+            TlgHeader header;
+            size_t from = 0;
+            auto tim = detail::tag_attributes(xml, "TIM", from);
+            if (from == std::string::npos) {
+                throw std::runtime_error("ISOXML time log header has no TIM element");
+            }
+            if (const auto *start = detail::find_attribute(tim, "A"); start != nullptr && !start->empty()) {
+                header.time_in_binary = false;
+                header.fixed_time = time_utils::fromISO8601(*start);
+            }
+
+            size_t ptn_from = from;
+            auto ptn = detail::tag_attributes(xml, "PTN", ptn_from);
+            if (ptn_from != std::string::npos) {
+                static constexpr std::array<const char *, 9> names{"A", "B", "C", "D", "E", "F", "G", "H", "I"};
+                for (size_t i = 0; i < names.size(); ++i) {
+                    const auto *value = detail::find_attribute(ptn, names[i]);
+                    if (value == nullptr)
+                        continue;
+                    if (value->empty()) {
+                        header.position_in_binary[i] = true;
+                    } else if (i == 0) {
+                        header.fixed_north = std::stod(*value);
+                    } else if (i == 1) {
+                        header.fixed_east = std::stod(*value);
+                    } else if (i == 2) {
+                        header.fixed_up = std::stod(*value) * 1e-3;
+                    }
+                }
+            }
+
+            size_t dlv_from = from;
+            while (true) {
+                auto dlv = detail::tag_attributes(xml, "DLV", dlv_from);
+                if (dlv_from == std::string::npos)
+                    break;
+                const auto *ddi = detail::find_attribute(dlv, "A");
+                if (ddi == nullptr || ddi->empty()) {
+                    throw std::runtime_error("ISOXML time log DLV without a DDI");
+                }
+                header.ddis.push_back(static_cast<uint16_t>(std::stoul(*ddi, nullptr, 16)));
+            }
+            return header;
+        }
+
+        inline TlgHeader read_tlg_header(const std::filesystem::path &path) {
+            std::ifstream in(path);
+            if (!in) {
+                throw std::runtime_error("Cannot open ISOXML time log header: " + path.string());
+            }
+            std::stringstream ss;
+            ss << in.rdbuf();
+            return parse_tlg_header(ss.str());
+        }
+
+        /**
+         * @brief Stream the records of a time log binary through `fn(const TlgRecord &)`
+         *
+         * The file is read `chunk_bytes` at a time (at least one maximal record) and records are decoded in place;
+         * a record split across chunks is carried over. A truncated final record is ignored. Returns the number of
+         * records decoded.
+         */
+        template <typename Fn>
+        inline size_t read_time_log(const std::filesystem::path &bin_path, const TlgHeader &header, Fn &&fn,
+                                    size_t chunk_bytes = size_t{1} << 16) {
+            std::ifstream in(bin_path, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("Cannot open ISOXML time log: " + bin_path.string());
+            }
+            chunk_bytes = std::max(chunk_bytes, header.max_record_bytes());
+            std::vector<char> buffer(chunk_bytes * 2);
+            TlgRecord record;
+            record.values.assign(header.ddis.size(), 0);
+            record.present.assign(header.ddis.size(), 0);
+
+            size_t records = 0;
+            size_t filled = 0;
+            while (true) {
+                in.read(buffer.data() + filled, static_cast<std::streamsize>(chunk_bytes));
+                const auto got = static_cast<size_t>(in.gcount());
+                filled += got;
+                const char *p = buffer.data();
+                const char *end = buffer.data() + filled;
+                while (const size_t size = detail::decode_record(header, p, end, record)) {
+                    fn(static_cast<const TlgRecord &>(record));
+                    p += size;
+                    ++records;
+                }
+                const size_t rest = static_cast<size_t>(end - p);
+                std::memmove(buffer.data(), p, rest);
+                filled = rest;
+                if (got == 0 || !in)
+                    break;
+            }
+            ZONEOUT_METRIC_COUNT("isoxml.records_decoded", records);
+            return records;
+        }
+
+        struct ImportOptions {
+            uint16_t ddi = 0x0006;             // process data variable to rasterize
+            double value_scale = 1.0;          // DDI units -> layer value
+            std::string layer_name = "as_applied";
+            std::string temporal_layer;        // if set, one slice per log (by start time) in this temporal layer
+            bool skip_invalid_fix = true;      // drop records whose position status is no fix / error / missing
+            size_t threads = 0;                // 0 = all the executor offers
+            size_t chunk_bytes = size_t{1} << 16;
+        };
+
+        struct ImportSummary {
+            size_t logs = 0;
+            size_t records = 0;
+            size_t samples = 0; // records burned into a cell
+            size_t outside = 0; // records with the DDI that fell outside the grid
+            size_t layer_index = 0;
+        };
+
+        /// TLG*.XML headers in a TASKDATA directory, in name order
+        inline std::vector<std::filesystem::path> find_time_logs(const std::filesystem::path &taskdata_dir) {
+            std::vector<std::filesystem::path> logs;
+            for (const auto &entry : std::filesystem::directory_iterator(taskdata_dir)) {
+                const auto name = entry.path().filename().string();
+                auto ext = entry.path().extension().string();
+                std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return std::toupper(ch); });
+                if (entry.is_regular_file() && name.size() > 3 && name.compare(0, 3, "TLG") == 0 && ext == ".XML") {
+                    logs.push_back(entry.path());
+                }
+            }
+            std::sort(logs.begin(), logs.end());
+            return logs;
+        }
+
+        /**
+         * @brief Rasterize time logs onto the zone's grid geometry as a float layer of per-cell means
+         *
+         * `logs` are TLG header paths (the .BIN sits next to each). Logs are decoded in parallel, each worker
+         * accumulating into its own sum/count grids; positions are converted to ENU one chunk at a time. Cells
+         * without samples are NaN. With `temporal_layer` set, each log also becomes a slice (ordered by its first
+         * record) holding that log's cell means over the previous slice.
+         */
+        inline ImportSummary import_time_logs(Zone &zone, const std::vector<std::filesystem::path> &logs,
+                                              const ImportOptions &options = {}) {
+            ZONEOUT_METRIC_TIMER("isoxml.import");
+            if (!zone.grid().has_layers()) {
+                throw std::runtime_error("Time log import needs a shape: zone has no raster layers");
+            }
+            const auto shape = zone.visit_raster(0, [](const auto &g) {
+                return dp::make_grid<float>(g.rows, g.cols, g.resolution, g.centered, g.pose,
+                                            std::numeric_limits<float>::quiet_NaN());
+            });
+            const size_t cells = shape.rows * shape.cols;
+
+            // Cell-centre affine of the layer, inverted to map ENU points to (row, col)
+            const auto origin = shape.get_point(0, 0);
+            const auto col_step = shape.cols > 1 ? shape.get_point(0, 1) : dp::Point{origin.x + shape.resolution,
+                                                                                      origin.y, 0.0};
+            const auto row_step = shape.rows > 1 ? shape.get_point(1, 0) : dp::Point{origin.x,
+                                                                                      origin.y - shape.resolution, 0.0};
+            const double ax = col_step.x - origin.x, ay = col_step.y - origin.y;
+            const double bx = row_step.x - origin.x, by = row_step.y - origin.y;
+            const double det = ax * by - ay * bx;
+            const LocalFrame frame(zone.datum());
+
+            struct Accumulator {
+                std::vector<double> sum;
+                std::vector<uint32_t> count;
+                size_t records = 0, samples = 0, outside = 0;
+            };
+            struct Slice {
+                Timestamp start{};
+                std::vector<std::pair<uint32_t, float>> cells;
+            };
+
+            // One executor for both calls, so the worker count matches the workers run() hands out
+            auto pool = executor::get_default();
+            const size_t workers = async::worker_count(logs.size(), options.threads, *pool);
+            std::vector<Accumulator> totals(workers);
+            std::vector<Accumulator> scratch(workers);
+            std::vector<Slice> slices(options.temporal_layer.empty() ? 0 : logs.size());
+
+            async::run(
+                logs.size(), options.threads, {}, "Time log import",
+                [&](size_t i, size_t worker) {
+                    auto &total = totals[worker];
+                    auto &log = scratch[worker];
+                    if (total.sum.empty()) {
+                        total.sum.assign(cells, 0.0);
+                        total.count.assign(cells, 0);
+                        log.sum.assign(cells, 0.0);
+                        log.count.assign(cells, 0);
+                    }
+                    std::vector<uint32_t> touched;
+
+                    const auto header = read_tlg_header(logs[i]);
+                    const auto value_index = header.ddi_index(options.ddi);
+                    Timestamp start = Timestamp::max();
+
+                    std::vector<dp::Geo> positions;
+                    std::vector<double> values;
+                    std::vector<dp::Point> enu;
+                    constexpr size_t batch = 4096;
+                    auto flush = [&] {
+                        enu.resize(positions.size());
+                        frame.to_enu(positions, enu);
+                        for (size_t k = 0; k < enu.size(); ++k) {
+                            const double dx = enu[k].x - origin.x, dy = enu[k].y - origin.y;
+                            const double c = std::round((dx * by - dy * bx) / det);
+                            const double r = std::round((ax * dy - ay * dx) / det);
+                            if (r < 0 || c < 0 || r >= static_cast<double>(shape.rows) ||
+                                c >= static_cast<double>(shape.cols)) {
+                                ++log.outside;
+                                continue;
+                            }
+                            const auto cell = static_cast<uint32_t>(static_cast<size_t>(r) * shape.cols +
+                                                                    static_cast<size_t>(c));
+                            if (log.count[cell] == 0)
+                                touched.push_back(cell);
+                            log.sum[cell] += values[k];
+                            ++log.count[cell];
+                            ++log.samples;
+                        }
+                        positions.clear();
+                        values.clear();
+                    };
+
+                    const auto records = read_time_log(
+                        detail::binary_for(logs[i]), header,
+                        [&](const TlgRecord &record) {
+                            start = std::min(start, record.time);
+                            if (!value_index.has_value() || !record.present[*value_index])
+                                return;
+                            if (options.skip_invalid_fix && !record.has_fix())
+                                return;
+                            positions.push_back(dp::Geo{record.latitude, record.longitude, record.altitude});
+                            values.push_back(record.values[*value_index] * options.value_scale);
+                            if (positions.size() == batch)
+                                flush();
+                        },
+                        options.chunk_bytes);
+                    flush();
+
+                    if (!slices.empty()) {
+                        slices[i].start = start;
+                        slices[i].cells.reserve(touched.size());
+                    }
+                    for (auto cell : touched) {
+                        if (!slices.empty()) {
+                            slices[i].cells.emplace_back(cell, static_cast<float>(log.sum[cell] / log.count[cell]));
+                        }
+                        total.sum[cell] += log.sum[cell];
+                        total.count[cell] += log.count[cell];
+                        log.sum[cell] = 0.0;
+                        log.count[cell] = 0;
+                    }
+                    total.records += records;
+                    total.samples += log.samples;
+                    total.outside += log.outside;
+                    log.samples = log.outside = 0;
+                },
+                pool);
+
+            ImportSummary summary;
+            summary.logs = logs.size();
+            auto layer = shape;
+            std::vector<double> sum(cells, 0.0);
+            std::vector<uint32_t> count(cells, 0);
+            for (const auto &total : totals) {
+                summary.records += total.records;
+                summary.samples += total.samples;
+                summary.outside += total.outside;
+                if (total.sum.empty())
+                    continue;
+                for (size_t c = 0; c < cells; ++c) {
+                    sum[c] += total.sum[c];
+                    count[c] += total.count[c];
+                }
+            }
+            for (size_t c = 0; c < cells; ++c) {
+                if (count[c] > 0)
+                    layer.data[c] = static_cast<float>(sum[c] / count[c]);
+            }
+            zone.grid().add_grid(layer, options.layer_name, "as_applied");
+            summary.layer_index = zone.grid().layer_count() - 1;
+
+            if (!slices.empty()) {
+                std::stable_sort(slices.begin(), slices.end(),
+                                 [](const Slice &a, const Slice &b) { return a.start < b.start; });
+                auto &series = zone.grid().add_temporal_layer<float>(options.temporal_layer, slices.size(),
+                                                                     shape.rows, shape.cols);
+                for (const auto &slice : slices) {
+                    auto dst = series.push(slice.start);
+                    if (series.size() == 1)
+                        std::fill(dst.begin(), dst.end(), std::numeric_limits<float>::quiet_NaN());
+                    for (const auto &[cell, value] : slice.cells)
+                        dst[cell] = value;
+                }
+            }
+            return summary;
+        }
+
+    } // namespace isoxml
+
+} // namespace zoneout
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <type_traits>
+
+#include "executor.hpp"
+
+namespace zoneout {
+
+    /// Thrown (through the future) when an asynchronous operation stops because its stop token was triggered
+    class Cancelled : public std::runtime_error {
+      public:
+        inline explicit Cancelled(const std::string &what) : std::runtime_error(what + " cancelled") {}
+    };
+
+    namespace async {
+
+        inline void throw_if_stopped(const std::stop_token &stop, const char *what) {
+            if (stop.stop_requested()) {
+                throw Cancelled(what);
+            }
+        }
+
+        /// Workers run() will use for `count` tasks: `threads` (0 = all) capped by the executor's concurrency
+        inline size_t worker_count(size_t count, size_t threads, const Executor &pool) {
+            const size_t limit = std::max<size_t>(1, pool.concurrency());
+            threads = threads == 0 ? limit : std::min(threads, limit);
+            return std::max<size_t>(1, std::min(threads, count));
+        }
+
+        inline size_t worker_count(size_t count, size_t threads) {
+            return worker_count(count, threads, *executor::get_default());
+        }
+
+        namespace detail {
+
+            // Lives as long as the last helper task, which may be dequeued after run() has returned
+            struct Helpers {
+                std::mutex mutex;
+                std::condition_variable done;
+                size_t active = 0;
+                size_t started = 0;
+                bool closed = false;
+            };
+
+        } // namespace detail
+
+        /**
+         * @brief Run fn(i), or fn(i, worker), for i in [0, count) on up to `threads` workers of `pool`
+         *
+         * The caller is worker 0 and works through the tasks itself; worker_count() - 1 helpers are submitted to
+         * `pool` (the default executor unless given) and join in as they get scheduled, numbered 1.. in the order
+         * they start. Helpers still queued when the caller runs out of tasks are abandoned rather than waited for, so
+         * nested calls from inside an executor task cannot deadlock it.
+         *
+         * Tasks are claimed in index order. The stop token is checked before each task; once it fires, or a task
+         * throws, no further tasks start. The first exception is rethrown after all workers have finished; a stop that
+         * prevented a task from running surfaces as Cancelled.
+         */
+        template <typename Fn>
+        inline void run(size_t count, size_t threads, const std::stop_token &stop, const char *what, Fn &&fn,
+                        std::shared_ptr<Executor> pool = nullptr) {
+            if (!pool)
+                pool = executor::get_default();
+
+            std::atomic<size_t> next{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto work = [&](size_t worker) {
+                for (size_t i = next++; i < count && !failed.load(std::memory_order_relaxed); i = next++) {
+                    try {
+                        throw_if_stopped(stop, what);
+                        if constexpr (std::is_invocable_v<Fn &, size_t, size_t>)
+                            fn(i, worker);
+                        else
+                            fn(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        failed = true;
+                    }
+                }
+            };
+
+            const size_t n = worker_count(count, threads, *pool);
+            auto helpers = std::make_shared<detail::Helpers>();
+            for (size_t w = 1; w < n; ++w) {
+                pool->submit([helpers, &work] {
+                    size_t worker;
+                    {
+                        std::lock_guard<std::mutex> lock(helpers->mutex);
+                        if (helpers->closed)
+                            return;
+                        ++helpers->active;
+                        worker = ++helpers->started;
+                    }
+                    work(worker);
+                    std::lock_guard<std::mutex> lock(helpers->mutex);
+                    if (--helpers->active == 0)
+                        helpers->done.notify_all();
+                });
+            }
+            work(0);
+            {
+                std::unique_lock<std::mutex> lock(helpers->mutex);
+                helpers->closed = true;
+                helpers->done.wait(lock, [&] { return helpers->active == 0; });
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        /// Run fn() on the default executor and hand its result (or exception) back through a future
+        template <typename Fn> inline auto submit(Fn fn) -> std::future<std::invoke_result_t<Fn &>> {
+            using Result = std::invoke_result_t<Fn &>;
+            auto promise = std::make_shared<std::promise<Result>>();
+            auto future = promise->get_future();
+            executor::get_default()->submit([promise, fn = std::move(fn)]() mutable {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        fn();
+                        promise->set_value();
+                    } else {
+                        promise->set_value(fn());
+                    }
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            return future;
+        }
+
+    } // namespace async
+
+} // namespace zoneout
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+#include "uuid.hpp"
+
+namespace dp = datapod;
+
+namespace zoneout {
+    namespace binary {
+
+        // Compact binary encoding shared by the journal and sync formats. Fixed-width values are stored in host
+        // byte order (all supported targets are little-endian); strings and arrays are length-prefixed.
+
+        class Writer {
+          private:
+            std::string buffer_;
+
+          public:
+            Writer() = default;
+
+            inline const std::string &data() const { return buffer_; }
+            inline std::string release() { return std::move(buffer_); }
+            inline size_t size() const { return buffer_.size(); }
+            inline void clear() { buffer_.clear(); }
+            inline void reserve(size_t n) { buffer_.reserve(n); }
+
+            inline void bytes(const void *data, size_t size) {
+                buffer_.append(static_cast<const char *>(data), size);
+            }
+
+            template <typename T> inline void pod(const T &value) {
+                static_assert(std::is_trivially_copyable_v<T>, "pod() requires a trivially copyable type");
+                bytes(&value, sizeof(T));
+            }
+
+            inline void u8(uint8_t v) { pod(v); }
+            inline void u16(uint16_t v) { pod(v); }
+            inline void u32(uint32_t v) { pod(v); }
+            inline void u64(uint64_t v) { pod(v); }
+            inline void f64(double v) { pod(v); }
+            inline void boolean(bool v) { u8(v ? 1 : 0); }
+
+            /// LEB128: 7 bits per byte, small values take one byte
+            inline void varint(uint64_t v) {
+                while (v >= 0x80) {
+                    buffer_.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                    v >>= 7;
+                }
+                buffer_.push_back(static_cast<char>(v));
+            }
+
+            inline void str(std::string_view s) {
+                u32(static_cast<uint32_t>(s.size()));
+                bytes(s.data(), s.size());
+            }
+
+            inline void uuid(const UUID &id) { bytes(id.bytes().data(), id.bytes().size()); }
+
+            /// Written in key order so equal maps always encode (and hash) identically; takes std or pmr maps
+            template <typename Map> inline void properties(const Map &props) {
+                std::vector<const typename Map::value_type *> sorted;
+                sorted.reserve(props.size());
+                for (const auto &entry : props) {
+                    sorted.push_back(&entry);
+                }
+                std::sort(sorted.begin(), sorted.end(),
+                          [](const auto *a, const auto *b) { return a->first < b->first; });
+
+                u32(static_cast<uint32_t>(sorted.size()));
+                for (const auto *entry : sorted) {
+                    str(entry->first);
+                    str(entry->second);
+                }
+            }
+
+            inline void point(const dp::Point &p) {
+                f64(p.x);
+                f64(p.y);
+                f64(p.z);
+            }
+
+            inline void segment(const dp::Segment &s) {
+                point(s.start);
+                point(s.end);
+            }
+
+            inline void polygon(const dp::Polygon &poly) {
+                u32(static_cast<uint32_t>(poly.vertices.size()));
+                for (const auto &v : poly.vertices) {
+                    point(v);
+                }
+            }
+
+            inline void geo(const dp::Geo &g) {
+                f64(g.latitude);
+                f64(g.longitude);
+                f64(g.altitude);
+            }
+
+            template <typename T> inline void grid(const dp::Grid<T> &g) {
+                static_assert(std::is_trivially_copyable_v<T>, "grid() requires a trivially copyable cell type");
+                u64(g.rows);
+                u64(g.cols);
+                f64(g.resolution);
+                boolean(g.centered);
+                pod(g.pose);
+                u64(g.data.size());
+                bytes(g.data.data(), g.data.size() * sizeof(T));
+            }
+        };
+
+        class Reader {
+          private:
+            const char *data_;
+            size_t size_;
+            size_t pos_ = 0;
+
+            inline void need(size_t n) const {
+                if (size_ - pos_ < n) {
+                    throw std::runtime_error("Truncated binary record");
+                }
+            }
+
+          public:
+            inline Reader(const void *data, size_t size) : data_(static_cast<const char *>(data)), size_(size) {}
+            inline explicit Reader(std::string_view data) : Reader(data.data(), data.size()) {}
+
+            inline size_t position() const { return pos_; }
+            inline size_t remaining() const { return size_ - pos_; }
+            inline bool done() const { return pos_ == size_; }
+
+            inline void bytes(void *out, size_t size) {
+                need(size);
+                std::memcpy(out, data_ + pos_, size);
+                pos_ += size;
+            }
+
+            /// View of the next `size` bytes without copying
+            inline std::string_view view(size_t size) {
+                need(size);
+                std::string_view result(data_ + pos_, size);
+                pos_ += size;
+                return result;
+            }
+
+            template <typename T> inline T pod() {
+                static_assert(std::is_trivially_copyable_v<T>, "pod() requires a trivially copyable type");
+                T value;
+                bytes(&value, sizeof(T));
+                return value;
+            }
+
+            inline uint8_t u8() { return pod<uint8_t>(); }
+            inline uint16_t u16() { return pod<uint16_t>(); }
+            inline uint32_t u32() { return pod<uint32_t>(); }
+            inline uint64_t u64() { return pod<uint64_t>(); }
+            inline double f64() { return pod<double>(); }
+            inline bool boolean() { return u8() != 0; }
+
+            inline uint64_t varint() {
+                uint64_t v = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    uint8_t byte = u8();
+                    v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return v;
+                    }
+                }
+                throw std::runtime_error("Corrupt binary record: varint too long");
+            }
+
+            inline std::string str() { return std::string(view(u32())); }
+
+            inline UUID uuid() {
+                UUID::ByteArray raw;
+                bytes(raw.data(), raw.size());
+                return UUID(raw);
+            }
+
+            inline std::unordered_map<std::string, std::string> properties() {
+                std::unordered_map<std::string, std::string> props;
+                uint32_t count = u32();
+                props.reserve(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    auto key = str();
+                    props[std::move(key)] = str();
+                }
+                return props;
+            }
+
+            inline dp::Point point() {
+                double x = f64();
+                double y = f64();
+                double z = f64();
+                return dp::Point{x, y, z};
+            }
+
+            inline dp::Segment segment() {
+                dp::Segment s;
+                s.start = point();
+                s.end = point();
+                return s;
+            }
+
+            inline dp::Polygon polygon() {
+                dp::Polygon poly;
+                uint32_t count = u32();
+                if (count > remaining() / (3 * sizeof(double))) {
+                    throw std::runtime_error("Truncated binary record");
+                }
+                poly.vertices.reserve(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    poly.vertices.push_back(point());
+                }
+                return poly;
+            }
+
+            inline dp::Geo geo() {
+                dp::Geo g;
+                g.latitude = f64();
+                g.longitude = f64();
+                g.altitude = f64();
+                return g;
+            }
+
+            template <typename T> inline dp::Grid<T> grid() {
+                dp::Grid<T> g;
+                g.rows = static_cast<size_t>(u64());
+                g.cols = static_cast<size_t>(u64());
+                g.resolution = f64();
+                g.centered = boolean();
+                g.pose = pod<dp::Pose>();
+                uint64_t count = u64();
+                if (count > remaining() / sizeof(T)) {
+                    throw std::runtime_error("Truncated binary record");
+                }
+                if (count != static_cast<uint64_t>(g.rows) * g.cols) {
+                    throw std::runtime_error("Corrupt grid record: cell count does not match dimensions");
+                }
+                g.data.resize(count);
+                bytes(g.data.data(), count * sizeof(T));
+                return g;
+            }
+        };
+
+    } // namespace binary
+} // namespace zoneout
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Hardware CRC32C: SSE4.2 on x86-64 (selected at runtime unless the build already targets it), the ARMv8 CRC
+// extension on AArch64 when the compiler targets it. ZONEOUT_SIMD_DISABLED forces the portable path.
+#if !defined(ZONEOUT_SIMD_DISABLED) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ZONEOUT_CRC32C_SSE42 1
+#include <nmmintrin.h>
+#elif !defined(ZONEOUT_SIMD_DISABLED) && defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define ZONEOUT_CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+namespace zoneout {
+
+    namespace checksum_detail {
+
+        // Castagnoli polynomial (reflected), as used by iSCSI/ext4 and SSE4.2/ARMv8 CRC instructions
+        inline constexpr uint32_t crc32c_poly = 0x82F63B78u;
+
+        using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+        // tables[0] is the classic byte table; tables[k] advances a byte k positions further (slicing-by-8)
+        inline constexpr Crc32cTables make_crc32c_tables() {
+            Crc32cTables tables{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (int k = 0; k < 8; ++k) {
+                    crc = (crc & 1) ? (crc >> 1) ^ crc32c_poly : crc >> 1;
+                }
+                tables[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                for (size_t k = 1; k < 8; ++k) {
+                    tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+                }
+            }
+            return tables;
+        }
+
+        inline constexpr Crc32cTables crc32c_tables = make_crc32c_tables();
+
+        /// Portable slicing-by-8 update of an already-inverted running CRC
+        inline uint32_t crc32c_software(uint32_t crc, const uint8_t *p, size_t size) {
+            const auto &t = crc32c_tables;
+            while (size >= 8) {
+                uint32_t lo, hi;
+                std::memcpy(&lo, p, 4);
+                std::memcpy(&hi, p + 4, 4);
+                lo ^= crc; // little-endian targets only, as everywhere else in zoneout
+                crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+                      t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+                p += 8;
+                size -= 8;
+            }
+            while (size-- > 0) {
+                crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+#if defined(ZONEOUT_CRC32C_SSE42)
+        __attribute__((target("sse4.2"))) inline uint32_t crc32c_hardware(uint32_t crc, const uint8_t *p,
+                                                                           size_t size) {
+            uint64_t crc64 = crc;
+            while (size >= 8) {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                crc64 = _mm_crc32_u64(crc64, v);
+                p += 8;
+                size -= 8;
+            }
+            crc = static_cast<uint32_t>(crc64);
+            while (size-- > 0) {
+                crc = _mm_crc32_u8(crc, *p++);
+            }
+            return crc;
+        }
+
+        inline bool hardware_available() {
+#if defined(__SSE4_2__)
+            return true;
+#else
+            static const bool available = __builtin_cpu_supports("sse4.2");
+            return available;
+#endif
+        }
+#elif defined(ZONEOUT_CRC32C_ARMV8)
+        inline uint32_t crc32c_hardware(uint32_t crc, const uint8_t *p, size_t size) {
+            while (size >= 8) {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                crc = __crc32cd(crc, v);
+                p += 8;
+                size -= 8;
+            }
+            while (size-- > 0) {
+                crc = __crc32cb(crc, *p++);
+            }
+            return crc;
+        }
+
+        inline bool hardware_available() { return true; }
+#else
+        inline uint32_t crc32c_hardware(uint32_t crc, const uint8_t *p, size_t size) {
+            return crc32c_software(crc, p, size);
+        }
+
+        inline bool hardware_available() { return false; }
+#endif
+
+    } // namespace checksum_detail
+
+    /// "sse4.2", "armv8-crc" or "software": the CRC32C implementation crc32c() uses on this machine
+    inline const char *crc32c_backend() {
+        if (!checksum_detail::hardware_available())
+            return "software";
+#if defined(ZONEOUT_CRC32C_ARMV8)
+        return "armv8-crc";
+#else
+        return "sse4.2";
+#endif
+    }
+
+    /// Incremental CRC32C. Pass the previous result as `crc` to continue a running checksum.
+    inline uint32_t crc32c(const void *data, size_t size, uint32_t crc = 0) {
+        const auto *p = static_cast<const uint8_t *>(data);
+        if (checksum_detail::hardware_available()) {
+            return ~checksum_detail::crc32c_hardware(~crc, p, size);
+        }
+        return ~checksum_detail::crc32c_software(~crc, p, size);
+    }
+
+    inline uint32_t crc32c(std::string_view data, uint32_t crc = 0) { return crc32c(data.data(), data.size(), crc); }
+
+    /// 64-bit FNV-1a, for cheap change detection of small payloads (not collision resistant)
+    inline uint64_t fnv1a64(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+        const auto *p = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ p[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    inline uint64_t fnv1a64(std::string_view data) { return fnv1a64(data.data(), data.size()); }
+
+} // namespace zoneout
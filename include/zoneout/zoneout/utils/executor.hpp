@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zoneout {
+
+    /**
+     * @brief Where zoneout runs its parallel work
+     *
+     * Every parallel path in the library (plot loading, builders, batched file I/O, ISOXML export, time-log
+     * import) submits to one executor instead of spawning threads, so an application can bound zoneout's
+     * footprint in one place: executor::set_concurrency(2) on a robot sharing cores with perception, or 64 on a
+     * server. Applications with their own scheduler implement this interface and install it with
+     * executor::set_default().
+     */
+    class Executor {
+      public:
+        virtual ~Executor() = default;
+
+        /// Upper bound on tasks this executor runs at once; zoneout never splits work wider than this
+        virtual size_t concurrency() const = 0;
+
+        /// Run `task` eventually, on any thread. Tasks do not throw.
+        virtual void submit(std::function<void()> task) = 0;
+    };
+
+    /// Runs every task on the submitting thread: no parallelism at all (useful for tests and tiny targets)
+    class InlineExecutor final : public Executor {
+      public:
+        inline size_t concurrency() const override { return 1; }
+        inline void submit(std::function<void()> task) override { task(); }
+    };
+
+    /**
+     * @brief Work-stealing thread pool, the default executor
+     *
+     * Each worker owns a deque. Tasks submitted from a worker go onto its own deque and are taken back LIFO (the
+     * nested, cache-warm case); tasks from outside are dealt round-robin. An idle worker steals FIFO from the
+     * others before sleeping. The destructor runs whatever is still queued, then joins.
+     */
+    class ThreadPool final : public Executor {
+      private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        // Shared with the workers, so a pool released from one of its own tasks outlives that task
+        struct State {
+            std::vector<std::unique_ptr<Queue>> queues;
+            std::mutex mutex;
+            std::condition_variable wake;
+            size_t pending = 0;
+            bool stopping = false;
+            std::atomic<size_t> next_queue{0};
+
+            inline bool try_pop(size_t self, std::function<void()> &task) {
+                {
+                    auto &own = *queues[self];
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.tasks.empty()) {
+                        task = std::move(own.tasks.back());
+                        own.tasks.pop_back();
+                        return true;
+                    }
+                }
+                for (size_t k = 1; k < queues.size(); ++k) {
+                    auto &victim = *queues[(self + k) % queues.size()];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.tasks.empty()) {
+                        task = std::move(victim.tasks.front());
+                        victim.tasks.pop_front();
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        struct Current {
+            const State *state = nullptr;
+            size_t index = 0;
+        };
+
+        inline static Current &current() {
+            static thread_local Current worker;
+            return worker;
+        }
+
+        inline static void work(std::shared_ptr<State> state, size_t self) {
+            current() = Current{state.get(), self};
+            std::function<void()> task;
+            while (true) {
+                if (state->try_pop(self, task)) {
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        --state->pending;
+                    }
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(state->mutex);
+                // pending is raised before the push, so a worker may briefly see work it cannot pop yet
+                state->wake.wait(lock, [&] { return state->stopping || state->pending > 0; });
+                if (state->stopping && state->pending == 0)
+                    return;
+            }
+        }
+
+        std::shared_ptr<State> state_;
+        std::vector<std::thread> workers_;
+
+      public:
+        /// `threads` workers; 0 uses one per hardware thread
+        inline explicit ThreadPool(size_t threads = 0) : state_(std::make_shared<State>()) {
+            if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            state_->queues.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                state_->queues.push_back(std::make_unique<Queue>());
+            }
+            workers_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                workers_.emplace_back(work, state_, i);
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        inline ~ThreadPool() override {
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                state_->stopping = true;
+            }
+            state_->wake.notify_all();
+            for (auto &worker : workers_) {
+                if (worker.get_id() == std::this_thread::get_id())
+                    worker.detach(); // destroyed from one of our tasks: that worker drains and exits on its own
+                else
+                    worker.join();
+            }
+        }
+
+        inline size_t concurrency() const override { return workers_.size(); }
+
+        inline void submit(std::function<void()> task) override {
+            const auto &self = current();
+            const size_t index =
+                self.state == state_.get() ? self.index : state_->next_queue++ % state_->queues.size();
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                ++state_->pending;
+            }
+            {
+                auto &queue = *state_->queues[index];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            state_->wake.notify_one();
+        }
+    };
+
+    namespace executor {
+
+        namespace detail {
+
+            struct Slot {
+                std::mutex mutex;
+                std::shared_ptr<Executor> executor;
+            };
+
+            inline Slot &slot() {
+                static Slot instance;
+                return instance;
+            }
+
+            /// ZONEOUT_THREADS from the environment, or 0 (one per hardware thread)
+            inline size_t environment_threads() {
+                const char *value = std::getenv("ZONEOUT_THREADS");
+                if (value == nullptr)
+                    return 0;
+                try {
+                    return static_cast<size_t>(std::max(0L, std::stol(value)));
+                } catch (const std::exception &) {
+                    return 0;
+                }
+            }
+
+        } // namespace detail
+
+        /**
+         * @brief The executor every parallel zoneout API uses
+         *
+         * Created on first use as a ThreadPool sized by the ZONEOUT_THREADS environment variable (one worker per
+         * hardware thread when unset or 0). Callers hold the returned pointer for the duration of their work, so
+         * replacing the default mid-flight is safe.
+         */
+        inline std::shared_ptr<Executor> get_default() {
+            auto &slot = detail::slot();
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (!slot.executor) {
+                slot.executor = std::make_shared<ThreadPool>(detail::environment_threads());
+            }
+            return slot.executor;
+        }
+
+        /// Install a user-supplied executor; nullptr restores the built-in pool on next use
+        inline void set_default(std::shared_ptr<Executor> executor) {
+            auto &slot = detail::slot();
+            std::shared_ptr<Executor> previous;
+            {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                previous = std::exchange(slot.executor, std::move(executor));
+            }
+            // `previous` (possibly the last owner of a pool) is released outside the lock
+        }
+
+        /// Replace the default with a work-stealing pool of `threads` workers (0 = one per hardware thread)
+        inline void set_concurrency(size_t threads) { set_default(std::make_shared<ThreadPool>(threads)); }
+
+        inline size_t concurrency() { return get_default()->concurrency(); }
+
+    } // namespace executor
+
+} // namespace zoneout
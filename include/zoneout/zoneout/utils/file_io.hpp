@@ -0,0 +1,543 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "async.hpp"
+
+// Linux io_uring through the raw syscalls (kernel headers only, no liburing). ZONEOUT_IO_URING_DISABLED turns it
+// off at compile time; kernels or sandboxes that refuse io_uring_setup, or lack one of the opcodes used here, fall
+// back to the executor at runtime.
+#if defined(__linux__) && !defined(ZONEOUT_IO_URING_DISABLED) && __has_include(<linux/io_uring.h>)
+#define ZONEOUT_HAS_IO_URING 1
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace zoneout {
+
+    /**
+     * @brief Batched whole-file reads and writes for the persistence layer
+     *
+     * Plot persistence touches many small files (two per zone plus the manifest). Instead of an open/read/close
+     * round trip per file, read() / write() / create_directories() take the whole batch: on Linux the operations
+     * go through one io_uring, each phase (open, read or write, close) submitted `queue_depth` at a time, so a
+     * batch of N files costs about 3N / queue_depth syscalls. Elsewhere, or when io_uring is unavailable, the
+     * files are spread over the executor's workers using ordinary streams. Errors are reported per file, never thrown.
+     */
+    namespace fileio {
+
+        enum class Backend : uint8_t {
+            Auto,    // io_uring when the kernel allows it, otherwise Threads
+            IoUring, // io_uring or std::runtime_error
+            Threads,
+        };
+
+        struct Options {
+            Backend backend = Backend::Auto;
+            unsigned queue_depth = 128;     // io_uring submission queue entries
+            size_t threads = 0;             // executor workers for the fallback; 0 uses all
+            size_t batch_files = 256;       // how many files callers hold in memory per batch
+            size_t batch_bytes = 64u << 20; // and how many bytes; larger files are streamed one at a time
+        };
+
+        struct File {
+            std::filesystem::path path;
+            std::string data; // filled by read(), consumed by write()
+            int error = 0;    // errno value of the first failed step, 0 on success
+
+            inline bool ok() const { return error == 0; }
+            inline std::string message() const { return path.string() + ": " + std::strerror(error); }
+        };
+
+        namespace detail {
+
+            inline int stream_error(const std::filesystem::path &path) {
+                std::error_code ec;
+                return std::filesystem::exists(path, ec) ? EIO : ENOENT;
+            }
+
+            inline void read_with_streams(File &file) {
+                std::ifstream in(file.path, std::ios::binary | std::ios::ate);
+                if (!in) {
+                    file.error = stream_error(file.path);
+                    return;
+                }
+                file.data.resize(static_cast<size_t>(in.tellg()));
+                in.seekg(0);
+                if (!in.read(file.data.data(), static_cast<std::streamsize>(file.data.size()))) {
+                    file.error = EIO;
+                }
+            }
+
+            inline void write_with_streams(File &file) {
+                std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    file.error = file.path.has_parent_path() && !std::filesystem::exists(file.path.parent_path())
+                                     ? ENOENT
+                                     : EACCES;
+                    return;
+                }
+                if (!out.write(file.data.data(), static_cast<std::streamsize>(file.data.size())) || !out.flush()) {
+                    file.error = EIO;
+                }
+            }
+
+#if defined(ZONEOUT_HAS_IO_URING)
+            /// Minimal io_uring: one submission/completion ring pair, filled and drained in waves
+            class Ring {
+              private:
+                int fd_ = -1;
+                unsigned entries_ = 0;
+                unsigned unsubmitted_ = 0;
+
+                void *sq_ring_ = MAP_FAILED;
+                void *cq_ring_ = MAP_FAILED;
+                size_t sq_ring_size_ = 0;
+                size_t cq_ring_size_ = 0;
+                io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+                size_t sqes_size_ = 0;
+
+                unsigned *sq_tail_ = nullptr;
+                unsigned *sq_mask_ = nullptr;
+                unsigned *sq_array_ = nullptr;
+                unsigned *cq_head_ = nullptr;
+                unsigned *cq_tail_ = nullptr;
+                unsigned *cq_mask_ = nullptr;
+                io_uring_cqe *cqes_ = nullptr;
+
+                template <typename T> static inline T *at(void *base, uint32_t offset) {
+                    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+                }
+
+                inline void enter(unsigned min_complete) {
+                    unsigned submit = unsubmitted_;
+                    while (true) {
+                        long ret = ::syscall(__NR_io_uring_enter, fd_, submit, min_complete, IORING_ENTER_GETEVENTS,
+                                             nullptr, 0);
+                        if (ret >= 0) {
+                            unsubmitted_ -= static_cast<unsigned>(ret);
+                            return;
+                        }
+                        if (errno == EBUSY && submit != 0) {
+                            // Completion queue full: submit nothing and return without waiting, so the caller
+                            // reaps (this call also flushes overflowed CQEs) and resubmits on its next round
+                            submit = 0;
+                            min_complete = 0;
+                        } else if (errno != EINTR && errno != EAGAIN) {
+                            throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+                        }
+                    }
+                }
+
+              public:
+                inline explicit Ring(unsigned entries) {
+                    io_uring_params params{};
+                    fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                    if (fd_ < 0) {
+                        throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+                    }
+                    entries_ = params.sq_entries;
+
+                    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+                    if (single) {
+                        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+                    }
+                    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                      IORING_OFF_SQ_RING);
+                    cq_ring_ = single ? sq_ring_
+                                      : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+                    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+                    sqes_ = static_cast<io_uring_sqe *>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                               MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+                    if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+                        int error = errno;
+                        release();
+                        throw std::system_error(error, std::generic_category(), "io_uring mmap");
+                    }
+
+                    sq_tail_ = at<unsigned>(sq_ring_, params.sq_off.tail);
+                    sq_mask_ = at<unsigned>(sq_ring_, params.sq_off.ring_mask);
+                    sq_array_ = at<unsigned>(sq_ring_, params.sq_off.array);
+                    cq_head_ = at<unsigned>(cq_ring_, params.cq_off.head);
+                    cq_tail_ = at<unsigned>(cq_ring_, params.cq_off.tail);
+                    cq_mask_ = at<unsigned>(cq_ring_, params.cq_off.ring_mask);
+                    cqes_ = at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+                }
+
+                Ring(const Ring &) = delete;
+                Ring &operator=(const Ring &) = delete;
+
+                inline ~Ring() { release(); }
+
+                inline void release() {
+                    if (sqes_ != MAP_FAILED)
+                        ::munmap(sqes_, sqes_size_);
+                    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+                        ::munmap(cq_ring_, cq_ring_size_);
+                    if (sq_ring_ != MAP_FAILED)
+                        ::munmap(sq_ring_, sq_ring_size_);
+                    if (fd_ >= 0)
+                        ::close(fd_);
+                    sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+                    sq_ring_ = cq_ring_ = MAP_FAILED;
+                    fd_ = -1;
+                }
+
+                /// True when the kernel implements every opcode in `opcodes` (IORING_REGISTER_PROBE, Linux 5.6+)
+                inline bool supports(std::initializer_list<uint8_t> opcodes) const {
+                    constexpr unsigned slots = 256;
+                    std::vector<uint64_t> buffer(
+                        (sizeof(io_uring_probe) + slots * sizeof(io_uring_probe_op) + sizeof(uint64_t) - 1) /
+                        sizeof(uint64_t));
+                    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+                    if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, slots) < 0) {
+                        return false;
+                    }
+                    return std::all_of(opcodes.begin(), opcodes.end(), [&](uint8_t op) {
+                        return op <= probe->last_op && op < probe->ops_len &&
+                               (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+                    });
+                }
+
+                /**
+                 * @brief Run one operation per index in [0, count)
+                 *
+                 * prep(i, sqe) fills a zeroed SQE (return false to skip index i); done(i, res) receives the
+                 * completion result (negative errno on failure). At most `entries` operations are in flight.
+                 */
+                template <typename Prep, typename Done> inline void run(size_t count, Prep &&prep, Done &&done) {
+                    size_t next = 0, inflight = 0;
+                    while (next < count || inflight > 0) {
+                        unsigned tail = *sq_tail_;
+                        while (next < count && inflight < entries_) {
+                            const size_t i = next++;
+                            auto &sqe = sqes_[tail & *sq_mask_];
+                            std::memset(&sqe, 0, sizeof(sqe));
+                            if (!prep(i, sqe)) {
+                                continue;
+                            }
+                            sqe.user_data = i;
+                            sq_array_[tail & *sq_mask_] = tail & *sq_mask_;
+                            ++tail;
+                            ++inflight;
+                            ++unsubmitted_;
+                        }
+                        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+                        if (inflight == 0) {
+                            break;
+                        }
+
+                        enter(1);
+                        unsigned head = *cq_head_;
+                        const unsigned ready = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                        for (; head != ready; ++head) {
+                            const auto &cqe = cqes_[head & *cq_mask_];
+                            done(static_cast<size_t>(cqe.user_data), cqe.res);
+                            --inflight;
+                        }
+                        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+                    }
+                }
+            };
+
+            inline void prep_path(io_uring_sqe &sqe, uint8_t opcode, const std::string &path) {
+                sqe.opcode = opcode;
+                sqe.fd = AT_FDCWD;
+                sqe.addr = reinterpret_cast<uint64_t>(path.c_str());
+            }
+
+            inline void prep_rw(io_uring_sqe &sqe, uint8_t opcode, int fd, const void *buffer, size_t size,
+                                uint64_t offset) {
+                sqe.opcode = opcode;
+                sqe.fd = fd;
+                sqe.addr = reinterpret_cast<uint64_t>(buffer);
+                sqe.len = static_cast<uint32_t>(std::min<size_t>(size, 1u << 30));
+                sqe.off = offset;
+            }
+
+            /// Open, then read or write until every file is complete (short transfers are resubmitted), then close
+            inline void transfer(Ring &ring, std::span<File> files, bool writing) {
+                const size_t n = files.size();
+                std::vector<std::string> paths(n);
+                std::vector<int> fds(n, -1);
+                std::vector<uint64_t> done_bytes(n, 0);
+                std::vector<struct statx> stats(writing ? 0 : n);
+                for (size_t i = 0; i < n; ++i) {
+                    paths[i] = files[i].path.string();
+                    files[i].error = 0;
+                }
+
+                // Phase 1: open (plus statx for the size when reading), two SQEs per file when reading
+                const size_t per_file = writing ? 1 : 2;
+                ring.run(
+                    n * per_file,
+                    [&](size_t op, io_uring_sqe &sqe) {
+                        const size_t i = op / per_file;
+                        if (op % per_file == 0) {
+                            prep_path(sqe, IORING_OP_OPENAT, paths[i]);
+                            sqe.open_flags =
+                                writing ? (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC);
+                            sqe.len = writing ? 0644 : 0;
+                        } else {
+                            prep_path(sqe, IORING_OP_STATX, paths[i]);
+                            sqe.len = STATX_SIZE;
+                            sqe.off = reinterpret_cast<uint64_t>(&stats[i]);
+                        }
+                        return true;
+                    },
+                    [&](size_t op, int res) {
+                        const size_t i = op / per_file;
+                        if (res < 0) {
+                            if (files[i].error == 0)
+                                files[i].error = -res;
+                        } else if (op % per_file == 0) {
+                            fds[i] = res;
+                        }
+                    });
+                if (!writing) {
+                    for (size_t i = 0; i < n; ++i) {
+                        if (files[i].ok())
+                            files[i].data.resize(static_cast<size_t>(stats[i].stx_size));
+                    }
+                }
+
+                // Phase 2: data, repeated for the rare short transfer
+                auto pending = [&](size_t i) {
+                    return fds[i] >= 0 && files[i].ok() && done_bytes[i] < files[i].data.size();
+                };
+                while (true) {
+                    std::vector<size_t> open;
+                    for (size_t i = 0; i < n; ++i) {
+                        if (pending(i))
+                            open.push_back(i);
+                    }
+                    if (open.empty()) {
+                        break;
+                    }
+                    ring.run(
+                        open.size(),
+                        [&](size_t k, io_uring_sqe &sqe) {
+                            const size_t i = open[k];
+                            auto *buffer = files[i].data.data() + done_bytes[i];
+                            prep_rw(sqe, writing ? IORING_OP_WRITE : IORING_OP_READ, fds[i], buffer,
+                                    files[i].data.size() - done_bytes[i], done_bytes[i]);
+                            return true;
+                        },
+                        [&](size_t k, int res) {
+                            const size_t i = open[k];
+                            if (res < 0) {
+                                files[i].error = -res;
+                            } else if (res == 0 && writing) {
+                                // A write that makes no progress would otherwise be resubmitted forever
+                                files[i].error = EIO;
+                            } else if (res == 0) {
+                                // File shrank since statx: keep what was read
+                                files[i].data.resize(done_bytes[i]);
+                            } else {
+                                done_bytes[i] += static_cast<uint64_t>(res);
+                            }
+                        });
+                }
+
+                // Phase 3: close
+                ring.run(
+                    n,
+                    [&](size_t i, io_uring_sqe &sqe) {
+                        if (fds[i] < 0)
+                            return false;
+                        sqe.opcode = IORING_OP_CLOSE;
+                        sqe.fd = fds[i];
+                        return true;
+                    },
+                    [&](size_t i, int res) {
+                        if (res < 0 && files[i].ok())
+                            files[i].error = -res;
+                    });
+            }
+#endif
+
+            inline bool use_io_uring(const Options &options) {
+#if defined(ZONEOUT_HAS_IO_URING)
+                if (options.backend == Backend::Threads)
+                    return false;
+                // Setup alone is not enough: seccomp filters and older kernels can allow the ring but not the
+                // opcodes transfer() needs, so probe for each of them
+                static const bool available = [] {
+                    try {
+                        Ring probe(2);
+                        return probe.supports(
+                            {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE});
+                    } catch (const std::system_error &) {
+                        return false;
+                    }
+                }();
+                if (options.backend == Backend::IoUring && !available) {
+                    throw std::runtime_error("io_uring is unavailable or lacks the required opcodes");
+                }
+                return available;
+#else
+                if (options.backend == Backend::IoUring) {
+                    throw std::runtime_error("io_uring backend is not available on this platform");
+                }
+                return false;
+#endif
+            }
+
+        } // namespace detail
+
+        /// The backend `options` resolves to on this machine (Auto resolved)
+        inline Backend backend(const Options &options = {}) {
+            return detail::use_io_uring(options) ? Backend::IoUring : Backend::Threads;
+        }
+
+        inline const char *backend_name(Backend backend) {
+            switch (backend) {
+            case Backend::IoUring:
+                return "io_uring";
+            case Backend::Threads:
+                return "threads";
+            default:
+                return "auto";
+            }
+        }
+
+        /// Read every file whole into File::data
+        inline void read(std::span<File> files, const Options &options = {}) {
+            if (files.empty())
+                return;
+#if defined(ZONEOUT_HAS_IO_URING)
+            if (detail::use_io_uring(options)) {
+                detail::Ring ring(std::max(2u, options.queue_depth));
+                detail::transfer(ring, files, false);
+                return;
+            }
+#endif
+            async::run(files.size(), options.threads, {}, "File read", [&](size_t i) {
+                files[i].error = 0;
+                detail::read_with_streams(files[i]);
+            });
+        }
+
+        /// Create or truncate every file and write File::data; parent directories must exist
+        inline void write(std::span<File> files, const Options &options = {}) {
+            if (files.empty())
+                return;
+#if defined(ZONEOUT_HAS_IO_URING)
+            if (detail::use_io_uring(options)) {
+                detail::Ring ring(std::max(2u, options.queue_depth));
+                detail::transfer(ring, files, true);
+                return;
+            }
+#endif
+            async::run(files.size(), options.threads, {}, "File write", [&](size_t i) {
+                files[i].error = 0;
+                detail::write_with_streams(files[i]);
+            });
+        }
+
+        /**
+         * @brief Create a batch of sibling-level directories (e.g. every zone_N of a plot)
+         *
+         * Parents are created with std::filesystem first (once per distinct parent); the leaves go through
+         * io_uring's mkdirat when available. Existing directories are fine; any other failure throws.
+         */
+        inline void create_directories(std::span<const std::filesystem::path> directories,
+                                       const Options &options = {}) {
+            std::vector<std::filesystem::path> parents;
+            for (const auto &dir : directories) {
+                auto parent = dir.parent_path();
+                if (!parent.empty() && (parents.empty() || parents.back() != parent)) {
+                    parents.push_back(parent);
+                }
+            }
+            std::sort(parents.begin(), parents.end());
+            parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+            for (const auto &parent : parents) {
+                std::filesystem::create_directories(parent);
+            }
+
+            std::vector<int> errors(directories.size(), 0);
+#if defined(ZONEOUT_HAS_IO_URING)
+            if (detail::use_io_uring(options)) {
+                std::vector<std::string> paths(directories.size());
+                for (size_t i = 0; i < directories.size(); ++i) {
+                    paths[i] = directories[i].string();
+                }
+                detail::Ring ring(std::max(2u, options.queue_depth));
+                ring.run(
+                    paths.size(),
+                    [&](size_t i, io_uring_sqe &sqe) {
+                        detail::prep_path(sqe, IORING_OP_MKDIRAT, paths[i]);
+                        sqe.len = 0755;
+                        return true;
+                    },
+                    [&](size_t i, int res) { errors[i] = res < 0 && res != -EEXIST ? -res : 0; });
+            } else
+#endif
+            {
+                for (size_t i = 0; i < directories.size(); ++i) {
+                    errors[i] = -1;
+                }
+            }
+
+            for (size_t i = 0; i < directories.size(); ++i) {
+                // -1: no io_uring; EINVAL: kernel without IORING_OP_MKDIRAT (< 5.15)
+                if (errors[i] == -1 || errors[i] == EINVAL) {
+                    std::filesystem::create_directories(directories[i]);
+                } else if (errors[i] != 0) {
+                    throw std::system_error(errors[i], std::generic_category(),
+                                            "Could not create " + directories[i].string());
+                }
+            }
+        }
+
+        /// Directory for short-lived staging files: RAM-backed /dev/shm on Linux when writable, else the temp dir
+        inline std::filesystem::path scratch_directory() {
+#if defined(__linux__)
+            std::error_code ec;
+            if (std::filesystem::is_directory("/dev/shm", ec) && ::access("/dev/shm", W_OK) == 0) {
+                return "/dev/shm";
+            }
+#endif
+            return std::filesystem::temp_directory_path();
+        }
+
+        /// fsync a file or directory by path (a directory fsync persists its entries, e.g. after a rename)
+        inline void sync_path(const std::filesystem::path &path) {
+#if defined(__unix__) || defined(__APPLE__)
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0 || ::fsync(fd) != 0) {
+                if (fd >= 0)
+                    ::close(fd);
+                throw std::runtime_error("Could not sync to disk: " + path.string());
+            }
+            ::close(fd);
+#else
+            (void)path;
+#endif
+        }
+
+    } // namespace fileio
+
+} // namespace zoneout
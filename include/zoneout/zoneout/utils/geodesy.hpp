@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <datapod/datapod.hpp>
+
+namespace dp = datapod;
+
+namespace zoneout {
+
+    /**
+     * @brief Batched ENU <-> WGS84 conversion around a fixed datum
+     *
+     * The datum's ECEF position and rotation terms are computed once, so converting a point costs one rotation and a
+     * closed-form (Olson) ECEF-to-geodetic step instead of a fresh frame setup per vertex. The span overloads run
+     * the rotation as a separate pass over plain arrays so the compiler can vectorize it.
+     */
+    class LocalFrame {
+      public:
+        static constexpr double a = 6378137.0;
+        static constexpr double f = 1.0 / 298.257223563;
+        static constexpr double b = a * (1.0 - f);
+        static constexpr double e2 = f * (2.0 - f);
+        static constexpr double ep2 = e2 / (1.0 - e2);
+
+        inline explicit LocalFrame(const dp::Geo &datum) : datum_(datum) {
+            constexpr double deg = M_PI / 180.0;
+            const double lat = datum.latitude * deg;
+            const double lon = datum.longitude * deg;
+            sin_lat_ = std::sin(lat);
+            cos_lat_ = std::cos(lat);
+            sin_lon_ = std::sin(lon);
+            cos_lon_ = std::cos(lon);
+            const double n = a / std::sqrt(1.0 - e2 * sin_lat_ * sin_lat_);
+            x0_ = (n + datum.altitude) * cos_lat_ * cos_lon_;
+            y0_ = (n + datum.altitude) * cos_lat_ * sin_lon_;
+            z0_ = (n * (1.0 - e2) + datum.altitude) * sin_lat_;
+        }
+
+        inline const dp::Geo &datum() const { return datum_; }
+
+        inline dp::Geo to_wgs(const dp::Point &enu) const {
+            double x, y, z;
+            to_ecef(enu.x, enu.y, enu.z, x, y, z);
+            return ecef_to_geodetic(x, y, z);
+        }
+
+        inline dp::Point to_enu(const dp::Geo &wgs) const {
+            constexpr double deg = M_PI / 180.0;
+            const double lat = wgs.latitude * deg;
+            const double lon = wgs.longitude * deg;
+            const double sl = std::sin(lat), cl = std::cos(lat);
+            const double n = a / std::sqrt(1.0 - e2 * sl * sl);
+            const double dx = (n + wgs.altitude) * cl * std::cos(lon) - x0_;
+            const double dy = (n + wgs.altitude) * cl * std::sin(lon) - y0_;
+            const double dz = (n * (1.0 - e2) + wgs.altitude) * sl - z0_;
+            return dp::Point{-sin_lon_ * dx + cos_lon_ * dy,
+                             -sin_lat_ * cos_lon_ * dx - sin_lat_ * sin_lon_ * dy + cos_lat_ * dz,
+                             cos_lat_ * cos_lon_ * dx + cos_lat_ * sin_lon_ * dy + sin_lat_ * dz};
+        }
+
+        /// Convert `enu` into `out`; the spans must be the same length
+        inline void to_wgs(std::span<const dp::Point> enu, std::span<dp::Geo> out) const {
+            if (enu.size() != out.size()) {
+                throw std::invalid_argument("LocalFrame::to_wgs: output span has " + std::to_string(out.size()) +
+                                            " entries, expected " + std::to_string(enu.size()));
+            }
+            constexpr size_t block = 256;
+            double xs[block], ys[block], zs[block];
+            for (size_t start = 0; start < enu.size(); start += block) {
+                const size_t count = std::min(block, enu.size() - start);
+                for (size_t i = 0; i < count; ++i)
+                    to_ecef(enu[start + i].x, enu[start + i].y, enu[start + i].z, xs[i], ys[i], zs[i]);
+                for (size_t i = 0; i < count; ++i)
+                    out[start + i] = ecef_to_geodetic(xs[i], ys[i], zs[i]);
+            }
+        }
+
+        inline std::vector<dp::Geo> to_wgs(std::span<const dp::Point> enu) const {
+            std::vector<dp::Geo> out(enu.size());
+            to_wgs(enu, std::span<dp::Geo>(out));
+            return out;
+        }
+
+        /// Convert `wgs` into `out`; the spans must be the same length
+        inline void to_enu(std::span<const dp::Geo> wgs, std::span<dp::Point> out) const {
+            if (wgs.size() != out.size()) {
+                throw std::invalid_argument("LocalFrame::to_enu: output span has " + std::to_string(out.size()) +
+                                            " entries, expected " + std::to_string(wgs.size()));
+            }
+            for (size_t i = 0; i < wgs.size(); ++i)
+                out[i] = to_enu(wgs[i]);
+        }
+
+        inline std::vector<dp::Point> to_enu(std::span<const dp::Geo> wgs) const {
+            std::vector<dp::Point> out(wgs.size());
+            to_enu(wgs, std::span<dp::Point>(out));
+            return out;
+        }
+
+      private:
+        dp::Geo datum_;
+        double sin_lat_, cos_lat_, sin_lon_, cos_lon_;
+        double x0_, y0_, z0_;
+
+        inline void to_ecef(double e, double n, double u, double &x, double &y, double &z) const {
+            x = x0_ - sin_lon_ * e - sin_lat_ * cos_lon_ * n + cos_lat_ * cos_lon_ * u;
+            y = y0_ + cos_lon_ * e - sin_lat_ * sin_lon_ * n + cos_lat_ * sin_lon_ * u;
+            z = z0_ + cos_lat_ * n + sin_lat_ * u;
+        }
+
+        // Olson (1996): non-iterative, one correction step; nanometre-level for terrestrial heights
+        inline static dp::Geo ecef_to_geodetic(double x, double y, double z) {
+            constexpr double rad = 180.0 / M_PI;
+            constexpr double a1 = a * e2;
+            constexpr double a2 = a1 * a1;
+            constexpr double a3 = a1 * e2 / 2.0;
+            constexpr double a4 = 2.5 * a2;
+            constexpr double a5 = a1 + a3;
+            constexpr double a6 = 1.0 - e2;
+
+            const double zp = std::abs(z);
+            const double w2 = x * x + y * y;
+            const double w = std::sqrt(w2);
+            const double r2 = w2 + z * z;
+            const double r = std::sqrt(r2);
+            const double s2 = z * z / r2;
+            const double c2 = w2 / r2;
+            double u = a2 / r;
+            double v = a3 - a4 / r;
+
+            double s, c, ss, lat;
+            if (c2 > 0.3) {
+                s = (zp / r) * (1.0 + c2 * (a1 + u + s2 * v) / r);
+                lat = std::asin(s);
+                ss = s * s;
+                c = std::sqrt(1.0 - ss);
+            } else {
+                c = (w / r) * (1.0 - s2 * (a5 - u - c2 * v) / r);
+                lat = std::acos(c);
+                ss = 1.0 - c * c;
+                s = std::sqrt(ss);
+            }
+            const double g = 1.0 - e2 * ss;
+            const double rg = a / std::sqrt(g);
+            const double rf = a6 * rg;
+            u = w - rg * c;
+            v = zp - rf * s;
+            const double f0 = c * u + s * v;
+            const double m = c * v - s * u;
+            const double p = m / (rf / g + f0);
+            lat += p;
+
+            dp::Geo geo;
+            geo.latitude = (z < 0.0 ? -lat : lat) * rad;
+            geo.longitude = std::atan2(y, x) * rad;
+            geo.altitude = f0 + m * p / 2.0;
+            return geo;
+        }
+    };
+
+} // namespace zoneout
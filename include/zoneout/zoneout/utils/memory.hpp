@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace zoneout {
+
+    /**
+     * @brief Estimated heap footprint of a Zone (or a Plot's zones), by category
+     *
+     * Computed from container sizes/capacities without touching cell data, so it is cheap enough to poll.
+     * Figures are estimates: node overheads follow the usual libstdc++/libc++ layouts and allocator slack is
+     * ignored. feature_collection_bytes is the vectkit copy of the vector data, which duplicates the structured
+     * elements.
+     */
+    struct MemoryUsage {
+        std::vector<size_t> raster_layer_bytes; // cell data per layer, in layer order
+        size_t raster_bytes = 0;                // all layer cells plus per-layer metadata
+        size_t temporal_bytes = 0;              // time-series layers
+        size_t stats_bytes = 0;                 // incremental layer statistics
+        size_t element_geometry_bytes = 0;      // structured element geometry
+        size_t element_property_bytes = 0;      // element names/types and property maps
+        size_t property_bytes = 0;              // zone/plot properties and global metadata
+        size_t feature_collection_bytes = 0;    // vectkit features (geometry and property maps)
+        size_t object_bytes = 0;                // the objects themselves (sizeof)
+
+        inline size_t total() const {
+            return raster_bytes + temporal_bytes + stats_bytes + element_geometry_bytes + element_property_bytes +
+                   property_bytes + feature_collection_bytes + object_bytes;
+        }
+
+        /// Sum of categories; per-layer figures are appended
+        inline MemoryUsage &operator+=(const MemoryUsage &other) {
+            raster_layer_bytes.insert(raster_layer_bytes.end(), other.raster_layer_bytes.begin(),
+                                      other.raster_layer_bytes.end());
+            raster_bytes += other.raster_bytes;
+            temporal_bytes += other.temporal_bytes;
+            stats_bytes += other.stats_bytes;
+            element_geometry_bytes += other.element_geometry_bytes;
+            element_property_bytes += other.element_property_bytes;
+            property_bytes += other.property_bytes;
+            feature_collection_bytes += other.feature_collection_bytes;
+            object_bytes += other.object_bytes;
+            return *this;
+        }
+
+        inline std::string to_string() const {
+            std::ostringstream os;
+            os << "total=" << total() << " raster=" << raster_bytes << " (" << raster_layer_bytes.size()
+               << " layers) temporal=" << temporal_bytes << " stats=" << stats_bytes
+               << " element_geometry=" << element_geometry_bytes << " element_properties=" << element_property_bytes
+               << " properties=" << property_bytes << " features=" << feature_collection_bytes
+               << " objects=" << object_bytes;
+            return os.str();
+        }
+    };
+
+    namespace memory {
+
+        /// Heap bytes owned by a string (0 while it fits the small-string buffer)
+        template <typename Alloc>
+        inline size_t string_heap(const std::basic_string<char, std::char_traits<char>, Alloc> &s) {
+            const char *data = s.data();
+            const char *self = reinterpret_cast<const char *>(&s);
+            if (data >= self && data < self + sizeof(s))
+                return 0;
+            return s.capacity() + 1;
+        }
+
+        template <typename T> inline size_t vector_heap(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+
+        /// Heap bytes of a string map: bucket array, one node per entry (value, next pointer, cached hash), strings
+        template <typename Map> inline size_t map_heap(const Map &map) {
+            using Node = typename Map::value_type;
+            size_t bytes = map.bucket_count() * sizeof(void *);
+            bytes += map.size() * (sizeof(Node) + sizeof(void *) + sizeof(size_t));
+            for (const auto &[key, value] : map)
+                bytes += string_heap(key) + string_heap(value);
+            return bytes;
+        }
+
+    } // namespace memory
+
+} // namespace zoneout
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace zoneout {
+
+    /**
+     * @brief Hot-path instrumentation: named counters and scoped timers
+     *
+     * Recording goes through the ZONEOUT_METRIC_* macros, which compile to nothing unless ZONEOUT_METRICS is
+     * defined (CMake: -DZONEOUT_ENABLE_METRICS=ON), so instrumented library code costs nothing by default.
+     * With metrics on, each call site resolves its counter once (function-local static) and then only does a
+     * relaxed atomic add. collect() / dump() read everything recorded so far; reset() zeroes it.
+     */
+    namespace metrics {
+
+#ifdef ZONEOUT_METRICS
+        inline constexpr bool enabled = true;
+#else
+        inline constexpr bool enabled = false;
+#endif
+
+        class Counter {
+          private:
+            std::atomic<uint64_t> value_{0};
+
+          public:
+            inline void add(uint64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+            inline uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+            inline void reset() { value_.store(0, std::memory_order_relaxed); }
+        };
+
+        struct TimerStats {
+            uint64_t count = 0;
+            uint64_t total_ns = 0;
+            uint64_t min_ns = 0;
+            uint64_t max_ns = 0;
+
+            inline double mean_ns() const {
+                return count == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(count);
+            }
+        };
+
+        class Timer {
+          private:
+            std::atomic<uint64_t> count_{0};
+            std::atomic<uint64_t> total_ns_{0};
+            std::atomic<uint64_t> min_ns_{std::numeric_limits<uint64_t>::max()};
+            std::atomic<uint64_t> max_ns_{0};
+
+          public:
+            inline void record(uint64_t ns) {
+                count_.fetch_add(1, std::memory_order_relaxed);
+                total_ns_.fetch_add(ns, std::memory_order_relaxed);
+                uint64_t seen = min_ns_.load(std::memory_order_relaxed);
+                while (ns < seen && !min_ns_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+                }
+                seen = max_ns_.load(std::memory_order_relaxed);
+                while (ns > seen && !max_ns_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+                }
+            }
+
+            inline TimerStats stats() const {
+                TimerStats s;
+                s.count = count_.load(std::memory_order_relaxed);
+                s.total_ns = total_ns_.load(std::memory_order_relaxed);
+                s.min_ns = s.count == 0 ? 0 : min_ns_.load(std::memory_order_relaxed);
+                s.max_ns = max_ns_.load(std::memory_order_relaxed);
+                return s;
+            }
+
+            inline void reset() {
+                count_.store(0, std::memory_order_relaxed);
+                total_ns_.store(0, std::memory_order_relaxed);
+                min_ns_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+                max_ns_.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        /// Point-in-time copy of every metric, for telemetry export
+        struct Snapshot {
+            std::map<std::string, uint64_t> counters;
+            std::map<std::string, TimerStats> timers;
+        };
+
+        /// Process-wide metric registry; entries are created on first use and never move
+        class Registry {
+          private:
+            mutable std::mutex mutex_;
+            std::map<std::string, std::unique_ptr<Counter>> counters_;
+            std::map<std::string, std::unique_ptr<Timer>> timers_;
+
+          public:
+            inline Counter &counter(const std::string &name) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto &slot = counters_[name];
+                if (!slot)
+                    slot = std::make_unique<Counter>();
+                return *slot;
+            }
+
+            inline Timer &timer(const std::string &name) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto &slot = timers_[name];
+                if (!slot)
+                    slot = std::make_unique<Timer>();
+                return *slot;
+            }
+
+            inline Snapshot collect() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Snapshot snapshot;
+                for (const auto &[name, counter] : counters_)
+                    snapshot.counters[name] = counter->value();
+                for (const auto &[name, timer] : timers_)
+                    snapshot.timers[name] = timer->stats();
+                return snapshot;
+            }
+
+            inline void reset() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto &[name, counter] : counters_)
+                    counter->reset();
+                for (auto &[name, timer] : timers_)
+                    timer->reset();
+            }
+        };
+
+        inline Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        inline Snapshot collect() { return registry().collect(); }
+        inline void reset() { registry().reset(); }
+
+        /// Human-readable dump: one line per metric, timers in microseconds
+        inline void dump(std::ostream &os) {
+            auto snapshot = collect();
+            for (const auto &[name, value] : snapshot.counters) {
+                os << name << " = " << value << "\n";
+            }
+            for (const auto &[name, t] : snapshot.timers) {
+                os << name << ": count=" << t.count << " total=" << t.total_ns / 1000 << "us"
+                   << " mean=" << static_cast<uint64_t>(t.mean_ns() / 1000.0) << "us"
+                   << " min=" << t.min_ns / 1000 << "us max=" << t.max_ns / 1000 << "us\n";
+            }
+        }
+
+        /// Size of a written file for byte counters (0 if it cannot be read)
+        inline uint64_t file_bytes(const std::filesystem::path &path) {
+            std::error_code ec;
+            auto size = std::filesystem::file_size(path, ec);
+            return ec ? 0 : static_cast<uint64_t>(size);
+        }
+
+        /// Records the lifetime of the enclosing scope into a Timer
+        class ScopedTimer {
+          private:
+            Timer &timer_;
+            std::chrono::steady_clock::time_point start_;
+
+          public:
+            inline explicit ScopedTimer(Timer &timer) : timer_(timer), start_(std::chrono::steady_clock::now()) {}
+            inline ~ScopedTimer() {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                timer_.record(
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+            ScopedTimer(const ScopedTimer &) = delete;
+            ScopedTimer &operator=(const ScopedTimer &) = delete;
+        };
+
+    } // namespace metrics
+
+} // namespace zoneout
+
+#define ZONEOUT_METRIC_CONCAT_(a, b) a##b
+#define ZONEOUT_METRIC_CONCAT(a, b) ZONEOUT_METRIC_CONCAT_(a, b)
+
+#ifdef ZONEOUT_METRICS
+/// Time the rest of the enclosing scope under `name` (a string literal)
+#define ZONEOUT_METRIC_TIMER(name)                                                                                     \
+    static ::zoneout::metrics::Timer &ZONEOUT_METRIC_CONCAT(zoneout_metric_timer_, __LINE__) =                         \
+        ::zoneout::metrics::registry().timer(name);                                                                    \
+    ::zoneout::metrics::ScopedTimer ZONEOUT_METRIC_CONCAT(zoneout_metric_scope_, __LINE__)(                           \
+        ZONEOUT_METRIC_CONCAT(zoneout_metric_timer_, __LINE__))
+/// Add `value` to counter `name`; `value` is not evaluated when metrics are disabled
+#define ZONEOUT_METRIC_COUNT(name, value)                                                                              \
+    do {                                                                                                               \
+        static ::zoneout::metrics::Counter &zoneout_metric_counter = ::zoneout::metrics::registry().counter(name);     \
+        zoneout_metric_counter.add(static_cast<uint64_t>(value));                                                      \
+    } while (0)
+#else
+#define ZONEOUT_METRIC_TIMER(name) static_cast<void>(0)
+#define ZONEOUT_METRIC_COUNT(name, value) static_cast<void>(0)
+#endif
@@ -4,74 +4,252 @@
 #include <array>
 #include <atomic>
 #include <chrono>
-#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <random>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace zoneout {
 
+    namespace uuid_detail {
+
+        inline constexpr char hex_digits[] = "0123456789abcdef";
+
+        // Maps an ASCII character to its nibble value, or 0xFF if it is not a hex digit
+        inline constexpr std::array<uint8_t, 256> make_hex_table() {
+            std::array<uint8_t, 256> table{};
+            for (auto &v : table) {
+                v = 0xFF;
+            }
+            for (uint8_t i = 0; i < 10; ++i) {
+                table['0' + i] = i;
+            }
+            for (uint8_t i = 0; i < 6; ++i) {
+                table['a' + i] = static_cast<uint8_t>(10 + i);
+                table['A' + i] = static_cast<uint8_t>(10 + i);
+            }
+            return table;
+        }
+
+        inline constexpr std::array<uint8_t, 256> hex_table = make_hex_table();
+
+        // Offset of each byte's first hex digit in the canonical 8-4-4-4-12 layout
+        inline constexpr std::array<uint8_t, 16> byte_offsets = {0,  2,  4,  6,  9,  11, 14, 16,
+                                                                 19, 21, 24, 26, 28, 30, 32, 34};
+
+        // xoshiro256** seeded once per thread from std::random_device. Much cheaper per draw than
+        // mt19937_64 + uniform_int_distribution, and UUIDs only need statistical uniqueness.
+        class Xoshiro256 {
+          public:
+            Xoshiro256() {
+                std::random_device rd;
+                uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+                for (auto &word : s_) {
+                    // splitmix64 expansion of the seed
+                    seed += 0x9E3779B97F4A7C15ULL;
+                    uint64_t z = seed;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                    word = z ^ (z >> 31);
+                }
+            }
+
+            uint64_t next() noexcept {
+                const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+                const uint64_t t = s_[1] << 17;
+                s_[2] ^= s_[0];
+                s_[3] ^= s_[1];
+                s_[1] ^= s_[2];
+                s_[0] ^= s_[3];
+                s_[2] ^= t;
+                s_[3] = rotl(s_[3], 45);
+                return result;
+            }
+
+          private:
+            static uint64_t rotl(uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+
+            uint64_t s_[4];
+        };
+
+        inline Xoshiro256 &rng() {
+            static thread_local Xoshiro256 engine;
+            return engine;
+        }
+
+        // Per-thread state keeping v7 UUIDs strictly increasing within a millisecond (RFC 9562, method 1)
+        struct V7State {
+            uint64_t last_ms = 0;
+            uint16_t counter = 0;
+        };
+
+        inline V7State &v7_state() {
+            static thread_local V7State state;
+            return state;
+        }
+
+        inline uint64_t unix_ms() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+    } // namespace uuid_detail
+
+    /// Layout used by generateUUID() and default-constructed UUIDs
+    enum class UUIDVersion : uint8_t {
+        V4 = 4, // fully random
+        V7 = 7, // 48-bit unix milliseconds prefix, sorts by creation time
+    };
+
+    namespace uuid_detail {
+        inline std::atomic<UUIDVersion> default_version{UUIDVersion::V4};
+    } // namespace uuid_detail
+
+    /// Select the version generated by default (process-wide). V7 keeps on-disk order and sorted element
+    /// arrays close to insertion order, which keeps related elements together in memory and in indexes.
+    inline void setDefaultUUIDVersion(UUIDVersion version) { uuid_detail::default_version.store(version); }
+
+    inline UUIDVersion defaultUUIDVersion() { return uuid_detail::default_version.load(std::memory_order_relaxed); }
+
+    /// Tag for constructors of temporaries whose id is overwritten right away: starts from a null UUID
+    /// instead of drawing random bytes
+    struct NullIdTag {
+        explicit NullIdTag() = default;
+    };
+
+    inline constexpr NullIdTag null_id{};
+
     class UUID {
       public:
         using ByteArray = std::array<uint8_t, 16>;
 
         UUID() { generate(); }
 
+        /// Non-generating construction: all-zero (null) UUID
+        explicit UUID(NullIdTag) noexcept : data_{} {}
+
         explicit UUID(const std::string &str) { fromString(str); }
 
         explicit UUID(const ByteArray &bytes) : data_(bytes) {}
 
+        /// Generate using the process-wide default version (see setDefaultUUIDVersion)
         void generate() {
-            static thread_local std::random_device rd;
-            static thread_local std::mt19937_64 gen(rd());
-            static thread_local std::uniform_int_distribution<uint64_t> dis;
+            if (defaultUUIDVersion() == UUIDVersion::V7) {
+                generateV7();
+            } else {
+                generateV4();
+            }
+        }
 
-            // Generate 128 bits of randomness
-            uint64_t high = dis(gen);
-            uint64_t low = dis(gen);
+        void generateV4() {
+            auto &rng = uuid_detail::rng();
+            pack(rng.next(), rng.next(), 4);
+        }
 
-            // Set version (4) and variant bits according to RFC 4122
-            high = (high & 0xFFFFFFFFFFFF0FFFUL) | 0x0000000000004000UL; // Version 4
-            low = (low & 0x3FFFFFFFFFFFFFFFUL) | 0x8000000000000000UL;   // Variant 10
+        void generateV7() { generateV7(uuid_detail::unix_ms()); }
 
-            // Pack into byte array
-            for (int i = 0; i < 8; ++i) {
-                data_[i] = static_cast<uint8_t>(high >> (56 - i * 8));
-                data_[i + 8] = static_cast<uint8_t>(low >> (56 - i * 8));
+        /// v7 with an explicit millisecond timestamp; used by batch generation to read the clock once
+        void generateV7(uint64_t unix_ms) {
+            auto &state = uuid_detail::v7_state();
+            auto &rng = uuid_detail::rng();
+            const uint64_t random = rng.next();
+
+            if (unix_ms > state.last_ms) {
+                state.last_ms = unix_ms;
+                // Start the 12-bit counter in the lower half so a burst has headroom before it carries
+                state.counter = static_cast<uint16_t>(random & 0x7FF);
+            } else if (++state.counter > 0xFFF) {
+                // Counter exhausted within one millisecond: borrow the next millisecond
+                state.last_ms++;
+                state.counter = 0;
             }
-        }
 
-        std::string toString() const {
-            std::stringstream ss;
-            ss << std::hex << std::setfill('0');
+            const uint64_t high = (state.last_ms << 16) | state.counter;
+            pack(high, rng.next(), 7);
+        }
 
-            // Format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-            for (size_t i = 0; i < data_.size(); ++i) {
-                if (i == 4 || i == 6 || i == 8 || i == 10) {
-                    ss << '-';
+        /// Fill out[0..count) with fresh UUIDs of the default version, amortising the clock read and the
+        /// thread-local lookups across the whole batch
+        static void generateBatch(UUID *out, size_t count) {
+            if (defaultUUIDVersion() == UUIDVersion::V7) {
+                const uint64_t now = uuid_detail::unix_ms();
+                for (size_t i = 0; i < count; ++i) {
+                    out[i].generateV7(now);
+                }
+            } else {
+                auto &rng = uuid_detail::rng();
+                for (size_t i = 0; i < count; ++i) {
+                    out[i].pack(rng.next(), rng.next(), 4);
                 }
-                ss << std::setw(2) << static_cast<unsigned>(data_[i]);
             }
+        }
 
-            return ss.str();
+        /// Version nibble (4, 7, ... or 0 for the null UUID)
+        uint8_t version() const { return static_cast<uint8_t>(data_[6] >> 4); }
+
+        /// Milliseconds since the unix epoch embedded in a v7 UUID (0 for other versions)
+        uint64_t timestampMs() const {
+            if (version() != 7) {
+                return 0;
+            }
+            uint64_t ms = 0;
+            for (size_t i = 0; i < 6; ++i) {
+                ms = (ms << 8) | data_[i];
+            }
+            return ms;
         }
 
-        void fromString(const std::string &str) {
-            if (str.length() != 36) {
-                throw std::invalid_argument("Invalid UUID string format");
+        /// Length of the canonical textual form (xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx)
+        static constexpr size_t string_size = 36;
+
+        /// Write the canonical lowercase form into out[0..36). Returns a pointer past the last written char.
+        char *to_chars(char *out) const noexcept {
+            for (size_t i = 0; i < data_.size(); ++i) {
+                char *p = out + uuid_detail::byte_offsets[i];
+                p[0] = uuid_detail::hex_digits[data_[i] >> 4];
+                p[1] = uuid_detail::hex_digits[data_[i] & 0x0F];
+            }
+            out[8] = out[13] = out[18] = out[23] = '-';
+            return out + string_size;
+        }
+
+        /// Parse the canonical form (either case). Returns false and leaves out untouched on malformed input.
+        static bool from_chars(std::string_view str, UUID &out) noexcept {
+            if (str.size() != string_size || str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-') {
+                return false;
             }
 
-            size_t byte_idx = 0;
-            for (size_t i = 0; i < str.length(); i += 2) {
-                if (str[i] == '-') {
-                    i++;
-                }
-                if (i + 1 >= str.length()) {
-                    throw std::invalid_argument("Invalid UUID string format");
+            ByteArray bytes;
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                const size_t pos = uuid_detail::byte_offsets[i];
+                uint8_t hi = uuid_detail::hex_table[static_cast<uint8_t>(str[pos])];
+                uint8_t lo = uuid_detail::hex_table[static_cast<uint8_t>(str[pos + 1])];
+                if ((hi | lo) & 0xF0) {
+                    return false;
                 }
+                bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+            }
+
+            out.data_ = bytes;
+            return true;
+        }
 
-                std::string byte_str = str.substr(i, 2);
-                data_[byte_idx++] = static_cast<uint8_t>(std::stoul(byte_str, nullptr, 16));
+        std::string toString() const {
+            std::string result(string_size, '\0');
+            to_chars(result.data());
+            return result;
+        }
+
+        void fromString(const std::string &str) {
+            if (!from_chars(str, *this)) {
+                throw std::invalid_argument("Invalid UUID string format");
             }
         }
 
@@ -87,35 +265,96 @@ namespace zoneout {
             return std::all_of(data_.begin(), data_.end(), [](uint8_t b) { return b == 0; });
         }
 
-        static UUID null() { return UUID(ByteArray{}); }
+        static UUID null() { return UUID(null_id); }
 
       private:
         ByteArray data_;
+
+        // Stamp version and RFC 4122 variant bits, then store big-endian
+        void pack(uint64_t high, uint64_t low, uint64_t version) noexcept {
+            high = (high & 0xFFFFFFFFFFFF0FFFULL) | (version << 12);
+            low = (low & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL; // Variant 10
+
+            for (int i = 0; i < 8; ++i) {
+                data_[i] = static_cast<uint8_t>(high >> (56 - i * 8));
+                data_[i + 8] = static_cast<uint8_t>(low >> (56 - i * 8));
+            }
+        }
     };
 
-    // Hash function for UUID to enable use in unordered containers
+    // Hash function for UUID to enable use in unordered containers.
+    // v4/v7 payloads are already mostly random, so the two 64-bit halves only need a cheap finalizer (the
+    // murmur3 fmix64 constants) rather than a byte-wise combine. Transparent: textual UUIDs hash to the same
+    // value as the parsed UUID so property strings can be looked up without constructing a UUID.
     struct UUIDHash {
-        std::size_t operator()(const UUID &uuid) const {
-            const auto &bytes = uuid.bytes();
-            std::size_t h1 = 0;
-            std::size_t h2 = 0;
+        using is_transparent = void;
+
+        static std::size_t mix(uint64_t hi, uint64_t lo) noexcept {
+            uint64_t h = hi ^ (lo * 0x9E3779B97F4A7C15ULL);
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return static_cast<std::size_t>(h);
+        }
+
+        std::size_t operator()(const UUID &uuid) const noexcept {
+            uint64_t hi, lo;
+            std::memcpy(&hi, uuid.bytes().data(), sizeof(hi));
+            std::memcpy(&lo, uuid.bytes().data() + 8, sizeof(lo));
+            return mix(hi, lo);
+        }
 
-            // Simple hash combining
-            for (size_t i = 0; i < 8; ++i) {
-                h1 = h1 * 31 + bytes[i];
-                h2 = h2 * 31 + bytes[i + 8];
+        std::size_t operator()(std::string_view str) const noexcept {
+            UUID parsed = UUID::null();
+            if (UUID::from_chars(str, parsed)) {
+                return (*this)(parsed);
             }
+            // Malformed text can never compare equal to a UUID; any stable value will do
+            return std::hash<std::string_view>{}(str);
+        }
+
+        std::size_t operator()(const std::string &str) const noexcept { return (*this)(std::string_view(str)); }
+        std::size_t operator()(const char *str) const noexcept { return (*this)(std::string_view(str)); }
+    };
+
+    /// Equality companion to UUIDHash for heterogeneous lookup (UUID vs. textual UUID)
+    struct UUIDEqual {
+        using is_transparent = void;
+
+        bool operator()(const UUID &a, const UUID &b) const noexcept { return a == b; }
 
-            return h1 ^ (h2 << 1);
+        bool operator()(const UUID &a, std::string_view b) const noexcept {
+            UUID parsed = UUID::null();
+            return UUID::from_chars(b, parsed) && parsed == a;
         }
+
+        bool operator()(std::string_view a, const UUID &b) const noexcept { return (*this)(b, a); }
     };
 
+    /// Hash map keyed by UUID that also accepts textual UUIDs in find()/contains()/count()
+    template <typename T> using UUIDMap = std::unordered_map<UUID, T, UUIDHash, UUIDEqual>;
+
+    /// Hash set of UUIDs that also accepts textual UUIDs in find()/contains()/count()
+    using UUIDSet = std::unordered_set<UUID, UUIDHash, UUIDEqual>;
+
     // Convenience function for generating UUIDs
     inline UUID generateUUID() { return UUID(); }
 
+    /// Generate count UUIDs in one go (bulk element creation)
+    inline std::vector<UUID> generateUUIDs(size_t count) {
+        std::vector<UUID> result(count, UUID(null_id));
+        UUID::generateBatch(result.data(), count);
+        return result;
+    }
+
     // Convert UUID to/from string
     inline std::string uuidToString(const UUID &uuid) { return uuid.toString(); }
 
     inline UUID uuidFromString(const std::string &str) { return UUID(str); }
 
+    /// Compare a UUID against its textual form (either case) without allocating
+    inline bool uuidEquals(const UUID &uuid, std::string_view str) { return UUIDEqual{}(uuid, str); }
+
 } // namespace zoneout
\ No newline at end of file
@@ -3,11 +3,19 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <random>
+#include <span>
 #include <sstream>
+#include <stop_token>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -20,8 +28,12 @@
 #include <vectkit/vectkit.hpp>
 
 #include "constants.hpp"
+#include "coverage.hpp"
 #include "polygrid.hpp"
+#include "utils/async.hpp"
+#include "utils/file_io.hpp"
 #include "utils/meta.hpp"
+#include "utils/metrics.hpp"
 #include "utils/time.hpp"
 #include "utils/uuid.hpp"
 
@@ -44,6 +56,11 @@ namespace zoneout {
 
         std::unordered_map<std::string, std::string> properties_;
 
+        // Bare zone for from_files(): no id draw, no base grid rasterization; every member is assigned after
+        inline explicit Zone(NullIdTag) : poly_data_(null_id), grid_data_(null_id), id_(null_id) {}
+
+        friend class SyncTracker;
+
       public:
         inline Zone(const std::string &name, const std::string &type, const dp::Polygon &boundary,
                     const dp::Grid<uint8_t> &initial_grid, const dp::Geo &datum)
@@ -95,16 +112,20 @@ namespace zoneout {
             noise.SetFrequency(sz / 300000.0f);
             noise.SetSeed(std::random_device{}());
 
-            for (size_t r = 0; r < generated_grid.rows; ++r) {
-                for (size_t c = 0; c < generated_grid.cols; ++c) {
-                    auto cell_center = generated_grid.get_point(r, c);
+            {
+                ZONEOUT_METRIC_TIMER("zone.rasterize");
+                for (size_t r = 0; r < generated_grid.rows; ++r) {
+                    for (size_t c = 0; c < generated_grid.cols; ++c) {
+                        auto cell_center = generated_grid.get_point(r, c);
 
-                    if (boundary.contains(cell_center)) {
-                        generated_grid(r, c) = 255;
-                    } else {
-                        generated_grid(r, c) = 0;
+                        if (boundary.contains(cell_center)) {
+                            generated_grid(r, c) = 255;
+                        } else {
+                            generated_grid(r, c) = 0;
+                        }
                     }
                 }
+                ZONEOUT_METRIC_COUNT("zone.cells_rasterized", generated_grid.rows * generated_grid.cols);
             }
 
             grid_data_.add_grid(generated_grid, "base_layer", "terrain");
@@ -193,9 +214,26 @@ namespace zoneout {
             return "No raster layers";
         }
 
+        /// Random value in [50, 200] painted into the base layer for a new polygon element
+        inline static uint8_t random_polygon_color() {
+            // Per thread: zones are built concurrently by ZoneBuilder::build_many and PlotBuilder
+            static thread_local std::mt19937 gen(std::random_device{}());
+            std::uniform_int_distribution<> color_dist(50, 200);
+            return static_cast<uint8_t>(color_dist(gen));
+        }
+
         inline void add_polygon_element(const dp::Polygon &geometry, const std::string &name,
                                         const std::string &type = "", const std::string &subtype = "default",
                                         const std::unordered_map<std::string, std::string> &properties = {}) {
+            add_polygon_element(generateUUID(), random_polygon_color(), geometry, name, type, subtype, properties);
+        }
+
+        /// Deterministic form of add_polygon_element: the caller picks the element id and the value painted into
+        /// the base layer, so the same call can be replayed later (journal, sync) with an identical result
+        inline void add_polygon_element(const UUID &element_id, uint8_t polygon_color, const dp::Polygon &geometry,
+                                        const std::string &name, const std::string &type = "",
+                                        const std::string &subtype = "default",
+                                        const std::unordered_map<std::string, std::string> &properties = {}) {
             if (poly_data_.has_field_boundary()) {
                 auto boundary = poly_data_.field_boundary();
 
@@ -207,33 +245,33 @@ namespace zoneout {
                 }
             }
 
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
-            static std::uniform_int_distribution<> color_dist(50, 200);
-            uint8_t polygon_color = static_cast<uint8_t>(color_dist(gen));
-
             if (grid_data_.layer_count() > 0) {
                 auto &grid_variant = grid_data_.get_layer(0).grid;
                 std::visit(
                     [&](auto &base_grid) {
                         using GridType = std::decay_t<decltype(base_grid)>;
                         if constexpr (!std::is_same_v<GridType, dp::Grid<rastkit::RGBA>>) {
+                            using CellType = typename decltype(base_grid.data)::value_type;
+                            const auto value = static_cast<CellType>(polygon_color);
+                            LayerStats *stats = grid_data_.mutable_layer_stats(0);
                             for (size_t r = 0; r < base_grid.rows; ++r) {
                                 for (size_t c = 0; c < base_grid.cols; ++c) {
                                     auto cell_center = base_grid.get_point(r, c);
                                     if (geometry.contains(cell_center)) {
-                                        using CellType = typename decltype(base_grid.data)::value_type;
-                                        base_grid(r, c) = static_cast<CellType>(polygon_color);
+                                        if (stats != nullptr) {
+                                            stats->update(static_cast<double>(base_grid(r, c)),
+                                                          static_cast<double>(value));
+                                        }
+                                        base_grid(r, c) = value;
                                     }
                                 }
                             }
                         }
                     },
                     grid_variant);
+                grid_data_.settle_layer_stats(0);
             }
 
-            UUID element_id = generateUUID();
-
             poly_data_.add_polygon_element(element_id, name, type, subtype, geometry, properties);
         }
 
@@ -316,52 +354,45 @@ namespace zoneout {
 
         inline static Zone from_files(const std::filesystem::path &vector_path,
                                       const std::filesystem::path &raster_path) {
+            ZONEOUT_METRIC_TIMER("zone.from_files");
             auto [poly, grid] = loadPolyGrid(vector_path, raster_path);
+            return from_parts(std::move(poly), std::move(grid));
+        }
 
-            auto datum = poly.datum();
+        /// Assemble a zone from its separately decoded halves (checked with checkPolyGrid by the caller)
+        inline static Zone from_parts(Poly poly, Grid grid) {
+            ZONEOUT_METRIC_COUNT("zone.features_parsed", poly.feature_count());
+            ZONEOUT_METRIC_COUNT("zone.layers_loaded", grid.layer_count());
 
-            dp::Grid<uint8_t> base_grid;
-            if (grid.has_layers()) {
-                base_grid = std::get<dp::Grid<uint8_t>>(grid.get_layer(0).grid);
-            } else {
-                dp::Pose shift{dp::Point{0.0, 0.0, 0.0}, dp::Euler{0, 0, 0}.to_quaternion()};
-                base_grid.rows = 10;
-                base_grid.cols = 10;
-                base_grid.resolution = 1.0;
-                base_grid.centered = true;
-                base_grid.pose = shift;
-                base_grid.data.resize(100, 0);
-            }
-
-            dp::Polygon default_boundary;
-            Zone zone("", "", default_boundary, base_grid, datum);
-            zone.poly_data_ = poly;
-            zone.grid_data_ = grid;
-
-            if (poly.name().empty() && !grid.name().empty()) {
-                zone.name_ = grid.name();
+            Zone zone(null_id);
+            zone.poly_data_ = std::move(poly);
+            zone.grid_data_ = std::move(grid);
+            const auto &loaded_poly = zone.poly_data_;
+            const auto &loaded_grid = zone.grid_data_;
+
+            if (loaded_poly.name().empty() && !loaded_grid.name().empty()) {
+                zone.name_ = loaded_grid.name();
             } else {
-                zone.name_ = poly.name();
+                zone.name_ = loaded_poly.name();
             }
 
-            if (poly.type().empty() && !grid.type().empty()) {
-                zone.type_ = grid.type();
+            if (loaded_poly.type().empty() && !loaded_grid.type().empty()) {
+                zone.type_ = loaded_grid.type();
             } else {
-                zone.type_ = poly.type();
+                zone.type_ = loaded_poly.type();
             }
 
-            if (!poly.id().isNull()) {
-                zone.id_ = poly.id();
-            } else if (!grid.id().isNull()) {
-                zone.id_ = grid.id();
+            if (!loaded_poly.id().isNull()) {
+                zone.id_ = loaded_poly.id();
+            } else if (!loaded_grid.id().isNull()) {
+                zone.id_ = loaded_grid.id();
+            } else {
+                zone.id_.generate();
             }
 
-            if (std::filesystem::exists(vector_path)) {
-                auto field_props = poly.global_properties();
-                for (const auto &[key, value] : field_props) {
-                    if (key.substr(0, 5) == "prop_") {
-                        zone.set_property(key.substr(5), value);
-                    }
+            for (const auto &[key, value] : loaded_poly.global_properties()) {
+                if (key.substr(0, 5) == "prop_") {
+                    zone.set_property(key.substr(5), value);
                 }
             }
 
@@ -382,7 +413,50 @@ namespace zoneout {
                 poly_copy.set_global_property("prop_" + key, value);
             }
 
-            savePolyGrid(poly_copy, grid_copy, vector_path, raster_path);
+            {
+                ZONEOUT_METRIC_TIMER("zone.to_files");
+                savePolyGrid(poly_copy, grid_copy, vector_path, raster_path);
+            }
+            ZONEOUT_METRIC_COUNT("zone.bytes_written",
+                                 metrics::file_bytes(vector_path) + metrics::file_bytes(raster_path));
+        }
+
+        /// GeoJSON and TIFF bytes of the zone, exactly as to_files() writes them
+        struct EncodedFiles {
+            std::string vector;
+            std::string raster; // empty for a zone without raster layers
+        };
+
+        /**
+         * @brief Encode the zone's files into memory
+         *
+         * vectkit/rastkit only write to paths, so the files are written into a private staging directory under
+         * fileio::scratch_directory() (RAM-backed on Linux) and read back from there. Callers can then checksum
+         * the bytes and batch the real writes through fileio::write.
+         */
+        inline EncodedFiles encode_files() const {
+            auto staging = fileio::scratch_directory() / ("zoneout_zone_" + generateUUID().toString());
+            std::filesystem::create_directories(staging);
+            auto slurp = [](const std::filesystem::path &path) {
+                std::ifstream in(path, std::ios::binary);
+                if (!in) {
+                    throw std::runtime_error("Could not read encoded zone file: " + path.string());
+                }
+                return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            };
+            EncodedFiles encoded;
+            try {
+                to_files(staging / "vector.geojson", staging / "raster.tiff");
+                encoded.vector = slurp(staging / "vector.geojson");
+                if (grid_data_.has_layers()) {
+                    encoded.raster = slurp(staging / "raster.tiff");
+                }
+            } catch (...) {
+                std::filesystem::remove_all(staging);
+                throw;
+            }
+            std::filesystem::remove_all(staging);
+            return encoded;
         }
 
         inline void save(const std::filesystem::path &directory) const {
@@ -398,6 +472,32 @@ namespace zoneout {
             return from_files(vector_path, raster_path);
         }
 
+        /**
+         * @brief Load a zone in the background, decoding the GeoJSON and the TIFF concurrently
+         *
+         * Runs on the default executor. Triggering `stop` before a half has started makes the future throw
+         * Cancelled. The load holds no references to the caller, so the future may be dropped early.
+         */
+        inline static std::future<Zone> load_async(const std::filesystem::path &directory,
+                                                   std::stop_token stop = {}) {
+            return async::submit([directory, stop] {
+                auto vector_path = directory / "vector.geojson";
+                auto raster_path = directory / "raster.tiff";
+                Poly poly(null_id);
+                Grid grid(null_id);
+                bool has_vector = std::filesystem::exists(vector_path);
+                bool has_raster = std::filesystem::exists(raster_path);
+                async::run(2, 2, stop, "Zone load", [&](size_t half) {
+                    if (half == 0 && has_vector)
+                        poly = Poly::from_file(vector_path);
+                    else if (half == 1 && has_raster)
+                        grid = Grid::from_file(raster_path);
+                });
+                checkPolyGrid(poly, grid, has_vector, has_raster);
+                return from_parts(std::move(poly), std::move(grid));
+            });
+        }
+
         inline const vectkit::FeatureCollection &vector_data() const { return poly_data_.collection(); }
         inline const rastkit::RasterCollection &raster_data() const { return grid_data_.raster(); }
 
@@ -497,6 +597,52 @@ namespace zoneout {
                 return std::cref(*ptr);
             return dp::nullopt;
         }
+
+        // ============ Memory Accounting ============
+
+        /// Estimated heap footprint of this zone by category (cheap: no cell data is scanned)
+        inline MemoryUsage memory_usage() const {
+            MemoryUsage usage;
+            usage.object_bytes = sizeof(Zone);
+            usage.property_bytes += memory::map_heap(properties_) + memory::string_heap(name_) +
+                                    memory::string_heap(type_);
+            poly_data_.memory_usage(usage);
+            grid_data_.memory_usage(usage);
+            return usage;
+        }
+
+        // ============ Coverage ============
+
+        /// Add an empty uint8 layer shaped like layer 0 for coverage accumulation; returns its index
+        inline size_t add_coverage_layer(const std::string &name = "coverage") {
+            if (!grid_data_.has_layers()) {
+                throw std::runtime_error("Coverage layer needs a shape: zone has no raster layers");
+            }
+            auto coverage = visit_raster(0, [](const auto &g) {
+                return dp::make_grid<uint8_t>(g.rows, g.cols, g.resolution, g.centered, g.pose, uint8_t{0});
+            });
+            grid_data_.add_grid(coverage, name, "coverage");
+            return grid_data_.layer_count() - 1;
+        }
+
+        /**
+         * @brief Coverage accumulator over a uint8 layer, clipped to the field boundary
+         *
+         * If the layer's statistics are enabled, the accumulator keeps them current. It references the layer and
+         * its statistics: adding or removing layers, or disabling the statistics, invalidates it.
+         */
+        inline CoverageAccumulator coverage(size_t layer_index, double implement_width) {
+            auto grid = raster_as<uint8_t>(layer_index);
+            if (!grid.has_value()) {
+                throw std::invalid_argument("Coverage layer must be uint8");
+            }
+            dp::Polygon boundary;
+            if (poly_data_.has_field_boundary()) {
+                boundary = poly_data_.field_boundary();
+            }
+            return CoverageAccumulator(grid->get(), implement_width, boundary, 255,
+                                       grid_data_.mutable_layer_stats(layer_index));
+        }
     };
 
     // Factory helper for creating zones with validation
@@ -689,14 +835,61 @@ namespace zoneout {
                                       layer.layer_index);
             }
 
-            // Add polygon elements
-            for (const auto &elem : polygon_elements_) {
-                zone.add_polygon_element(elem.geometry, elem.name, elem.type, elem.subtype, elem.properties);
+            // Add polygon elements, drawing their ids in one batch
+            const auto element_ids = generateUUIDs(polygon_elements_.size());
+            for (size_t i = 0; i < polygon_elements_.size(); ++i) {
+                const auto &elem = polygon_elements_[i];
+                zone.add_polygon_element(element_ids[i], Zone::random_polygon_color(), elem.geometry, elem.name,
+                                         elem.type, elem.subtype, elem.properties);
             }
 
             return zone;
         }
 
+        /**
+         * @brief Build every builder on up to `threads` executor workers (0 = all of them)
+         *
+         * Zones come back in the order of `builders`. Building stops at the first invalid builder or failing
+         * construction and that exception is rethrown.
+         */
+        inline static std::vector<Zone> build_many(std::span<const ZoneBuilder> builders, size_t threads = 0) {
+            ZONEOUT_METRIC_TIMER("zone_builder.build_many");
+            std::vector<std::optional<Zone>> built(builders.size());
+            async::run(builders.size(), threads, {}, "Zone build",
+                       [&](size_t i) { built[i].emplace(builders[i].build()); });
+
+            std::vector<Zone> zones;
+            zones.reserve(built.size());
+            for (auto &zone : built) {
+                zones.push_back(std::move(*zone));
+            }
+            return zones;
+        }
+
+        /**
+         * @brief Homogeneous batch: `count` zones sharing this builder's configuration
+         *
+         * Each zone starts from a copy of this builder, which `vary(i, builder)` then adjusts (typically name and
+         * boundary). `vary` runs on the worker threads, so it must not touch shared state without synchronisation.
+         */
+        inline std::vector<Zone> build_many(size_t count, const std::function<void(size_t, ZoneBuilder &)> &vary,
+                                            size_t threads = 0) const {
+            ZONEOUT_METRIC_TIMER("zone_builder.build_many");
+            std::vector<std::optional<Zone>> built(count);
+            async::run(count, threads, {}, "Zone build", [&](size_t i) {
+                ZoneBuilder builder = *this;
+                vary(i, builder);
+                built[i].emplace(builder.build());
+            });
+
+            std::vector<Zone> zones;
+            zones.reserve(count);
+            for (auto &zone : built) {
+                zones.push_back(std::move(*zone));
+            }
+            return zones;
+        }
+
         // Reset builder to initial state
         inline void reset() {
             name_.reset();
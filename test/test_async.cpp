@@ -0,0 +1,110 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <filesystem>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("Async task runner") {
+    SUBCASE("Runs every task once") {
+        std::vector<std::atomic<int>> hits(100);
+        async::run(hits.size(), 4, {}, "test", [&](size_t i) { ++hits[i]; });
+        for (const auto &h : hits)
+            CHECK(h.load() == 1);
+    }
+
+    SUBCASE("First exception propagates and stops further tasks") {
+        std::atomic<size_t> ran{0};
+        CHECK_THROWS_WITH(async::run(1000, 1, {}, "test",
+                                     [&](size_t i) {
+                                         ++ran;
+                                         if (i == 3)
+                                             throw std::runtime_error("boom");
+                                     }),
+                          "boom");
+        CHECK(ran.load() == 4);
+    }
+
+    SUBCASE("A stopped token cancels") {
+        std::stop_source stop;
+        stop.request_stop();
+        CHECK_THROWS_AS(async::run(10, 2, stop.get_token(), "test", [](size_t) {}), Cancelled);
+        CHECK_NOTHROW(async::run(0, 2, stop.get_token(), "test", [](size_t) {}));
+    }
+}
+
+TEST_CASE("Asynchronous zone and plot loading") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Plot plot("Farm", "agricultural", datum);
+    plot.set_property("owner", "Jane");
+    for (int z = 0; z < 5; ++z) {
+        Zone field("Field " + std::to_string(z), "field", make_rect(0, 0, 20.0 + 5 * z, 10), datum, 1.0);
+        field.set_property("index", std::to_string(z));
+        field.poly().add_point_element(generateUUID(), "gate", "access", "default", dp::Point{1, 1, 0});
+        plot.add_zone(field);
+    }
+
+    auto dir = std::filesystem::temp_directory_path() / "zoneout_test_async";
+    std::filesystem::remove_all(dir);
+    plot.save(dir);
+
+    SUBCASE("Zone::load_async matches Zone::load") {
+        auto future = Zone::load_async(dir / "zone_2");
+        auto zone = future.get();
+        auto expected = Zone::load(dir / "zone_2");
+        CHECK(zone.id() == expected.id());
+        CHECK(zone.name() == "Field 2");
+        CHECK(zone.property("index").value() == "2");
+        CHECK(zone.poly().point_elements().size() == 1);
+        CHECK(zone.grid().layer_count() == expected.grid().layer_count());
+    }
+
+    SUBCASE("Plot::load_async keeps metadata and zone order") {
+        AsyncLoadOptions options;
+        options.threads = 3;
+        options.verify = {true, true};
+        auto future = Plot::load_async(dir, "ignored", "ignored", dp::Geo{}, {}, options);
+        auto loaded = future.get();
+        CHECK(loaded.id() == plot.id());
+        CHECK(loaded.property("owner").value() == "Jane");
+        REQUIRE(loaded.zone_count() == 5);
+        for (size_t i = 0; i < 5; ++i) {
+            CHECK(loaded.zones()[i].id() == plot.zones()[i].id());
+            CHECK(loaded.zones()[i].property("index").value() == std::to_string(i));
+        }
+    }
+
+    SUBCASE("Plot::load_tar_async") {
+        auto tar = std::filesystem::temp_directory_path() / "zoneout_test_async.tar";
+        plot.save_tar(tar);
+        auto first = Plot::load_tar_async(tar, "ignored", "ignored", dp::Geo{});
+        auto second = Plot::load_tar_async(tar, "ignored", "ignored", dp::Geo{});
+        CHECK(first.get().zone_count() == 5);
+        CHECK(second.get().zone_count() == 5);
+        std::filesystem::remove(tar);
+    }
+
+    SUBCASE("Cancellation") {
+        std::stop_source stop;
+        stop.request_stop();
+        auto plot_future = Plot::load_async(dir, "Farm", "agricultural", datum, stop.get_token());
+        CHECK_THROWS_AS(plot_future.get(), Cancelled);
+        auto zone_future = Zone::load_async(dir / "zone_0", stop.get_token());
+        CHECK_THROWS_AS(zone_future.get(), Cancelled);
+    }
+
+    SUBCASE("Directories without a manifest and broken zones") {
+        std::filesystem::remove(dir / manifest::file_name);
+        std::filesystem::resize_file(dir / "zone_1" / "raster.tiff", 3);
+        auto loaded = Plot::load_async(dir, "Legacy", "agricultural", datum).get();
+        CHECK(loaded.name() == "Legacy");
+        CHECK(loaded.zone_count() == 4);
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -125,6 +125,11 @@ TEST_CASE("ZoneBuilder with features") {
 
         auto element_info = zone.element_info();
         CHECK(element_info.find("2 polygons") != std::string::npos);
+
+        const auto &elements = zone.poly().polygon_elements();
+        REQUIRE(elements.size() == 2);
+        CHECK_FALSE(elements[0].uuid.isNull());
+        CHECK(elements[0].uuid != elements[1].uuid);
     }
 }
 
@@ -494,3 +499,70 @@ TEST_CASE("PlotBuilder zone_count utility") {
         CHECK(builder.zone_count() == 2);
     }
 }
+
+// ========== Parallel building ==========
+
+TEST_CASE("Parallel zone building") {
+    dp::Geo datum{52.0, 5.0, 0.0};
+
+    SUBCASE("PlotBuilder keeps declaration order across threads") {
+        PlotBuilder builder;
+        builder.with_name("farm").with_type("agricultural").with_datum(datum).with_build_threads(4);
+        for (int i = 0; i < 24; ++i) {
+            builder.add_zone([i](ZoneBuilder &b) {
+                b.with_name("field_" + std::to_string(i))
+                    .with_type("field")
+                    .with_boundary(create_test_boundary(20.0 + i, 10.0))
+                    .with_polygon_element(create_test_boundary(5.0, 5.0), "patch");
+            });
+        }
+        auto plot = builder.build();
+
+        REQUIRE(plot.zone_count() == 24);
+        for (int i = 0; i < 24; ++i) {
+            CHECK(plot.zones()[i].name() == "field_" + std::to_string(i));
+            CHECK(plot.zones()[i].poly().polygon_elements().size() == 1);
+        }
+    }
+
+    SUBCASE("Invalid configurations still throw") {
+        PlotBuilder builder;
+        builder.with_name("farm").with_type("agricultural").with_datum(datum).with_build_threads(0);
+        builder.add_zone(
+            [](ZoneBuilder &b) { b.with_name("ok").with_type("field").with_boundary(create_test_boundary()); });
+        builder.add_zone([](ZoneBuilder &b) { b.with_name("no_boundary").with_type("field"); });
+        CHECK_THROWS_AS(builder.build(), std::invalid_argument);
+    }
+
+    SUBCASE("ZoneBuilder::build_many over distinct builders") {
+        std::vector<ZoneBuilder> builders(6);
+        for (size_t i = 0; i < builders.size(); ++i) {
+            builders[i].with_name("z" + std::to_string(i)).with_type("field").with_datum(datum).with_boundary(
+                create_test_boundary(10.0 * (i + 1), 10.0));
+        }
+        auto zones = ZoneBuilder::build_many(builders, 3);
+        REQUIRE(zones.size() == 6);
+        for (size_t i = 0; i < zones.size(); ++i) {
+            CHECK(zones[i].name() == "z" + std::to_string(i));
+        }
+
+        builders[2] = ZoneBuilder();
+        CHECK_THROWS_AS(ZoneBuilder::build_many(builders, 3), std::invalid_argument);
+    }
+
+    SUBCASE("ZoneBuilder::build_many for a homogeneous batch") {
+        auto base = ZoneBuilder();
+        base.with_type("field").with_datum(datum).with_resolution(2.0).with_property("crop", "maize");
+        auto zones = base.build_many(
+            10, [](size_t i, ZoneBuilder &b) {
+                b.with_name("f" + std::to_string(i)).with_boundary(create_test_boundary(30.0, 10.0 + i));
+            },
+            4);
+        REQUIRE(zones.size() == 10);
+        for (size_t i = 0; i < zones.size(); ++i) {
+            CHECK(zones[i].name() == "f" + std::to_string(i));
+            CHECK(zones[i].property("crop").value_or("") == "maize");
+        }
+        CHECK_FALSE(base.is_valid()); // the template itself is untouched
+    }
+}
@@ -0,0 +1,45 @@
+#include <doctest/doctest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "zoneout/zoneout/utils/checksum.hpp"
+
+using namespace zoneout;
+
+TEST_CASE("CRC32C") {
+    SUBCASE("Known check values") {
+        CHECK(crc32c("") == 0u);
+        CHECK(crc32c("123456789") == 0xE3069283u);
+        CHECK(crc32c(std::string(32, '\0')) == 0x8A9136AAu);
+    }
+
+    SUBCASE("Hardware and portable paths agree for every length and alignment") {
+        std::mt19937 rng(7);
+        std::vector<uint8_t> data(4096 + 16);
+        for (auto &b : data)
+            b = static_cast<uint8_t>(rng());
+
+        for (size_t offset = 0; offset < 16; ++offset) {
+            for (size_t size : {0, 1, 7, 8, 9, 63, 64, 65, 1000, 4096}) {
+                const uint8_t *p = data.data() + offset;
+                uint32_t bytewise = ~0u;
+                for (size_t i = 0; i < size; ++i)
+                    bytewise = checksum_detail::crc32c_tables[0][(bytewise ^ p[i]) & 0xFF] ^ (bytewise >> 8);
+                CHECK(crc32c(p, size) == ~bytewise);
+                CHECK(~checksum_detail::crc32c_software(~0u, p, size) == ~bytewise);
+            }
+        }
+    }
+
+    SUBCASE("Incremental updates match a single pass") {
+        std::string text = "The quick brown fox jumps over the lazy dog, repeatedly and at length.";
+        uint32_t running = 0;
+        for (size_t pos = 0; pos < text.size(); pos += 5)
+            running = crc32c(std::string_view(text).substr(pos, 5), running);
+        CHECK(running == crc32c(text));
+    }
+
+    CHECK(std::string(crc32c_backend()).size() > 0);
+}
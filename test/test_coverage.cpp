@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    size_t count_covered(const dp::Grid<uint8_t> &grid) {
+        size_t count = 0;
+        for (auto v : grid.data)
+            count += v != 0;
+        return count;
+    }
+
+} // namespace
+
+TEST_CASE("CoverageAccumulator sweeps implement footprints") {
+    auto grid = dp::make_grid<uint8_t>(100, 100, 1.0, true, dp::Pose{}, uint8_t{0});
+    CoverageAccumulator coverage(grid, 4.0);
+    CHECK(coverage.total_cells() == 10000);
+    CHECK(coverage.covered_cells() == 0);
+
+    SUBCASE("Straight pass covers a width x length strip") {
+        CHECK(coverage.add_position(dp::Point{-20.0, 0.0, 0.0}) == 0);
+        size_t newly = coverage.add_position(dp::Point{20.0, 0.0, 0.0});
+        CHECK(newly == coverage.covered_cells());
+        CHECK(count_covered(grid) == coverage.covered_cells());
+        // 40 m x 4 m at 1 m cells, give or take the boundary rows/cols
+        CHECK(coverage.covered_area() == doctest::Approx(160.0).epsilon(0.15));
+
+        // Driving back over the same strip adds nothing
+        coverage.lift();
+        coverage.add_position(dp::Point{20.0, 0.0, 0.0});
+        CHECK(coverage.add_position(dp::Point{-20.0, 0.0, 0.0}) == 0);
+    }
+
+    SUBCASE("Heading is independent of the grid axes") {
+        coverage.add_pose(dp::Point{-10.0, -10.0, 0.0}, M_PI / 4);
+        coverage.add_pose(dp::Point{10.0, 10.0, 0.0}, M_PI / 4);
+        double length = std::sqrt(800.0);
+        CHECK(coverage.covered_area() == doctest::Approx(length * 4.0).epsilon(0.15));
+        CHECK(count_covered(grid) == coverage.covered_cells());
+    }
+
+    SUBCASE("Many small 100 Hz steps match one long step") {
+        auto other = dp::make_grid<uint8_t>(100, 100, 1.0, true, dp::Pose{}, uint8_t{0});
+        CoverageAccumulator one_step(other, 4.0);
+        one_step.add_position(dp::Point{-30.0, 5.0, 0.0});
+        one_step.add_position(dp::Point{30.0, 5.0, 0.0});
+
+        for (int i = 0; i <= 6000; ++i) {
+            coverage.add_position(dp::Point{-30.0 + i * 0.01, 5.0, 0.0});
+        }
+        CHECK(coverage.covered_cells() == one_step.covered_cells());
+        CHECK(grid.data == other.data);
+    }
+
+    SUBCASE("Touched tiles are tracked") {
+        coverage.add_position(dp::Point{-40.0, -40.0, 0.0});
+        coverage.add_position(dp::Point{-35.0, -40.0, 0.0});
+        CHECK(coverage.changes().dirty_count() == 1);
+        coverage.clear_changes();
+        CHECK(coverage.changes().empty());
+    }
+
+    CHECK_THROWS_AS(CoverageAccumulator(grid, 0.0), std::invalid_argument);
+}
+
+TEST_CASE("Zone coverage is clipped to the field boundary") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Zone field("Field", "field", make_rect(0, 0, 50, 20), datum, 1.0);
+
+    size_t index = field.add_coverage_layer();
+    REQUIRE(index == 1);
+    auto coverage = field.coverage(index, 6.0);
+    CHECK(coverage.total_cells() == 1000);
+
+    // Drive past both ends of the field: only the part inside the boundary counts
+    coverage.add_position(dp::Point{-20.0, 10.0, 0.0});
+    coverage.add_position(dp::Point{70.0, 10.0, 0.0});
+    CHECK(coverage.covered_cells() == 300);
+    CHECK(coverage.coverage_percent() == doctest::Approx(30.0));
+
+    // A fresh accumulator over the same layer resumes from the painted state
+    auto resumed = field.coverage(index, 6.0);
+    CHECK(resumed.covered_cells() == 300);
+
+    CHECK_THROWS(field.coverage(42, 6.0));
+}
+
+TEST_CASE("Zone coverage keeps enabled layer statistics current") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Zone field("Field", "field", make_rect(0, 0, 50, 20), datum, 1.0);
+    size_t index = field.add_coverage_layer();
+    const auto &stats = field.grid().enable_layer_stats(index);
+
+    auto coverage = field.coverage(index, 6.0);
+    coverage.add_position(dp::Point{-20.0, 10.0, 0.0});
+    coverage.add_position(dp::Point{70.0, 10.0, 0.0});
+    coverage.lift();
+    coverage.add_position(dp::Point{25.0, -10.0, 0.0});
+    coverage.add_position(dp::Point{25.0, 30.0, 0.0});
+
+    CHECK(stats.nonzero_count() == coverage.covered_cells());
+    CHECK(stats.count_of(255) == coverage.covered_cells());
+    CHECK(stats.max() == doctest::Approx(255.0));
+
+    LayerStats rescanned(*field.grid().get_layer(index).gridIf<uint8_t>());
+    CHECK(stats.histogram() == rescanned.histogram());
+    CHECK(stats.sum() == doctest::Approx(rescanned.sum()));
+}
@@ -0,0 +1,142 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "zoneout/zoneout/utils/async.hpp"
+#include "zoneout/zoneout/utils/executor.hpp"
+
+using namespace zoneout;
+
+namespace {
+
+    /// Forwards to a pool and counts what zoneout hands it
+    class CountingExecutor final : public Executor {
+      public:
+        explicit CountingExecutor(size_t threads) : pool_(threads) {}
+        size_t concurrency() const override { return pool_.concurrency(); }
+        void submit(std::function<void()> task) override {
+            ++submitted;
+            pool_.submit(std::move(task));
+        }
+        std::atomic<size_t> submitted{0};
+
+      private:
+        ThreadPool pool_;
+    };
+
+    /// Restores the built-in default executor when a test case ends
+    struct DefaultGuard {
+        ~DefaultGuard() { executor::set_default(nullptr); }
+    };
+
+} // namespace
+
+TEST_CASE("Work-stealing thread pool") {
+    SUBCASE("Runs every task, including ones submitted from its workers") {
+        std::atomic<int> ran{0};
+        {
+            ThreadPool pool(3);
+            CHECK(pool.concurrency() == 3);
+            for (int i = 0; i < 50; ++i) {
+                pool.submit([&] {
+                    ++ran;
+                    pool.submit([&] { ++ran; });
+                });
+            }
+        } // the destructor drains the queues
+        CHECK(ran.load() == 100);
+    }
+
+    SUBCASE("A pool released from one of its own tasks shuts down cleanly") {
+        std::atomic<bool> done{false};
+        auto pool = std::make_shared<ThreadPool>(2);
+        pool->submit([&done, keep = pool]() mutable {
+            keep.reset();
+            done = true;
+        });
+        pool.reset();
+        while (!done) {
+            std::this_thread::yield();
+        }
+        CHECK(done.load());
+    }
+}
+
+TEST_CASE("Parallel paths share the default executor") {
+    DefaultGuard guard;
+
+    SUBCASE("Concurrency is capped by the executor") {
+        executor::set_concurrency(2);
+        CHECK(executor::concurrency() == 2);
+        CHECK(async::worker_count(100, 0) == 2);
+        CHECK(async::worker_count(100, 16) == 2);
+        CHECK(async::worker_count(1, 0) == 1);
+
+        std::atomic<int> active{0}, peak{0};
+        async::run(64, 0, {}, "test", [&](size_t) {
+            const int now = ++active;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            --active;
+        });
+        CHECK(peak.load() <= 2);
+    }
+
+    SUBCASE("Worker indices stay below worker_count") {
+        executor::set_concurrency(4);
+        const size_t workers = async::worker_count(200, 0);
+        std::vector<std::atomic<int>> per_worker(workers);
+        async::run(200, 0, {}, "test", [&](size_t, size_t worker) {
+            REQUIRE(worker < workers);
+            ++per_worker[worker];
+        });
+        int total = 0;
+        for (const auto &count : per_worker)
+            total += count.load();
+        CHECK(total == 200);
+    }
+
+    SUBCASE("User-supplied executors receive the work") {
+        auto counting = std::make_shared<CountingExecutor>(3);
+        executor::set_default(counting);
+        std::vector<std::atomic<int>> hits(30);
+        async::run(hits.size(), 0, {}, "test", [&](size_t i) { ++hits[i]; });
+        for (const auto &h : hits)
+            CHECK(h.load() == 1);
+        CHECK(counting->submitted.load() == 2);
+
+        CHECK(async::submit([] { return 42; }).get() == 42);
+        CHECK(counting->submitted.load() == 3);
+    }
+
+    SUBCASE("Nested runs from inside executor tasks do not deadlock") {
+        executor::set_concurrency(2);
+        std::atomic<int> inner{0};
+        auto outer = async::submit([&] {
+            async::run(8, 0, {}, "test", [&](size_t) {
+                async::run(8, 0, {}, "test", [&](size_t) { ++inner; });
+            });
+        });
+        outer.get();
+        CHECK(inner.load() == 64);
+    }
+
+    SUBCASE("The inline executor runs everything on the caller") {
+        executor::set_default(std::make_shared<InlineExecutor>());
+        const auto caller = std::this_thread::get_id();
+        bool same = true;
+        async::run(10, 0, {}, "test", [&](size_t) { same = same && std::this_thread::get_id() == caller; });
+        CHECK(same);
+        CHECK(async::submit([] { return std::this_thread::get_id(); }).get() == caller);
+    }
+
+    SUBCASE("Exceptions travel through submit") {
+        auto future = async::submit([]() -> int { throw std::runtime_error("boom"); });
+        CHECK_THROWS_WITH(future.get(), "boom");
+    }
+}
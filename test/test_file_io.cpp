@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "zoneout/zoneout/utils/file_io.hpp"
+
+using namespace zoneout;
+
+namespace {
+
+    std::vector<fileio::Options> backends() {
+        std::vector<fileio::Options> all;
+        fileio::Options threads;
+        threads.backend = fileio::Backend::Threads;
+        threads.threads = 3;
+        all.push_back(threads);
+        if (fileio::backend() == fileio::Backend::IoUring) {
+            fileio::Options ring;
+            ring.backend = fileio::Backend::IoUring;
+            ring.queue_depth = 4; // smaller than the batch, so phases wrap the ring
+            all.push_back(ring);
+        }
+        return all;
+    }
+
+} // namespace
+
+TEST_CASE("Batched file I/O") {
+    auto root = std::filesystem::temp_directory_path() / "zoneout_test_file_io";
+
+    for (const auto &options : backends()) {
+        CAPTURE(fileio::backend_name(options.backend));
+        std::filesystem::remove_all(root);
+
+        std::vector<std::filesystem::path> dirs;
+        for (int d = 0; d < 5; ++d) {
+            dirs.push_back(root / "nested" / ("zone_" + std::to_string(d)));
+        }
+        fileio::create_directories(dirs, options);
+        for (const auto &dir : dirs) {
+            CHECK(std::filesystem::is_directory(dir));
+        }
+        CHECK_NOTHROW(fileio::create_directories(dirs, options));
+
+        std::vector<fileio::File> files(10);
+        for (size_t i = 0; i < files.size(); ++i) {
+            files[i].path = dirs[i % dirs.size()] / ("file_" + std::to_string(i) + ".bin");
+            files[i].data = std::string(i * 7919, static_cast<char>('a' + i));
+        }
+        files[3].data.clear();
+        files[4].data[17] = '\0';
+        fileio::write(files, options);
+        for (const auto &file : files) {
+            CHECK(file.ok());
+            CHECK(std::filesystem::file_size(file.path) == file.data.size());
+        }
+
+        std::vector<fileio::File> back(files.size() + 1);
+        for (size_t i = 0; i < files.size(); ++i) {
+            back[i].path = files[i].path;
+        }
+        back.back().path = root / "missing.bin";
+        fileio::read(back, options);
+        for (size_t i = 0; i < files.size(); ++i) {
+            CHECK(back[i].ok());
+            CHECK(back[i].data == files[i].data);
+        }
+        CHECK(back.back().error == ENOENT);
+        CHECK(back.back().message().find("missing.bin") != std::string::npos);
+
+        std::vector<fileio::File> orphan(1);
+        orphan[0].path = root / "no_such_dir" / "file.bin";
+        orphan[0].data = "x";
+        fileio::write(orphan, options);
+        CHECK(orphan[0].error == ENOENT);
+    }
+
+    std::filesystem::remove_all(root);
+}
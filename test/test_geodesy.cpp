@@ -0,0 +1,107 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <random>
+
+#include <concord/frame/convert.hpp>
+
+#include "zoneout/zoneout.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("LocalFrame ENU/WGS conversion") {
+    const dp::Geo datum{51.98776, 5.66238, 12.0};
+    const LocalFrame frame(datum);
+    constexpr double deg = M_PI / 180.0;
+    const double sin_lat = std::sin(datum.latitude * deg);
+    const double w = std::sqrt(1.0 - LocalFrame::e2 * sin_lat * sin_lat);
+    const double prime_vertical = LocalFrame::a / w;
+    const double meridian = LocalFrame::a * (1.0 - LocalFrame::e2) / (w * w * w);
+
+    SUBCASE("Origin maps to the datum") {
+        auto geo = frame.to_wgs(dp::Point{0, 0, 0});
+        CHECK(geo.latitude == doctest::Approx(datum.latitude).epsilon(1e-12));
+        CHECK(geo.longitude == doctest::Approx(datum.longitude).epsilon(1e-12));
+        CHECK(geo.altitude == doctest::Approx(datum.altitude).epsilon(1e-6));
+    }
+
+    SUBCASE("Offsets follow the local radii of curvature") {
+        auto north = frame.to_wgs(dp::Point{0, 1000, 0});
+        CHECK((north.latitude - datum.latitude) * deg * meridian == doctest::Approx(1000.0).epsilon(1e-4));
+        CHECK(north.longitude == doctest::Approx(datum.longitude).epsilon(1e-12));
+
+        auto east = frame.to_wgs(dp::Point{1000, 0, 0});
+        const double cos_lat = std::cos(datum.latitude * deg);
+        CHECK((east.longitude - datum.longitude) * deg * prime_vertical * cos_lat ==
+              doctest::Approx(1000.0).epsilon(1e-4));
+        // The tangent plane rises away from the ellipsoid by about d^2 / 2N
+        CHECK(east.altitude - datum.altitude == doctest::Approx(1e6 / (2.0 * prime_vertical)).epsilon(1e-2));
+    }
+
+    SUBCASE("Batch matches single-point conversion and round-trips") {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> offset(-5000.0, 5000.0);
+        std::vector<dp::Point> points(1000);
+        for (auto &p : points)
+            p = dp::Point{offset(rng), offset(rng), offset(rng) * 0.01};
+
+        auto geos = frame.to_wgs(points);
+        REQUIRE(geos.size() == points.size());
+        auto back = frame.to_enu(geos);
+        for (size_t i = 0; i < points.size(); ++i) {
+            auto single = frame.to_wgs(points[i]);
+            CHECK(geos[i].latitude == single.latitude);
+            CHECK(geos[i].longitude == single.longitude);
+            CHECK(std::abs(back[i].x - points[i].x) < 1e-3);
+            CHECK(std::abs(back[i].y - points[i].y) < 1e-3);
+            CHECK(std::abs(back[i].z - points[i].z) < 1e-3);
+        }
+    }
+
+    SUBCASE("Mismatched output spans are rejected") {
+        std::vector<dp::Point> points(3);
+        std::vector<dp::Geo> out(2);
+        CHECK_THROWS_AS(frame.to_wgs(points, out), std::invalid_argument);
+    }
+}
+
+TEST_CASE("LocalFrame matches the concord frame conversion") {
+    constexpr double deg = M_PI / 180.0;
+    // Equator, mid and high latitudes, both hemispheres, the antimeridian and a raised datum
+    const std::vector<dp::Geo> datums{{0.0, 0.0, 0.0},          {51.98776, 5.66238, 12.0}, {-33.8688, 151.2093, 58.0},
+                                      {69.6492, 18.9553, 0.0},  {-54.8019, -68.303, 0.0},  {12.5, 179.95, 2300.0},
+                                      {-0.0001, -179.99, -30.0}};
+
+    for (const auto &datum : datums) {
+        CAPTURE(datum.latitude);
+        CAPTURE(datum.longitude);
+        const LocalFrame frame(datum);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> offset(-5000.0, 5000.0), height(-50.0, 50.0);
+
+        for (int i = 0; i < 200; ++i) {
+            const dp::Point p{offset(rng), offset(rng), height(rng)};
+            const auto expected = concord::frame::to_wgs(concord::frame::ENU{p.x, p.y, p.z, datum});
+            const auto geo = frame.to_wgs(p);
+
+            // Differences in metres along the local radii of curvature
+            const double sin_lat = std::sin(expected.latitude * deg);
+            const double w = std::sqrt(1.0 - LocalFrame::e2 * sin_lat * sin_lat);
+            const double north = (geo.latitude - expected.latitude) * deg * LocalFrame::a * (1.0 - LocalFrame::e2) /
+                                 (w * w * w);
+            double dlon = geo.longitude - expected.longitude;
+            dlon -= 360.0 * std::round(dlon / 360.0);
+            const double east = dlon * deg * LocalFrame::a / w * std::cos(expected.latitude * deg);
+            CHECK(std::abs(north) < 1e-3);
+            CHECK(std::abs(east) < 1e-3);
+            CHECK(std::abs(geo.altitude - expected.altitude) < 1e-3);
+
+            // And the inverse takes concord's WGS output back to the same ENU point
+            const auto back = frame.to_enu(dp::Geo{expected.latitude, expected.longitude, expected.altitude});
+            CHECK(std::abs(back.x - p.x) < 1e-3);
+            CHECK(std::abs(back.y - p.y) < 1e-3);
+            CHECK(std::abs(back.z - p.z) < 1e-3);
+        }
+    }
+}
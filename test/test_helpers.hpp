@@ -0,0 +1,13 @@
+#pragma once
+
+#include <datapod/datapod.hpp>
+
+/// Axis-aligned rectangle [x0, x1] x [y0, y1], counter-clockwise from (x0, y0)
+inline datapod::Polygon make_rect(double x0, double y0, double x1, double y1) {
+    datapod::Polygon poly;
+    poly.vertices.push_back({x0, y0, 0});
+    poly.vertices.push_back({x1, y0, 0});
+    poly.vertices.push_back({x1, y1, 0});
+    poly.vertices.push_back({x0, y1, 0});
+    return poly;
+}
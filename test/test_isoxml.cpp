@@ -0,0 +1,141 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    std::string read_text(const std::filesystem::path &path) {
+        std::ifstream in(path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    std::vector<char> read_bytes(const std::filesystem::path &path) {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    size_t count(const std::string &text, const std::string &needle) {
+        size_t n = 0;
+        for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1))
+            ++n;
+        return n;
+    }
+
+} // namespace
+
+TEST_CASE("ISOXML task data export") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Plot plot("Farm", "agricultural", datum);
+    for (int z = 0; z < 3; ++z) {
+        Zone field("Field & " + std::to_string(z), "field", make_rect(0, 0, 40, 20), datum, 1.0);
+        field.poly().add_polygon_element(generateUUID(), "pond", "water", "default", make_rect(5, 5, 10, 10));
+        field.poly().add_line_element(generateUUID(), "AB north", "guidance", "ab-line",
+                                      dp::Segment{{0, 2, 0}, {40, 2, 0}});
+        field.poly().add_point_element(generateUUID(), "gate", "access", "default", dp::Point{0, 10, 0});
+        if (z == 1) {
+            field.poly().add_line_element(generateUUID(), "AB south", "guidance", "ab-line",
+                                          dp::Segment{{0, 18, 0}, {40, 18, 0}});
+        }
+        plot.add_zone(field);
+    }
+
+    auto &first = plot.zones()[0];
+    auto &cells = std::get<dp::Grid<uint8_t>>(first.grid().get_layer(0).grid);
+    const size_t rows = cells.rows, cols = cells.cols;
+    REQUIRE(rows > 1);
+    std::fill(cells.data.begin(), cells.data.end(), uint8_t{3});
+    cells(rows - 1, 0) = 7; // south-west cell
+    cells(0, cols - 1) = 9; // north-east cell
+    cells(rows - 1, cols - 1) = 255;
+
+    auto out = std::filesystem::temp_directory_path() / "zoneout_test_isoxml";
+    std::filesystem::remove_all(out);
+
+    SUBCASE("Type 1 grids, partfields and guidance") {
+        isoxml::ExportOptions options;
+        options.threads = 3;
+        options.value_scale = 10.0;
+        auto dir = isoxml::export_plot(plot, out, options);
+
+        const auto xml = read_text(dir / "TASKDATA.XML");
+        CHECK(xml.find("<ISO11783_TaskData VersionMajor=\"4\"") != std::string::npos);
+        CHECK(count(xml, "<PFD ") == 3);
+        CHECK(count(xml, "<TSK ") == 3);
+        CHECK(count(xml, "<GRD ") == 3);
+        CHECK(count(xml, "<GPN ") == 4);
+        // GPN ids are one running sequence across the zones
+        for (int n = 1; n <= 4; ++n) {
+            CHECK(count(xml, "<GPN A=\"GPN" + std::to_string(n) + "\"") == 1);
+        }
+        CHECK(xml.find("C=\"Field &amp; 0\"") != std::string::npos);
+        CHECK(xml.find("<PLN A=\"3\" B=\"pond\">") != std::string::npos);
+        CHECK(xml.find("<PNT A=\"3\" B=\"gate\"") != std::string::npos);
+        // Codes 3, 7 and 9 are used in the first zone, scaled into the rate
+        CHECK(xml.find("<TZN A=\"7\" B=\"zone 7\">") != std::string::npos);
+        // 255 is not a valid TreatmentZoneCode; those cells go to the no-treatment zone
+        CHECK(xml.find("<TZN A=\"255\"") == std::string::npos);
+        CHECK(count(xml, "<TZN A=\"0\" B=\"no treatment\">") == 1);
+        CHECK(xml.find("<PDV A=\"0006\" B=\"90\"/>") != std::string::npos);
+        CHECK(xml.find("G=\"GRD00002\" H=\"" + std::to_string(rows * cols) + "\" I=\"1\"") != std::string::npos);
+
+        auto bin = read_bytes(dir / "GRD00001.BIN");
+        REQUIRE(bin.size() == rows * cols);
+        CHECK(static_cast<uint8_t>(bin.front()) == 7);
+        CHECK(static_cast<uint8_t>(bin.back()) == 9);
+        CHECK(static_cast<uint8_t>(bin[cols - 1]) == 0); // south-east cell, 255 in the layer
+        CHECK(std::filesystem::exists(dir / "GRD00003.BIN"));
+    }
+
+    SUBCASE("No-treatment code must not clash with a rated zone") {
+        isoxml::ExportOptions options;
+        options.no_treatment_code = 3;
+        CHECK_THROWS_AS(isoxml::export_zone(first, out, options), std::invalid_argument);
+    }
+
+    SUBCASE("Type 2 grids from wider layers") {
+        auto layer = first.grid().get_layer(0);
+        dp::Grid<float> rates(rows, cols, cells.resolution, cells.centered, cells.pose, 2.5f);
+        rates(rows - 1, 0) = -1.0f;
+        layer.grid = rates;
+        first.grid().raster().layers.push_back(layer);
+
+        isoxml::ExportOptions options;
+        options.prescription_layer = 1;
+        options.value_scale = 100.0;
+        auto dir = isoxml::export_zone(first, out, options);
+
+        const auto xml = read_text(dir / "TASKDATA.XML");
+        CHECK(xml.find("I=\"2\" J=\"1\"") != std::string::npos);
+        auto bin = read_bytes(dir / "GRD00001.BIN");
+        REQUIRE(bin.size() == rows * cols * 4);
+        auto cell = [&](size_t i) {
+            uint32_t v = 0;
+            for (int b = 3; b >= 0; --b)
+                v = (v << 8) | static_cast<uint8_t>(bin[i * 4 + b]);
+            return static_cast<int32_t>(v);
+        };
+        CHECK(cell(0) == -100);
+        CHECK(cell(1) == 250);
+    }
+
+    SUBCASE("Missing prescription layer is skipped") {
+        isoxml::ExportOptions options;
+        options.prescription_layer = 5;
+        auto dir = isoxml::export_zone(first, out, options);
+        CHECK(read_text(dir / "TASKDATA.XML").find("<GRD ") == std::string::npos);
+    }
+
+    std::filesystem::remove_all(out);
+}
@@ -0,0 +1,193 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#if defined(__unix__)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("JournaledPlot persists mutations and replays them") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    std::filesystem::path dir = "/tmp/zoneout_test_journal";
+    std::filesystem::remove_all(dir);
+
+    UUID zone_id = UUID::null();
+    UUID polygon_id = UUID::null();
+    UUID point_id = UUID::null();
+    UUID plot_id = UUID::null();
+
+    {
+        auto journaled = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+        plot_id = journaled.plot().id();
+        CHECK(std::filesystem::exists(dir / "snapshot" / "plot.bin"));
+        CHECK(std::filesystem::exists(dir / "journal.bin"));
+
+        Zone zone("Field", "field", make_rect(0, 0, 100, 50), datum, 1.0);
+        zone_id = zone.id();
+        journaled.add_zone(zone);
+        journaled.set_property("owner", "wur");
+        journaled.set_zone_property(zone_id, "crop_type", "wheat");
+        polygon_id = journaled.add_polygon_element(zone_id, make_rect(10, 10, 20, 20), "Barn", "building");
+        point_id = journaled.add_point_element(zone_id, dp::Point{50, 25, 0}, "Well", "water");
+        journaled.add_point_element(zone_id, dp::Point{60, 25, 0}, "Pump", "water");
+        journaled.remove_point_element(zone_id, point_id);
+        journaled.add_raster_layer(zone_id, dp::make_grid<uint8_t>(50, 100, 1.0, true, dp::Pose{}, uint8_t(7)),
+                                   "moisture", "sensor");
+        CHECK(journaled.sequence() == 8);
+    }
+
+    auto reopened = JournaledPlot::open(dir, "ignored", "ignored", datum);
+    const auto &plot = reopened.plot();
+    CHECK(reopened.sequence() == 8);
+    CHECK(plot.id() == plot_id);
+    CHECK(plot.name() == "Farm");
+    CHECK(plot.property("owner").value_or("") == "wur");
+    REQUIRE(plot.zone_count() == 1);
+
+    auto zone = plot.zone(zone_id);
+    REQUIRE(zone.has_value());
+    CHECK(zone->get().property("crop_type").value_or("") == "wheat");
+    REQUIRE(zone->get().poly().polygon_elements().size() == 1);
+    CHECK(zone->get().poly().polygon_elements()[0].uuid == polygon_id);
+    REQUIRE(zone->get().poly().point_elements().size() == 1);
+    CHECK(zone->get().poly().point_elements()[0].name == "Pump");
+    CHECK(zone->get().layer_count() == 2);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("JournaledPlot compaction") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    std::filesystem::path dir = "/tmp/zoneout_test_journal_compact";
+    std::filesystem::remove_all(dir);
+
+    Plot initial("Farm", "agricultural", datum);
+    Zone zone_a("A", "field", make_rect(0, 0, 10, 10), datum, 1.0);
+    Zone zone_b("B", "field", make_rect(20, 0, 30, 10), datum, 1.0);
+    initial.add_zone(zone_a);
+    initial.add_zone(zone_b);
+
+    journal::Options options;
+    options.compact_threshold = 256;
+
+    {
+        auto journaled = JournaledPlot::create(dir, initial, options);
+        for (int i = 0; i < 50; ++i) {
+            journaled.set_zone_property(zone_b.id(), "pass", std::to_string(i));
+        }
+        CHECK(journaled.journal_size() <= options.compact_threshold);
+        journaled.remove_zone(zone_a.id());
+    }
+
+    auto reopened = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+    CHECK(reopened.sequence() == 51);
+    REQUIRE(reopened.plot().zone_count() == 1);
+    CHECK(reopened.plot().zones()[0].id() == zone_b.id());
+    CHECK(reopened.plot().zones()[0].property("pass").value_or("") == "49");
+
+    reopened.compact();
+    CHECK(reopened.journal_size() == journal::journal_header_size);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("JournaledPlot recovers from a torn tail") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    std::filesystem::path dir = "/tmp/zoneout_test_journal_torn";
+    std::filesystem::remove_all(dir);
+
+    size_t intact_size = 0;
+    {
+        auto journaled = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+        journaled.set_property("a", "1");
+        journaled.set_property("b", "2");
+        intact_size = journaled.journal_size();
+        journaled.set_property("c", "3");
+    }
+
+    // Simulate power loss in the middle of the last record
+    std::filesystem::resize_file(dir / "journal.bin", intact_size + 5);
+
+    {
+        auto reopened = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+        CHECK(reopened.plot().property("a").value_or("") == "1");
+        CHECK(reopened.plot().property("b").value_or("") == "2");
+        CHECK_FALSE(reopened.plot().has_property("c"));
+        CHECK(reopened.sequence() == 2);
+        CHECK(std::filesystem::file_size(dir / "journal.bin") == intact_size);
+
+        // New records continue after the intact prefix
+        reopened.set_property("d", "4");
+    }
+
+    // A flipped byte fails the CRC and ends the replay there
+    {
+        std::fstream file(dir / "journal.bin", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(intact_size + journal::frame_header_size + 2));
+        file.put('\xFF');
+    }
+
+    auto reopened = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+    CHECK(reopened.plot().property("b").value_or("") == "2");
+    CHECK_FALSE(reopened.plot().has_property("d"));
+
+    std::filesystem::remove_all(dir);
+}
+
+#if defined(__unix__)
+TEST_CASE("JournaledPlot rolls back a failed append") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    std::filesystem::path dir = "/tmp/zoneout_test_journal_append";
+    std::filesystem::remove_all(dir);
+
+    {
+        auto journaled = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+        journaled.set_property("a", "1");
+        const size_t intact = journaled.journal_size();
+
+        // Cap the file size so the next record is cut off part way through
+        rlimit previous{};
+        getrlimit(RLIMIT_FSIZE, &previous);
+        auto *handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit capped = previous;
+        capped.rlim_cur = static_cast<rlim_t>(intact + 64);
+        setrlimit(RLIMIT_FSIZE, &capped);
+        CHECK_THROWS_AS(journaled.set_property("big", std::string(64 * 1024, 'x')), std::runtime_error);
+        setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, handler);
+
+        CHECK_FALSE(journaled.plot().has_property("big"));
+        CHECK(journaled.sequence() == 1);
+        CHECK(journaled.journal_size() == intact);
+        CHECK(std::filesystem::file_size(dir / "journal.bin") == intact);
+
+        // Later records are not hidden behind a torn frame
+        journaled.set_property("b", "2");
+    }
+
+    auto reopened = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+    CHECK(reopened.plot().property("a").value_or("") == "1");
+    CHECK(reopened.plot().property("b").value_or("") == "2");
+    CHECK_FALSE(reopened.plot().has_property("big"));
+    CHECK(reopened.sequence() == 2);
+
+    std::filesystem::remove_all(dir);
+}
+#endif
+
+TEST_CASE("Journal file reads") {
+    std::filesystem::path missing = "/tmp/zoneout_test_journal_missing.bin";
+    std::filesystem::remove(missing);
+
+    CHECK_THROWS_AS(journal::read_file(missing), std::runtime_error);
+    CHECK(journal::read_file_if_exists(missing).empty());
+}
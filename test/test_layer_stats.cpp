@@ -0,0 +1,171 @@
+#include <doctest/doctest.h>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("LayerStats follow writes made through Grid::set_cell") {
+    Grid grid("Field", "field");
+    auto base = dp::make_grid<uint8_t>(10, 20, 1.0, true, dp::Pose{}, uint8_t{0});
+    base(0, 0) = 7;
+    grid.add_grid(base, "base", "terrain");
+
+    CHECK_FALSE(grid.layer_stats(0).has_value());
+    const auto &stats = grid.enable_layer_stats(0);
+    CHECK(stats.count() == 200);
+    CHECK(stats.nonzero_count() == 1);
+    CHECK(stats.sum() == doctest::Approx(7.0));
+    CHECK(stats.max() == doctest::Approx(7.0));
+    CHECK(stats.count_of(0) == 199);
+
+    SUBCASE("Incremental updates match a full rescan") {
+        for (size_t c = 0; c < 20; ++c)
+            grid.set_cell<uint8_t>(0, 3, c, 255);
+        grid.set_cell<uint8_t>(0, 0, 0, 0);
+
+        const auto &live = grid.layer_stats(0)->get();
+        CHECK(live.nonzero_count() == 20);
+        CHECK(live.nonzero_ratio() == doctest::Approx(0.1));
+        CHECK(live.sum() == doctest::Approx(20 * 255.0));
+        CHECK(live.count_of(255) == 20);
+        CHECK(live.count_of(7) == 0);
+        CHECK(live.min() == doctest::Approx(0.0));
+        CHECK(live.max() == doctest::Approx(255.0));
+
+        LayerStats rescanned(*grid.get_layer(0).gridIf<uint8_t>());
+        CHECK(rescanned.histogram() == live.histogram());
+        CHECK(rescanned.sum() == doctest::Approx(live.sum()));
+    }
+
+    SUBCASE("Extrema are recomputed lazily once the last extreme cell changes") {
+        grid.set_cell<uint8_t>(0, 5, 5, 200);
+        CHECK(grid.layer_stats(0)->get().max() == doctest::Approx(200.0));
+        grid.set_cell<uint8_t>(0, 5, 5, 3);
+        CHECK(grid.layer_stats(0)->get().max() == doctest::Approx(7.0));
+
+        for (size_t r = 0; r < 10; ++r)
+            for (size_t c = 0; c < 20; ++c)
+                grid.set_cell<uint8_t>(0, r, c, 9);
+        CHECK(grid.layer_stats(0)->get().min() == doctest::Approx(9.0));
+        CHECK(grid.layer_stats(0)->get().max() == doctest::Approx(9.0));
+    }
+
+    SUBCASE("Raw writes need a refresh and removals shift tracked indices") {
+        grid.add_grid(base, "second", "terrain");
+        grid.enable_layer_stats(1);
+
+        grid.get_layer(0).gridIf<uint8_t>()->data.assign(200, 1);
+        grid.refresh_layer_stats(0);
+        CHECK(grid.layer_stats(0)->get().sum() == doctest::Approx(200.0));
+
+        grid.remove_layer(0);
+        REQUIRE(grid.has_layer_stats(0));
+        CHECK_FALSE(grid.has_layer_stats(1));
+        CHECK(grid.layer_stats(0)->get().sum() == doctest::Approx(7.0));
+    }
+
+    SUBCASE("Writes over unrefreshed raw data rebuild instead of corrupting the stats") {
+        // Every cell now holds a value the histogram has never seen
+        grid.get_layer(0).gridIf<uint8_t>()->data.assign(200, 42);
+        grid.set_cell<uint8_t>(0, 1, 1, 0);
+
+        const auto &live = grid.layer_stats(0)->get();
+        CHECK_FALSE(live.stale());
+        CHECK(live.count_of(42) == 199);
+        CHECK(live.count_of(0) == 1);
+        CHECK(live.min() == doctest::Approx(0.0));
+        CHECK(live.max() == doctest::Approx(42.0));
+    }
+
+    CHECK_THROWS_AS(grid.set_cell<float>(0, 0, 0, 1.0f), std::invalid_argument);
+    CHECK_THROWS_AS(grid.set_cell<uint8_t>(0, 99, 0, 1), std::out_of_range);
+}
+
+TEST_CASE("LayerStats on float layers use a sparse histogram") {
+    auto heights = dp::make_grid<float>(4, 4, 1.0, true, dp::Pose{}, 1.5f);
+    LayerStats stats(heights);
+    CHECK(stats.count_of(1.5) == 16);
+    stats.update(1.5, -2.25);
+    CHECK(stats.min() == doctest::Approx(-2.25));
+    stats.update(-2.25, 1.5);
+    CHECK(stats.min() == doctest::Approx(1.5));
+    CHECK(stats.histogram().size() == 1);
+}
+
+TEST_CASE("LayerStats mark themselves stale on updates the histogram cannot explain") {
+    auto small = dp::make_grid<uint8_t>(2, 2, 1.0, true, dp::Pose{}, uint8_t{1});
+    LayerStats dense(small);
+    dense.update(5, 6); // no cell holds 5
+    CHECK(dense.stale());
+    CHECK(dense.count() == 4);
+    CHECK(dense.count_of(1) == 4);
+    dense.update(1, 2); // ignored until rebuilt
+    CHECK(dense.count_of(2) == 0);
+    dense.rebuild(small);
+    CHECK_FALSE(dense.stale());
+
+    dense.update(1, 0, 5); // more cells than the bucket holds
+    CHECK(dense.stale());
+    CHECK(dense.count_of(1) == 4);
+
+    auto heights = dp::make_grid<float>(2, 2, 1.0, true, dp::Pose{}, 1.5f);
+    LayerStats sparse(heights);
+    sparse.update(2.5, 3.0);
+    CHECK(sparse.stale());
+    CHECK(sparse.count_of(1.5) == 4);
+    CHECK(sparse.sum() == doctest::Approx(6.0));
+}
+
+TEST_CASE("LayerStats bulk updates match cell-by-cell ones") {
+    auto grid = dp::make_grid<uint8_t>(8, 8, 1.0, true, dp::Pose{}, uint8_t{0});
+    LayerStats bulk(grid);
+    LayerStats single(grid);
+    bulk.update(0, 255, 10);
+    for (int i = 0; i < 10; ++i)
+        single.update(0, 255);
+    CHECK(bulk.histogram() == single.histogram());
+    CHECK(bulk.nonzero_count() == 10);
+    CHECK(bulk.sum() == doctest::Approx(2550.0));
+
+    bulk.update(0, 255, 54);
+    CHECK(bulk.min() == doctest::Approx(255.0));
+    bulk.update(255, 0, 64);
+    CHECK(bulk.max() == doctest::Approx(0.0));
+    CHECK(bulk.count() == 64);
+}
+
+TEST_CASE("LayerStats follow the library's own layer writers") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Zone zone("Field", "field", make_rect(0, 0, 100, 50), datum, 1.0);
+    REQUIRE(zone.layer_count() == 1);
+    zone.grid().enable_layer_stats(0);
+    const auto &base = *zone.layer(0).gridIf<uint8_t>();
+
+    auto check_current = [&] {
+        const auto &live = zone.grid().layer_stats(0)->get();
+        LayerStats rescanned(base);
+        CHECK(rescanned.histogram() == live.histogram());
+        CHECK(rescanned.sum() == doctest::Approx(live.sum()));
+        CHECK(rescanned.min() == doctest::Approx(live.min()));
+        CHECK(rescanned.max() == doctest::Approx(live.max()));
+    };
+
+    SUBCASE("Polygon elements") {
+        zone.add_polygon_element(generateUUID(), 42, make_rect(10, 10, 40, 30), "Plot", "trial");
+        CHECK(zone.grid().layer_stats(0)->get().count_of(42) > 0);
+        check_current();
+    }
+
+    SUBCASE("Tile deltas") {
+        auto edited = base;
+        for (size_t c = 0; c < edited.cols; ++c)
+            edited(5, c) = 9;
+        auto delta = encode_tile_delta(base, edited);
+        apply_tile_delta(*zone.layer(0).gridIf<uint8_t>(), delta, zone.grid().mutable_layer_stats(0));
+        CHECK(base.data == edited.data);
+        check_current();
+    }
+}
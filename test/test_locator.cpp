@@ -0,0 +1,85 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    // Concave star-shaped field around (cx, cy)
+    dp::Polygon make_star(double cx, double cy, double radius, size_t points) {
+        dp::Polygon poly;
+        for (size_t i = 0; i < 2 * points; ++i) {
+            const double angle = M_PI * static_cast<double>(i) / static_cast<double>(points);
+            const double r = i % 2 == 0 ? radius : radius * 0.45;
+            poly.vertices.push_back({cx + r * std::cos(angle), cy + r * std::sin(angle), 0});
+        }
+        return poly;
+    }
+
+} // namespace
+
+TEST_CASE("Zone locator") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Plot plot("Farm", "agricultural", datum);
+    plot.add_zone(Zone("Square", "field", make_rect(0, 0, 40, 40), datum, 2.0));
+    plot.add_zone(Zone("Star", "field", make_star(80, 20, 25, 7), datum, 2.0));
+    plot.add_zone(Zone("Overlap", "field", make_rect(30, 30, 60, 50), datum, 2.0)); // overlaps the square
+    plot.add_zone(Zone("Far", "field", make_rect(200, -50, 230, -10), datum, 2.0));
+
+    SUBCASE("Agrees with zones_containing on random points") {
+        for (double cell : {0.0, 0.7, 5.0, 50.0}) {
+            ZoneLocator locator(plot, cell);
+            CHECK(locator.zone_count() == 4);
+            std::mt19937 rng(3);
+            std::uniform_real_distribution<double> x(-20, 250), y(-70, 70);
+            std::vector<dp::Point> points;
+            for (int i = 0; i < 5000; ++i) {
+                points.push_back({x(rng), y(rng), 0});
+            }
+            auto batch = locator.locate(points);
+            for (size_t i = 0; i < points.size(); ++i) {
+                auto expected = plot.zones_containing(points[i]);
+                auto all = locator.locate_all(points[i]);
+                REQUIRE(all.size() == expected.size());
+                for (size_t k = 0; k < all.size(); ++k) {
+                    CHECK(locator.id(all[k]) == expected[k].get().id());
+                }
+                CHECK(batch[i] == (expected.empty() ? ZoneLocator::npos : all[0]));
+                CHECK(locator.locate(points[i]) == batch[i]);
+            }
+        }
+    }
+
+    SUBCASE("Interior cells answer without polygon tests") {
+        ZoneLocator locator(plot, 1.0);
+        CHECK(locator.inside_ratio() > 0.5);
+        CHECK(locator.locate(dp::Point{20, 20, 0}) == 0);
+        CHECK(locator.locate(dp::Point{35, 35, 0}) == 0); // first zone wins where zones overlap
+        CHECK(locator.locate_all(dp::Point{35, 35, 0}) == std::vector<size_t>{0, 2});
+        CHECK(locator.locate(dp::Point{80, 20, 0}) == 1);
+        CHECK(locator.locate(dp::Point{-5, 20, 0}) == ZoneLocator::npos);
+        CHECK(locator.locate(dp::Point{1e9, 1e9, 0}) == ZoneLocator::npos);
+    }
+
+    SUBCASE("Batched output must match the input size") {
+        ZoneLocator locator(plot);
+        std::vector<dp::Point> points(3, dp::Point{20, 20, 0});
+        std::vector<size_t> out(2);
+        CHECK_THROWS_AS(locator.locate(points, out), std::invalid_argument);
+    }
+
+    SUBCASE("Plots without zones locate nothing") {
+        Plot empty("Empty", "agricultural", datum);
+        ZoneLocator locator(empty);
+        CHECK(locator.zone_count() == 0);
+        CHECK(locator.locate(dp::Point{0, 0, 0}) == ZoneLocator::npos);
+    }
+}
@@ -0,0 +1,94 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("Level-of-detail simplification and culling") {
+    // Densely sampled circle, closed
+    std::vector<dp::Point> ring;
+    for (int i = 0; i <= 1000; ++i) {
+        double t = 2.0 * M_PI * i / 1000.0;
+        ring.push_back({50.0 * std::cos(t), 50.0 * std::sin(t), 0.0});
+    }
+
+    SUBCASE("Zero tolerance keeps every vertex") { CHECK(lod::simplify(ring, 0.0).size() == ring.size()); }
+
+    SUBCASE("Coarser tolerance keeps fewer vertices, within tolerance of the original") {
+        auto fine = lod::simplify(ring, 0.01);
+        auto coarse = lod::simplify(ring, 1.0);
+        CHECK(coarse.size() < fine.size());
+        CHECK(fine.size() < ring.size());
+        CHECK(coarse.size() >= 4);
+        CHECK(coarse.front().x == ring.front().x);
+        CHECK(coarse.back().y == ring.back().y);
+        for (const auto &p : coarse)
+            CHECK(std::hypot(p.x, p.y) == doctest::Approx(50.0));
+    }
+
+    SUBCASE("Collinear points collapse to the endpoints") {
+        std::vector<dp::Point> line{{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0}};
+        CHECK(lod::simplify(line, 1e-6).size() == 2);
+    }
+
+    SUBCASE("Culling by extent") {
+        auto small = make_rect(0, 0, 0.2, 0.2).vertices;
+        CHECK(lod::visible(small, 0.0));
+        CHECK(lod::visible(small, 0.1));
+        CHECK_FALSE(lod::visible(small, 0.5));
+        CHECK_FALSE(lod::visible({}, 0.0));
+    }
+}
+
+TEST_CASE("Level-of-detail raster downsampling") {
+    SUBCASE("8-bit grids are box-filtered without rescaling") {
+        dp::Grid<uint8_t> grid(4, 6, 1.0, true, dp::Pose{}, 0);
+        for (size_t r = 0; r < 4; ++r)
+            for (size_t c = 0; c < 6; ++c)
+                grid(r, c) = (c < 2) ? 100 : 200;
+
+        auto image = lod::downsample(grid, 3);
+        CHECK(image.width == 3);
+        CHECK(image.height == 2);
+        REQUIRE(image.pixels.size() == 6);
+        CHECK(image.pixels[0] == 100);
+        CHECK(image.pixels[1] == 200);
+        CHECK(image.pixels[5] == 200);
+
+        auto full = lod::downsample(grid, 100);
+        CHECK(full.width == 6);
+        CHECK(full.height == 4);
+        CHECK_THROWS_AS(lod::downsample(grid, 0), std::invalid_argument);
+    }
+
+    SUBCASE("Wider types are stretched and NaN cells skipped") {
+        dp::Grid<float> grid(2, 4, 1.0, true, dp::Pose{}, 0.0f);
+        grid(0, 0) = 10.0f;
+        grid(0, 1) = 10.0f;
+        grid(1, 0) = NAN;
+        grid(1, 1) = 10.0f;
+        grid(0, 2) = 20.0f;
+        grid(0, 3) = 20.0f;
+        grid(1, 2) = 20.0f;
+        grid(1, 3) = 20.0f;
+
+        auto image = lod::downsample(grid, 2);
+        REQUIRE(image.pixels.size() == 2);
+        CHECK(image.pixels[0] == 0);
+        CHECK(image.pixels[1] == 255);
+    }
+
+    SUBCASE("Zone layers") {
+        dp::Geo datum{51.98776, 5.66238, 0.0};
+        Zone field("Field", "field", make_rect(0, 0, 400, 200), datum, 0.5);
+        auto image = lod::downsample(field.grid().get_layer(0), 128);
+        CHECK(image.width <= 128);
+        CHECK(image.height <= 128);
+        CHECK(image.width * image.height == image.pixels.size());
+    }
+}
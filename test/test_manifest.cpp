@@ -0,0 +1,233 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("Plot manifest persistence") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Plot plot("Farm", "agricultural", datum);
+    plot.set_property("owner", "Jane");
+    plot.set_property("crop", "wheat");
+    for (int z = 0; z < 3; ++z) {
+        plot.add_zone(Zone("Field " + std::to_string(z), "field", make_rect(0, 0, 20.0 + 10 * z, 10), datum, 1.0));
+    }
+
+    auto dir = std::filesystem::temp_directory_path() / "zoneout_test_manifest";
+    std::filesystem::remove_all(dir);
+    plot.save(dir);
+    REQUIRE(manifest::exists(dir));
+
+    SUBCASE("Manifest indexes the plot and its zone files") {
+        auto m = manifest::read(dir);
+        CHECK(m.id == plot.id());
+        CHECK(m.name == "Farm");
+        CHECK(m.properties.at("owner") == "Jane");
+        REQUIRE(m.zones.size() == 3);
+        for (size_t i = 0; i < 3; ++i) {
+            const auto &entry = m.zones[i];
+            CHECK(entry.id == plot.zones()[i].id());
+            CHECK(entry.bbox.max_point.x == doctest::Approx(20.0 + 10 * i));
+            CHECK(entry.vector.path == "zone_" + std::to_string(i) + "/vector.geojson");
+            CHECK(entry.vector.size == std::filesystem::file_size(dir / entry.vector.path));
+            CHECK(entry.vector.crc == manifest::describe(dir, entry.vector.path).crc);
+            CHECK(entry.raster.size == std::filesystem::file_size(dir / entry.raster.path));
+            CHECK(entry.raster.crc == manifest::describe(dir, entry.raster.path).crc);
+        }
+        CHECK(m.zone_by_name("Field 1")->get().id == plot.zones()[1].id());
+        CHECK_FALSE(m.zone(generateUUID()).has_value());
+    }
+
+    SUBCASE("Plot metadata and zone order survive a round trip") {
+        auto loaded = Plot::load(dir, "ignored", "ignored");
+        CHECK(loaded.id() == plot.id());
+        CHECK(loaded.name() == "Farm");
+        CHECK(loaded.type() == "agricultural");
+        CHECK(loaded.datum().latitude == doctest::Approx(datum.latitude));
+        CHECK(loaded.property("crop").value() == "wheat");
+        REQUIRE(loaded.zone_count() == 3);
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK(loaded.zones()[i].id() == plot.zones()[i].id());
+        }
+    }
+
+    SUBCASE("Single zones load without opening the others") {
+        std::filesystem::remove_all(dir / "zone_0");
+        auto zone = Plot::load_zone(dir, plot.zones()[2].id());
+        REQUIRE(zone.has_value());
+        CHECK(zone->name() == "Field 2");
+        CHECK_FALSE(Plot::load_zone(dir, generateUUID()).has_value());
+    }
+
+    SUBCASE("Tar archives carry the manifest") {
+        auto tar = std::filesystem::temp_directory_path() / "zoneout_test_manifest.tar";
+        plot.save_tar(tar);
+        auto loaded = Plot::load_tar(tar, "ignored", "ignored", dp::Geo{});
+        std::filesystem::remove(tar);
+        CHECK(loaded.name() == "Farm");
+        CHECK(loaded.property("owner").value() == "Jane");
+        CHECK(loaded.zone_count() == 3);
+    }
+
+    SUBCASE("Tar entries larger than a batch are streamed") {
+        fileio::Options streamed;
+        streamed.batch_bytes = 16;
+        auto tar = std::filesystem::temp_directory_path() / "zoneout_test_manifest_streamed.tar";
+        plot.save_tar(tar, streamed);
+        CHECK(Plot::verify(tar).ok());
+        auto loaded = Plot::load_tar(tar, "ignored", "ignored", dp::Geo{}, {true, true}, streamed);
+        std::filesystem::remove(tar);
+        CHECK(loaded.zone_count() == 3);
+        CHECK(loaded.zones()[1].name() == "Field 1");
+    }
+
+    SUBCASE("Concurrent tar saves of one plot do not share a staging directory") {
+        auto a = std::filesystem::temp_directory_path() / "zoneout_test_manifest_a.tar";
+        auto b = std::filesystem::temp_directory_path() / "zoneout_test_manifest_b.tar";
+        auto other = std::async(std::launch::async, [&] { plot.save_tar(b); });
+        plot.save_tar(a);
+        other.get();
+        CHECK(Plot::verify(a).ok());
+        CHECK(Plot::verify(b).ok());
+        std::filesystem::remove(a);
+        std::filesystem::remove(b);
+    }
+
+    SUBCASE("The thread-pool I/O backend writes identical plots") {
+        fileio::Options io;
+        io.backend = fileio::Backend::Threads;
+        io.batch_files = 2;
+        auto other = std::filesystem::temp_directory_path() / "zoneout_test_manifest_threads";
+        plot.save(other, io);
+        auto a = manifest::read(dir);
+        auto b = manifest::read(other);
+        REQUIRE(b.zones.size() == a.zones.size());
+        for (size_t i = 0; i < a.zones.size(); ++i) {
+            CHECK(b.zones[i].raster.crc == a.zones[i].raster.crc);
+            CHECK(b.zones[i].vector.size == a.zones[i].vector.size);
+        }
+        CHECK(manifest::verify(other, io).ok());
+
+        auto tar = std::filesystem::temp_directory_path() / "zoneout_test_manifest_threads.tar";
+        plot.save_tar(tar, io);
+        CHECK(Plot::load_tar(tar, "ignored", "ignored", dp::Geo{}, {true, true}, io).zone_count() == 3);
+        std::filesystem::remove(tar);
+        std::filesystem::remove_all(other);
+    }
+
+    SUBCASE("Describing files only tolerates a missing raster for zones without layers") {
+        auto saved = manifest::read(dir);
+        auto m = saved;
+        manifest::describe_files(dir, m);
+        CHECK(m.zones[1].raster.crc == saved.zones[1].raster.crc);
+
+        std::filesystem::remove(dir / saved.zones[1].raster.path);
+        m = saved;
+        CHECK_THROWS_AS(manifest::describe_files(dir, m), std::runtime_error);
+
+        m = saved;
+        m.zones[1].layers.clear();
+        manifest::describe_files(dir, m);
+        CHECK(m.zones[1].raster.path.empty());
+        CHECK(m.zones[0].raster.crc == saved.zones[0].raster.crc);
+    }
+
+    SUBCASE("Corrupt manifests are rejected") {
+        {
+            std::fstream file(dir / manifest::file_name, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(12);
+            file.put('X');
+        }
+        CHECK_THROWS_AS(manifest::read(dir), std::runtime_error);
+        CHECK_FALSE(manifest::try_read(dir).has_value());
+
+        // The zone directories are intact, so an unverified load falls back to scanning them
+        auto loaded = Plot::load(dir, "Recovered", "agricultural", datum);
+        CHECK(loaded.name() == "Recovered");
+        CHECK(loaded.zone_count() == 3);
+        CHECK(Plot::load_zone(dir, plot.zones()[2].id()).has_value());
+        CHECK_THROWS_AS(Plot::load(dir, "Recovered", "agricultural", datum, {true, false}), std::runtime_error);
+    }
+
+    SUBCASE("Verification streams the files against the manifest") {
+        auto report = Plot::verify(dir);
+        CHECK(report.ok());
+        CHECK(report.files == 6);
+        CHECK(report.bytes > 0);
+        CHECK_NOTHROW(Plot::load(dir, "Farm", "agricultural", datum, {true, true}));
+
+        const auto raster = dir / "zone_1" / "raster.tiff";
+        {
+            std::fstream file(raster, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekg(static_cast<std::streamoff>(std::filesystem::file_size(raster) / 2));
+            char byte = static_cast<char>(file.peek());
+            file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(raster) / 2));
+            file.put(static_cast<char>(byte ^ 0x5A));
+        }
+        std::filesystem::resize_file(dir / "zone_2" / "vector.geojson", 10);
+        std::filesystem::remove(dir / "zone_0" / "vector.geojson");
+
+        report = Plot::verify(dir);
+        REQUIRE(report.errors.size() == 3);
+        CHECK(report.errors[0] == "zone_0/vector.geojson: missing");
+        CHECK(report.errors[1] == "zone_1/raster.tiff: checksum mismatch");
+        CHECK(report.errors[2].find("zone_2/vector.geojson: size 10") == 0);
+        CHECK_THROWS_AS(Plot::load(dir, "Farm", "agricultural", datum, {true, false}), std::runtime_error);
+
+        // Files larger than a batch are streamed one at a time and report the same errors
+        fileio::Options streamed;
+        streamed.batch_bytes = 16;
+        auto again = manifest::verify(dir, streamed);
+        CHECK(again.errors == report.errors);
+        CHECK(again.bytes == report.bytes);
+    }
+
+    SUBCASE("Layer checksums catch corruption after decoding") {
+        auto m = manifest::read(dir);
+        REQUIRE(m.zones[1].layers.size() == plot.zones()[1].raster_data().layers.size());
+        CHECK(m.zones[1].layers[0] == manifest::layer_crc(plot.zones()[1].raster_data().layers[0]));
+        m.zones[1].layers[0] ^= 1;
+        manifest::write(dir, m);
+
+        CHECK(Plot::verify(dir).ok());
+        CHECK_NOTHROW(Plot::load(dir, "Farm", "agricultural", datum));
+        CHECK_THROWS_AS(Plot::load(dir, "Farm", "agricultural", datum, {false, true}), std::runtime_error);
+    }
+
+    SUBCASE("Tar archives verify in one pass") {
+        auto tar = std::filesystem::temp_directory_path() / "zoneout_test_manifest_verify.tar";
+        plot.save_tar(tar);
+        auto report = Plot::verify(tar);
+        CHECK(report.ok());
+        CHECK(report.files == 6);
+
+        {
+            std::fstream file(tar, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(tar) / 2));
+            file.put('\x7F');
+            file.put('\x01');
+        }
+        CHECK_FALSE(Plot::verify(tar).ok());
+        CHECK_FALSE(Plot::verify(dir / "missing.tar").ok());
+        std::filesystem::remove(tar);
+    }
+
+    SUBCASE("Directories without a manifest still load") {
+        std::filesystem::remove(dir / manifest::file_name);
+        auto loaded = Plot::load(dir, "Legacy", "agricultural", datum);
+        CHECK(loaded.name() == "Legacy");
+        CHECK(loaded.zone_count() == 3);
+        CHECK(Plot::load_zone(dir, plot.zones()[1].id()).has_value());
+        CHECK_FALSE(Plot::verify(dir).ok());
+        CHECK_THROWS_AS(Plot::load(dir, "Legacy", "agricultural", datum, {true, false}), std::runtime_error);
+    }
+
+    std::filesystem::remove_all(dir);
+}
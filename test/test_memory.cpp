@@ -0,0 +1,49 @@
+#include <doctest/doctest.h>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("Zone and Plot memory accounting") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Zone field("Field", "field", make_rect(0, 0, 100, 50), datum, 1.0);
+
+    auto base = field.memory_usage();
+    REQUIRE(base.raster_layer_bytes.size() == 1);
+    CHECK(base.raster_layer_bytes[0] >= field.layer_rows(0) * field.layer_cols(0));
+    CHECK(base.raster_bytes >= base.raster_layer_bytes[0]);
+    CHECK(base.total() > base.raster_bytes);
+
+    SUBCASE("Categories grow with what is added") {
+        field.add_coverage_layer();
+        field.grid().add_temporal_layer<float>("moisture", 4);
+        field.grid().enable_layer_stats(0);
+        for (int i = 0; i < 20; ++i) {
+            field.poly().add_polygon_element(generateUUID(), "obstacle_with_a_long_name_" + std::to_string(i),
+                                             "obstacle", "default", make_rect(i, i, i + 1, i + 1));
+        }
+        field.set_property("crop_type", "a property value long enough to leave the small string buffer");
+
+        auto grown = field.memory_usage();
+        CHECK(grown.raster_layer_bytes.size() == 2);
+        CHECK(grown.temporal_bytes >= 4 * field.layer_rows(0) * field.layer_cols(0) * sizeof(float));
+        CHECK(grown.stats_bytes >= 256 * sizeof(uint32_t));
+        CHECK(grown.element_geometry_bytes >= base.element_geometry_bytes + 20 * 4 * sizeof(dp::Point));
+        CHECK(grown.element_property_bytes > base.element_property_bytes);
+        CHECK(grown.property_bytes > base.property_bytes);
+    }
+
+    SUBCASE("Plot sums its zones") {
+        Plot plot("Farm", "agricultural", datum);
+        plot.add_zone(field);
+        plot.add_zone(field);
+        auto usage = plot.memory_usage();
+        CHECK(usage.raster_layer_bytes.size() == 2);
+        CHECK(usage.raster_bytes == 2 * base.raster_bytes);
+        CHECK(usage.total() > 2 * base.raster_bytes);
+        CHECK(usage.to_string().find("total=") == 0);
+    }
+}
@@ -0,0 +1,71 @@
+// Instrumentation is compiled out by default; this test turns it on for its own translation unit
+#ifndef ZONEOUT_METRICS
+#define ZONEOUT_METRICS
+#endif
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("Metrics counters and timers") {
+    metrics::reset();
+
+    SUBCASE("Scoped timers and counters record") {
+        {
+            ZONEOUT_METRIC_TIMER("test.scope");
+            ZONEOUT_METRIC_COUNT("test.items", 3);
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([] {
+                for (int i = 0; i < 1000; ++i)
+                    ZONEOUT_METRIC_COUNT("test.items", 1);
+            });
+        }
+        for (auto &worker : workers)
+            worker.join();
+
+        auto snapshot = metrics::collect();
+        CHECK(snapshot.counters.at("test.items") == 4003);
+        CHECK(snapshot.timers.at("test.scope").count == 1);
+        CHECK(snapshot.timers.at("test.scope").min_ns <= snapshot.timers.at("test.scope").max_ns);
+
+        metrics::reset();
+        CHECK(metrics::collect().counters.at("test.items") == 0);
+    }
+
+    SUBCASE("Library hot paths are instrumented") {
+        dp::Geo datum{51.98776, 5.66238, 0.0};
+        Plot plot("Farm", "agricultural", datum);
+        Zone field("Field", "field", make_rect(0, 0, 40, 20), datum, 1.0);
+        plot.add_zone(field);
+
+        auto dir = std::filesystem::temp_directory_path() / "zoneout_test_metrics";
+        std::filesystem::remove_all(dir);
+        plot.save(dir);
+        auto loaded = Plot::load(dir, "Farm", "agricultural", datum);
+        std::filesystem::remove_all(dir);
+        REQUIRE(loaded.zone_count() == 1);
+
+        auto snapshot = metrics::collect();
+        CHECK(snapshot.counters.at("zone.cells_rasterized") >= 40 * 20);
+        CHECK(snapshot.counters.at("zone.bytes_written") > 0);
+        CHECK(snapshot.timers.at("plot.save").count == 1);
+        CHECK(snapshot.timers.at("plot.load").count == 1);
+        CHECK(snapshot.timers.at("zone.from_files").count == 1);
+
+        std::ostringstream out;
+        metrics::dump(out);
+        CHECK(out.str().find("plot.load: count=1") != std::string::npos);
+    }
+}
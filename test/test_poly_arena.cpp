@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    std::pmr::memory_resource *resource_of(const StructuredElement &element) {
+        return element.properties.get_allocator().resource();
+    }
+
+} // namespace
+
+TEST_CASE("Poly element arena") {
+    Poly poly("Field", "field", "default", make_rect(0, 0, 100, 50));
+    for (int i = 0; i < 8; ++i) {
+        poly.add_polygon_element(generateUUID(), "obstacle" + std::to_string(i), "obstacle", "default",
+                                 make_rect(i, i, i + 1, i + 1), {{"height", std::to_string(i)}});
+    }
+    poly.add_line_element(generateUUID(), "row", "row", "default", dp::Segment{{0, 0, 0}, {10, 0, 0}});
+    poly.add_point_element(generateUUID(), "well", "water", "default", dp::Point{5, 5, 0},
+                           {{"depth", "12"}, {"description", "Drilled well feeding the east irrigation line"}});
+
+    auto *arena = resource_of(poly.polygon_elements().front());
+    CHECK(arena != std::pmr::get_default_resource());
+    for (const auto &e : poly.polygon_elements())
+        CHECK(resource_of(e) == arena);
+    CHECK(resource_of(poly.line_elements().front()) == arena);
+    CHECK(resource_of(poly.point_elements().front()) == arena);
+
+    // Keys and values live in the arena too, not only the map nodes
+    const auto &well = poly.point_elements().front().properties;
+    auto description = well.find("description");
+    REQUIRE(description != well.end());
+    CHECK(description->first.get_allocator().resource() == arena);
+    CHECK(description->second.get_allocator().resource() == arena);
+
+    SUBCASE("Elements handed out by value do not reference the arena") {
+        auto found = poly.polygon_element(poly.polygon_elements().front().uuid);
+        REQUIRE(found.has_value());
+        CHECK(resource_of(*found) == std::pmr::get_default_resource());
+        CHECK(found->properties.at("height") == "0");
+    }
+
+    SUBCASE("Copies get their own arena, moves keep it") {
+        Poly copy = poly;
+        REQUIRE(copy.polygon_elements().size() == 8);
+        CHECK(resource_of(copy.polygon_elements().front()) != arena);
+        CHECK(copy.polygon_elements()[3].properties.at("height") == "3");
+
+        Poly moved = std::move(poly);
+        CHECK(resource_of(moved.polygon_elements().front()) == arena);
+
+        copy = std::move(moved);
+        CHECK(resource_of(copy.polygon_elements().front()) == arena);
+        CHECK(copy.point_elements().front().properties.at("depth") == "12");
+    }
+
+    SUBCASE("Compaction rebuilds the survivors into a fresh arena") {
+        for (int i = 0; i < 6; ++i)
+            poly.remove_polygon_element(poly.polygon_elements().front().uuid);
+        poly.compact_elements();
+        REQUIRE(poly.polygon_elements().size() == 2);
+        CHECK(resource_of(poly.polygon_elements().front()) != std::pmr::get_default_resource());
+        CHECK(poly.polygon_elements()[0].properties.at("height") == "6");
+        CHECK(poly.polygon_elements()[1].properties.at("height") == "7");
+        CHECK(poly.line_elements().size() == 1);
+    }
+
+    SUBCASE("Heavy removal compacts the arena on its own") {
+        std::vector<UUID> posts;
+        for (int i = 0; i < 300; ++i) {
+            posts.push_back(generateUUID());
+            poly.add_point_element(posts.back(), "post", "post", "default", dp::Point{1, 1, 0}, {{"n", "1"}});
+        }
+        for (const auto &id : posts)
+            CHECK(poly.remove_point_element(id));
+
+        REQUIRE(poly.polygon_elements().size() == 8);
+        CHECK(resource_of(poly.polygon_elements().front()) != arena);
+        CHECK(resource_of(poly.polygon_elements().front()) != std::pmr::get_default_resource());
+        CHECK(poly.polygon_elements()[7].properties.at("height") == "7");
+        CHECK(poly.point_elements().front().properties.at("depth") == "12");
+    }
+
+    SUBCASE("Reload allocates elements from the arena") {
+        auto path = std::filesystem::temp_directory_path() / "zoneout_test_poly_arena.geojson";
+        poly.to_file(path);
+        auto loaded = Poly::from_file(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(loaded.polygon_elements().size() == 8);
+        CHECK(resource_of(loaded.polygon_elements().front()) != std::pmr::get_default_resource());
+        CHECK(resource_of(loaded.point_elements().front()) == resource_of(loaded.polygon_elements().front()));
+        CHECK(loaded.point_elements().front().properties.at("depth") == "12");
+
+        loaded.clear_all_elements();
+        CHECK(loaded.polygon_elements().empty());
+        loaded.add_polygon_element(make_rect(1, 1, 2, 2), "obstacle");
+        CHECK(loaded.polygon_elements().size() == 1);
+    }
+}
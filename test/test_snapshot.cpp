@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+    const dp::Geo DATUM{51.98776, 5.66238, 0.0};
+
+    Plot make_plot() {
+        Plot plot("farm", "agricultural", DATUM);
+        plot.add_zone(Zone("north", "field", make_rect(0, 0, 50, 50), DATUM, 5.0));
+        plot.add_zone(Zone("south", "field", make_rect(0, -60, 50, -10), DATUM, 5.0));
+        plot.set_property("owner", "wur");
+        return plot;
+    }
+} // namespace
+
+TEST_CASE("PlotSnapshot queries") {
+    Plot plot = make_plot();
+    PlotSnapshot snap(plot);
+
+    CHECK(snap.version() == 0);
+    CHECK(snap.id() == plot.id());
+    CHECK(snap.zone_count() == 2);
+    CHECK(snap.property("owner").value_or("") == "wur");
+    CHECK(snap.zone_by_name("north").has_value());
+    CHECK_FALSE(snap.zone_by_name("east").has_value());
+    CHECK(snap.zone(plot.zones()[1].id())->get().name() == "south");
+    CHECK(snap.zones_containing(dp::Point{10, 10, 0}).size() == 1);
+    CHECK(snap.zones_containing(dp::Point{10, -30, 0})[0].get().name() == "south");
+    CHECK(snap.zones_containing(dp::Point{100, 100, 0}).empty());
+
+    Plot round_trip = snap.to_plot();
+    CHECK(round_trip.zone_count() == 2);
+    CHECK(round_trip.id() == plot.id());
+}
+
+TEST_CASE("SharedPlot copy-on-write publishing") {
+    SharedPlot shared(make_plot());
+    auto v0 = shared.snapshot();
+    auto north_id = v0->zone_by_name("north")->get().id();
+
+    auto version = shared.update([&](PlotTransaction &txn) {
+        auto zone = txn.edit_zone(north_id);
+        REQUIRE(zone.has_value());
+        zone->get().set_property("crop", "wheat");
+        txn.add_zone(Zone("east", "field", make_rect(60, 0, 80, 20), DATUM, 5.0));
+    });
+
+    auto v1 = shared.snapshot();
+    CHECK(version == 1);
+    CHECK(v1->version() == 1);
+    CHECK(v1->zone_count() == 3);
+
+    // Old readers keep seeing the old version
+    CHECK(v0->zone_count() == 2);
+    CHECK_FALSE(v0->zone(north_id)->get().has_property("crop"));
+    CHECK(v1->zone(north_id)->get().property("crop").value_or("") == "wheat");
+
+    // Untouched zones are shared, edited ones are not
+    CHECK(v0->zones()[1].get() == v1->zones()[1].get());
+    CHECK(v0->zones()[0].get() != v1->zones()[0].get());
+
+    shared.update([&](PlotTransaction &txn) { CHECK(txn.remove_zone(north_id)); });
+    CHECK(shared.snapshot()->zone_count() == 2);
+    CHECK_FALSE(shared.snapshot()->has_zone(north_id));
+}
+
+TEST_CASE("SharedPlot concurrent readers and writer") {
+    SharedPlot shared(make_plot());
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> reads{0};
+    std::atomic<bool> inconsistent{false};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                auto snap = shared.snapshot();
+                // Every published version has exactly 2 + version zones
+                if (snap->zone_count() != 2 + snap->version()) {
+                    inconsistent = true;
+                }
+                if (snap->zones_containing(dp::Point{10, 10, 0}).empty()) {
+                    inconsistent = true;
+                }
+                reads++;
+            }
+        });
+    }
+
+    while (reads.load() == 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 20; ++i) {
+        shared.update([&](PlotTransaction &txn) {
+            txn.add_zone(Zone("extra" + std::to_string(i), "field", make_rect(100 + i * 10, 0, 105 + i * 10, 5), DATUM, 5.0));
+        });
+    }
+    stop = true;
+    for (auto &r : readers) {
+        r.join();
+    }
+
+    CHECK_FALSE(inconsistent.load());
+    CHECK(reads.load() > 0);
+    CHECK(shared.version() == 20);
+    CHECK(shared.snapshot()->zone_count() == 22);
+}
@@ -0,0 +1,238 @@
+#include <doctest/doctest.h>
+
+#include <string>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    const dp::Grid<uint8_t> &base_layer(const Plot &plot, const UUID &zone_id) {
+        return *plot.zone(zone_id)->get().layer(0).gridIf<uint8_t>();
+    }
+
+} // namespace
+
+TEST_CASE("SyncTracker delta synchronization between two replicas") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+
+    Plot robot_a("Farm", "agricultural", datum);
+    Zone field("Field", "field", make_rect(0, 0, 600, 300), datum, 1.0);
+    field.set_property("crop_type", "wheat");
+    field.poly().add_point_element(generateUUID(), "Well", "water", "default", dp::Point{50, 50, 0});
+    robot_a.add_zone(field);
+
+    Plot robot_b("Empty", "agricultural", datum);
+    SyncTracker tracker_a;
+    SyncTracker tracker_b;
+
+    SUBCASE("Full transfer creates the zone on the peer") {
+        auto delta = tracker_a.encode_delta(robot_a, 0);
+        CHECK(tracker_b.apply_delta(robot_b, delta) > 0);
+
+        REQUIRE(robot_b.has_zone(field.id()));
+        const auto &zone_b = robot_b.zone(field.id())->get();
+        CHECK(zone_b.name() == "Field");
+        CHECK(zone_b.property("crop_type").value_or("") == "wheat");
+        CHECK(zone_b.poly().point_elements().size() == 1);
+        REQUIRE(zone_b.layer_count() == 1);
+        CHECK(base_layer(robot_b, field.id()).data == base_layer(robot_a, field.id()).data);
+
+        // Nothing changed on B, so B has nothing new to report
+        uint64_t synced = tracker_b.sequence();
+        auto echo = tracker_b.encode_delta(robot_b, synced);
+        CHECK(tracker_a.apply_delta(robot_a, echo) == 0);
+    }
+
+    SUBCASE("Incremental deltas only carry changed tiles and elements") {
+        auto full = tracker_a.encode_delta(robot_a, 0);
+        tracker_b.apply_delta(robot_b, full);
+        uint64_t since = tracker_a.sequence();
+        uint64_t time_before = tracker_a.time();
+
+        auto &zone_a = robot_a.zone(field.id())->get();
+        tracker_a.edit_raster_layer<uint8_t>(robot_a, field.id(), 0,
+                                             [](TileEdit<uint8_t> &edit) { edit.set(1, 1, 42); });
+        zone_a.poly().add_line_element(generateUUID(), "Path", "track", "default",
+                                       dp::Segment{dp::Point{0, 0, 0}, dp::Point{10, 10, 0}});
+
+        auto delta = tracker_a.encode_delta(robot_a, since);
+        CHECK(full.size() < 20000);
+        CHECK(delta.size() < 1024);
+        CHECK(tracker_b.apply_delta(robot_b, delta) == 2);
+
+        CHECK(base_layer(robot_b, field.id())(1, 1) == 42);
+        CHECK(robot_b.zone(field.id())->get().poly().line_elements().size() == 1);
+
+        auto tile = tracker_b.stamp_of(sync::Key::layer_tile(field.id(), 0, 0));
+        REQUIRE(tile.has_value());
+        CHECK(tile->time > time_before);
+    }
+
+    SUBCASE("Raw cell writes are only rehashed once reported") {
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+        uint64_t since = tracker_a.sequence();
+
+        auto &grid = *robot_a.zone(field.id())->get().layer(0).gridIf<uint8_t>();
+        grid(0, 0) = 7;
+        grid(300, 500) = 9;
+        CHECK(tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, since)) == 0);
+
+        TileChanges changes(grid);
+        changes.mark(300, 500);
+        tracker_a.mark_tiles(field.id(), 0, changes);
+        CHECK(tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, since)) == 1);
+        CHECK(base_layer(robot_b, field.id())(300, 500) == 9);
+        CHECK(base_layer(robot_b, field.id())(0, 0) == 0);
+
+        changes.mark_all();
+        tracker_a.mark_tiles(field.id(), 0, changes);
+        CHECK(tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, tracker_a.sequence())) == 1);
+        CHECK(base_layer(robot_b, field.id()).data == base_layer(robot_a, field.id()).data);
+    }
+
+    SUBCASE("Polygon elements carry the cells they paint") {
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+        uint64_t since = tracker_a.sequence();
+
+        auto &zone_a = robot_a.zone(field.id())->get();
+        zone_a.add_polygon_element(generateUUID(), 200, make_rect(400, 100, 480, 160), "Plot", "trial");
+        REQUIRE(base_layer(robot_a, field.id()).data != base_layer(robot_b, field.id()).data);
+
+        CHECK(tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, since)) > 1);
+        CHECK(robot_b.zone(field.id())->get().poly().polygon_elements().size() == 1);
+        CHECK(base_layer(robot_b, field.id()).data == base_layer(robot_a, field.id()).data);
+    }
+
+    SUBCASE("Concurrent edits converge last writer wins and removals propagate") {
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+        uint64_t a_sent = tracker_a.sequence();
+        uint64_t b_sent = tracker_b.sequence();
+
+        robot_a.zone(field.id())->get().set_property("crop_type", "barley");
+        tracker_a.stamp(robot_a);
+        robot_b.zone(field.id())->get().set_property("crop_type", "maize");
+        tracker_b.stamp(robot_b);
+        tracker_b.stamp(robot_b);
+        robot_b.set_property("owner", "wur");
+
+        auto from_a = tracker_a.encode_delta(robot_a, a_sent);
+        auto from_b = tracker_b.encode_delta(robot_b, b_sent);
+        tracker_b.apply_delta(robot_b, from_a);
+        tracker_a.apply_delta(robot_a, from_b);
+
+        auto crop_a = robot_a.zone(field.id())->get().property("crop_type").value_or("");
+        auto crop_b = robot_b.zone(field.id())->get().property("crop_type").value_or("");
+        CHECK(crop_a == crop_b);
+        CHECK(robot_a.property("owner").value_or("") == "wur");
+
+        a_sent = tracker_a.sequence();
+        robot_a.remove_zone(field.id());
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, a_sent));
+        CHECK_FALSE(robot_b.has_zone(field.id()));
+    }
+
+    SUBCASE("Changes relay through an intermediate replica") {
+        // Hub B hears from A and C; C only ever talks to B
+        Plot robot_c("Empty", "agricultural", datum);
+        SyncTracker tracker_c;
+
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+        uint64_t a_to_b = tracker_a.sequence();
+        tracker_c.apply_delta(robot_c, tracker_b.encode_delta(robot_b, 0));
+        uint64_t b_to_c = tracker_b.sequence();
+        REQUIRE(robot_c.has_zone(field.id()));
+
+        // B makes many local edits, pushing its Lamport time (and C's cursor) far beyond A's
+        for (int i = 0; i < 20; ++i) {
+            robot_b.set_property("tick", std::to_string(i));
+            tracker_b.stamp(robot_b);
+        }
+        tracker_c.apply_delta(robot_c, tracker_b.encode_delta(robot_b, b_to_c));
+        b_to_c = tracker_b.sequence();
+        REQUIRE(tracker_b.time() > tracker_a.time() + 10);
+
+        // A's edit carries A's small Lamport time, yet must still reach C via B
+        robot_a.zone(field.id())->get().set_property("crop_type", "rye");
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, a_to_b));
+        auto relayed = tracker_b.encode_delta(robot_b, b_to_c);
+        CHECK(tracker_c.apply_delta(robot_c, relayed) == 1);
+
+        CHECK(robot_c.zone(field.id())->get().property("crop_type").value_or("") == "rye");
+        CHECK(robot_c.property("tick").value_or("") == "19");
+    }
+
+    SUBCASE("Layer properties removed on the sender are removed on the peer") {
+        auto &layers_a = robot_a.zone(field.id())->get().grid().raster().layers;
+        layers_a[0].setGlobalProperty("note", "calibrated");
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+        const auto &layers_b = robot_b.zone(field.id())->get().grid().raster().layers;
+        CHECK(layers_b[0].getGlobalProperty("note") == "calibrated");
+        uint64_t a_to_b = tracker_a.sequence();
+        uint64_t b_to_a = tracker_b.sequence();
+
+        const auto &tagged = layers_a[0];
+        rastkit::Layer retagged;
+        retagged.width = tagged.width;
+        retagged.height = tagged.height;
+        retagged.datum = tagged.datum;
+        retagged.shift = tagged.shift;
+        retagged.resolution = tagged.resolution;
+        retagged.grid = tagged.grid;
+        for (const auto &[key, value] : layers_a[0].getGlobalProperties()) {
+            if (key != "note")
+                retagged.setGlobalProperty(key, value);
+        }
+        layers_a[0] = std::move(retagged);
+        tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, a_to_b));
+        CHECK(layers_b[0].getGlobalProperties() == layers_a[0].getGlobalProperties());
+
+        // Both sides now agree, so nothing bounces back
+        CHECK(tracker_a.apply_delta(robot_a, tracker_b.encode_delta(robot_b, b_to_a)) == 0);
+    }
+
+    SUBCASE("Corrupted deltas are rejected") {
+        auto delta = tracker_a.encode_delta(robot_a, 0);
+        delta[delta.size() / 2] ^= 0x5A;
+        CHECK_THROWS_AS(tracker_b.apply_delta(robot_b, delta), std::runtime_error);
+    }
+}
+
+TEST_CASE("SyncTracker full deltas carry every element of every zone") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Plot robot_a("Farm", "agricultural", datum);
+    for (int z = 0; z < 2; ++z) {
+        Zone zone("Field " + std::to_string(z), "field", make_rect(0, 0, 40, 20), datum, 1.0);
+        for (int i = 0; i < 50; ++i) {
+            const double x = i % 10;
+            zone.poly().add_polygon_element(generateUUID(), "Patch " + std::to_string(i), "patch", "default",
+                                            make_rect(x, 0, x + 1, 1));
+            zone.poly().add_line_element(generateUUID(), "Row " + std::to_string(i), "row", "default",
+                                         dp::Segment{dp::Point{x, 0, 0}, dp::Point{x, 10, 0}});
+            zone.poly().add_point_element(generateUUID(), "Post " + std::to_string(i), "post", "default",
+                                          dp::Point{x, 5, 0});
+        }
+        robot_a.add_zone(zone);
+    }
+
+    Plot robot_b("Empty", "agricultural", datum);
+    SyncTracker tracker_a;
+    SyncTracker tracker_b;
+    tracker_b.apply_delta(robot_b, tracker_a.encode_delta(robot_a, 0));
+
+    REQUIRE(robot_b.zone_count() == 2);
+    for (const auto &zone : robot_a.zones()) {
+        const auto &peer = robot_b.zone(zone.id())->get().poly();
+        CHECK(peer.polygon_elements().size() == 50);
+        CHECK(peer.line_elements().size() == 50);
+        CHECK(peer.point_elements().size() == 50);
+        const auto &post = zone.poly().point_elements()[17];
+        auto copy = peer.point_element(post.uuid);
+        REQUIRE(copy.has_value());
+        CHECK(copy->name == post.name);
+    }
+}
@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+
+#include "zoneout/zoneout.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("TemporalLayer ring buffer") {
+    const auto t0 = time_utils::fromMilliseconds(1'700'000'000'000ull);
+    auto at = [&](int seconds) { return t0 + time_utils::seconds(seconds); };
+
+    TemporalLayer<uint8_t> layer(4, 5, 3);
+    CHECK(layer.empty());
+    CHECK(layer.at(at(0)).empty());
+
+    for (int i = 0; i < 5; ++i) {
+        auto cells = layer.push(at(i * 10));
+        cells[0] = static_cast<uint8_t>(i + 1);
+        cells[7] = static_cast<uint8_t>(10 * (5 - i));
+    }
+
+    SUBCASE("Oldest slices are overwritten") {
+        CHECK(layer.size() == 3);
+        CHECK(layer.full());
+        CHECK(layer.time(0) == at(20));
+        CHECK(layer.latest_time() == at(40));
+        CHECK(layer.latest()[0] == 5);
+    }
+
+    SUBCASE("New slices start from the previous one") {
+        auto cells = layer.push(at(50));
+        CHECK(cells[0] == 5);
+        CHECK(cells[7] == 10);
+    }
+
+    SUBCASE("Lookup by time") {
+        CHECK(layer.at(at(19)).empty());
+        CHECK(layer.value_at(at(20), 0, 0) == 3);
+        CHECK(layer.value_at(at(35), 0, 0) == 4);
+        CHECK(layer.value_at(at(1000), 0, 0) == 5);
+        REQUIRE(layer.index_at(at(30)).has_value());
+        CHECK(*layer.index_at(at(30)) == 1);
+    }
+
+    SUBCASE("Temporal reductions") {
+        auto max_grid = layer.max_over(at(20), at(40));
+        CHECK(max_grid(0, 0) == 5);
+        CHECK(max_grid(1, 2) == 30);
+
+        auto min_grid = layer.min_over(time_utils::seconds(10));
+        CHECK(min_grid(0, 0) == 4);
+
+        auto mean_grid = layer.mean_over(at(30), at(40));
+        CHECK(mean_grid(0, 0) == doctest::Approx(4.5));
+        CHECK(mean_grid(1, 2) == doctest::Approx(15.0));
+
+        CHECK(layer.count_in(at(25), at(45)) == 2);
+        CHECK(layer.mean_over(at(100), at(200))(0, 0) == 0.0);
+    }
+
+    SUBCASE("Out of order pushes are rejected") {
+        CHECK_THROWS_AS(layer.push(at(0)), std::invalid_argument);
+    }
+
+    SUBCASE("A default-constructed layer rejects pushes") {
+        TemporalLayer<uint8_t> empty;
+        CHECK(empty.capacity() == 0);
+        CHECK_THROWS_AS(empty.push(at(0)), std::logic_error);
+    }
+}
+
+TEST_CASE("Grid temporal layers") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    dp::Polygon boundary;
+    boundary.vertices = {{0, 0, 0}, {40, 0, 0}, {40, 20, 0}, {0, 20, 0}};
+    Zone zone("Field", "field", boundary, datum, 1.0);
+
+    auto &series = zone.grid().add_temporal_layer<float>("moisture", 4);
+    CHECK(series.rows() == zone.layer_rows(0));
+    CHECK(series.cols() == zone.layer_cols(0));
+    CHECK_THROWS_AS(zone.grid().add_temporal_layer<float>("moisture", 4), std::invalid_argument);
+    CHECK_FALSE(zone.grid().temporal_layer<uint8_t>("moisture").has_value());
+
+    const auto t0 = time_utils::fromMilliseconds(1'700'000'000'000ull);
+    for (int i = 0; i < 6; ++i) {
+        series.push(t0 + time_utils::minutes(i))[3] = 0.1f * static_cast<float>(i);
+    }
+    CHECK(zone.layer_count() == 1);
+
+    SUBCASE("Slices round-trip through save/load") {
+        zone.grid().add_temporal_layer<uint8_t>("coverage", 2);
+        std::filesystem::path dir = "/tmp/zoneout_test_temporal";
+        std::filesystem::remove_all(dir);
+        zone.save(dir);
+        CHECK(zone.layer_count() == 1); // slices are written from a separate collection, never appended here
+
+        auto loaded = Zone::load(dir);
+        CHECK(loaded.layer_count() == 1);
+        CHECK(loaded.grid().temporal_layer_count() == 2);
+        auto moisture = loaded.grid().temporal_layer<float>("moisture");
+        REQUIRE(moisture.has_value());
+        CHECK(moisture->get().size() == 4);
+        CHECK(moisture->get().capacity() == 4);
+        CHECK(moisture->get().latest_time() == t0 + time_utils::minutes(5));
+        CHECK(moisture->get().latest()[3] == doctest::Approx(0.5f));
+        std::filesystem::remove_all(dir);
+    }
+
+    SUBCASE("Writing tags the output without touching the live layers") {
+        auto &grid = zone.grid();
+        grid.raster().layers[0].setGlobalProperty("name", "stale");
+        std::filesystem::path file = "/tmp/zoneout_test_temporal_tags.tiff";
+        grid.to_file(file);
+        CHECK(grid.layer_count() == 1);
+        CHECK(grid.get_layer(0).getGlobalProperty("name") == "stale");
+
+        auto loaded = Grid::from_file(file);
+        CHECK(loaded.name() == grid.name());
+        CHECK(loaded.temporal_layer_count() == 1);
+        std::filesystem::remove(file);
+    }
+
+    CHECK(zone.grid().remove_temporal_layer("moisture"));
+    CHECK_FALSE(zone.grid().has_temporal_layer("moisture"));
+}
@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#include "zoneout/zoneout.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+TEST_CASE("RLE round-trips and compresses runs") {
+    std::string raw(5000, '\0');
+    raw.replace(100, 6, "abcdef");
+    raw.replace(2000, 3, "\x01\x01\x02");
+    std::fill(raw.begin() + 3000, raw.begin() + 4000, '\x07');
+
+    auto packed = tile_delta::compress(raw);
+    CHECK(packed.size() < 50);
+    CHECK(tile_delta::decompress(packed) == raw);
+
+    std::string noisy;
+    for (int i = 0; i < 1000; ++i)
+        noisy.push_back(static_cast<char>(i * 37));
+    CHECK(tile_delta::decompress(tile_delta::compress(noisy)) == noisy);
+    CHECK(tile_delta::decompress(tile_delta::compress("")).empty());
+}
+
+TEST_CASE("Tile change tracking and XOR deltas") {
+    auto base = dp::make_grid<uint8_t>(300, 500, 0.5, true, dp::Pose{}, uint8_t(0));
+
+    SUBCASE("Marked cells map to tiles") {
+        TileChanges changes(base);
+        CHECK(changes.tile_count() == 5 * 8);
+        CHECK(changes.empty());
+        changes.mark(0, 0);
+        changes.mark(63, 63);
+        changes.mark_rect(100, 100, 130, 200);
+        CHECK(changes.is_dirty(0));
+        CHECK(changes.dirty_count() == 1 + 2 * 3);
+        changes.clear();
+        CHECK(changes.empty());
+    }
+
+    SUBCASE("Out of range cells and tiles are rejected") {
+        TileChanges changes(base);
+        // Column 500 would otherwise land in the first tile of the next tile row
+        CHECK_THROWS_AS(changes.mark(0, 500), std::out_of_range);
+        CHECK_THROWS_AS(changes.mark(300, 0), std::out_of_range);
+        CHECK_THROWS_AS(changes.mark_tile(changes.tile_count()), std::out_of_range);
+        CHECK_THROWS_AS(changes.is_dirty(64 * changes.words().size()), std::out_of_range);
+        CHECK(changes.empty());
+    }
+
+    SUBCASE("A driven strip encodes to a small delta") {
+        auto current = base;
+        for (size_t r = 10; r < 290; ++r) {
+            for (size_t c = 200; c < 206; ++c) {
+                current(r, c) = 1;
+            }
+        }
+
+        auto changes = diff_tiles(base, current);
+        CHECK(changes.dirty_count() == 5);
+
+        auto delta = encode_tile_delta(base, current);
+        CHECK(delta.size() < 2000);
+
+        auto patched = base;
+        apply_tile_delta(patched, delta);
+        CHECK(patched.data == current.data);
+    }
+
+    SUBCASE("Copy-on-write edits save only the tiles they touch") {
+        auto edited = base;
+        TileEdit<uint8_t> edit(edited);
+        for (size_t r = 10; r < 290; ++r) {
+            auto cells = edit.row(r, 200, 206);
+            std::fill(cells.begin(), cells.end(), uint8_t{1});
+        }
+        edit.set(299, 499, 0); // touched, but unchanged
+        CHECK(edit.touched().dirty_count() == 6);
+
+        auto changes = edit.changes();
+        CHECK(changes.words() == diff_tiles(base, edited).words());
+        CHECK(edit.delta(changes) == encode_tile_delta(base, edited));
+
+        edit.restore();
+        CHECK(edited.data == base.data);
+        CHECK_THROWS_AS(edit.set(300, 0, 1), std::out_of_range);
+    }
+
+    SUBCASE("Wider cell types") {
+        auto wide = dp::make_grid<float>(70, 70, 1.0, true, dp::Pose{}, 1.5f);
+        auto edited = wide;
+        edited(69, 69) = -3.0f;
+        auto delta = encode_tile_delta(wide, edited);
+        apply_tile_delta(wide, delta);
+        CHECK(wide(69, 69) == -3.0f);
+        CHECK(wide(0, 0) == 1.5f);
+
+        auto other_shape = dp::make_grid<float>(10, 10, 1.0, true, dp::Pose{}, 0.0f);
+        CHECK_THROWS_AS(apply_tile_delta(other_shape, delta), std::runtime_error);
+    }
+}
+
+TEST_CASE("Journaled layer edits store tile deltas") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    std::filesystem::path dir = "/tmp/zoneout_test_tile_delta_journal";
+    std::filesystem::remove_all(dir);
+
+    dp::Polygon boundary;
+    boundary.vertices = {{0, 0, 0}, {400, 0, 0}, {400, 200, 0}, {0, 200, 0}};
+    Zone zone("Field", "field", boundary, datum, 1.0);
+
+    {
+        auto journaled = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+        journaled.add_zone(zone);
+        size_t before = journaled.journal_size();
+        journaled.edit_raster_layer<uint8_t>(zone.id(), 0, [](TileEdit<uint8_t> &edit) {
+            for (size_t c = 0; c < edit.cols(); ++c)
+                edit.set(5, c, 9);
+            CHECK(edit.touched().dirty_count() == tile_delta::tiles_across(edit.cols()));
+        });
+        CHECK(journaled.journal_size() - before < 512);
+
+        // No-op edits append nothing, including writes of the value already there
+        size_t after = journaled.journal_size();
+        journaled.edit_raster_layer<uint8_t>(zone.id(), 0, [](TileEdit<uint8_t> &) {});
+        journaled.edit_raster_layer<uint8_t>(zone.id(), 0, [](TileEdit<uint8_t> &edit) {
+            auto cells = edit.row(5, 0, edit.cols());
+            std::fill(cells.begin(), cells.end(), uint8_t{9});
+        });
+        CHECK(journaled.journal_size() == after);
+        CHECK_THROWS_AS(journaled.edit_raster_layer<float>(zone.id(), 0, [](TileEdit<float> &) {}),
+                        std::invalid_argument);
+
+        // A throwing edit leaves the layer as it was and journals nothing
+        const uint8_t original = journaled.plot().zone(zone.id())->get().layer(0).gridIf<uint8_t>()->operator()(7, 3);
+        CHECK_THROWS_AS(journaled.edit_raster_layer<uint8_t>(zone.id(), 0,
+                                                             [](TileEdit<uint8_t> &edit) {
+                                                                 edit.set(7, 3, 200);
+                                                                 throw std::runtime_error("abort");
+                                                             }),
+                        std::runtime_error);
+        CHECK(journaled.plot().zone(zone.id())->get().layer(0).gridIf<uint8_t>()->operator()(7, 3) == original);
+        CHECK(journaled.journal_size() == after);
+    }
+
+    auto reopened = JournaledPlot::open(dir, "Farm", "agricultural", datum);
+    const auto &grid = *reopened.plot().zone(zone.id())->get().layer(0).gridIf<uint8_t>();
+    CHECK(grid(5, 0) == 9);
+    CHECK(grid(5, grid.cols - 1) == 9);
+    CHECK(grid(6, 0) == zone.layer(0).gridIf<uint8_t>()->operator()(6, 0));
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,150 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include "zoneout/zoneout.hpp"
+
+#include "test_helpers.hpp"
+
+namespace dp = datapod;
+using namespace zoneout;
+
+namespace {
+
+    const char *header_xml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<TIM A="" D="4">
+  <PTN A="" B="" D=""/>
+  <DLV A="0084" B="" C="DET-1"/>
+  <DLV A="0006" B="" C="DET-1"/>
+</TIM>
+)";
+
+    /// Little-endian record writer matching header_xml
+    class LogWriter {
+      public:
+        explicit LogWriter(const std::filesystem::path &bin) : out_(bin, std::ios::binary) {}
+
+        void record(uint32_t ms, uint16_t days, const dp::Geo &pos, uint8_t status, bool with_rate, int32_t rate) {
+            put(ms, 4);
+            put(days, 2);
+            put(static_cast<uint32_t>(static_cast<int32_t>(std::lround(pos.latitude * 1e7))), 4);
+            put(static_cast<uint32_t>(static_cast<int32_t>(std::lround(pos.longitude * 1e7))), 4);
+            put(status, 1);
+            put(with_rate ? 2 : 1, 1);
+            put(0, 1); // DLV 0: speed
+            put(1234, 4);
+            if (with_rate) {
+                put(1, 1); // DLV 1: application rate
+                put(static_cast<uint32_t>(rate), 4);
+            }
+        }
+
+      private:
+        std::ofstream out_;
+
+        void put(uint32_t v, int bytes) {
+            for (int b = 0; b < bytes; ++b)
+                out_.put(static_cast<char>((v >> (8 * b)) & 0xFF));
+        }
+    };
+
+} // namespace
+
+TEST_CASE("ISOXML time log header parsing") {
+    auto header = isoxml::parse_tlg_header(header_xml);
+    CHECK(header.time_in_binary);
+    CHECK(header.position_in_binary[0]);
+    CHECK(header.position_in_binary[1]);
+    CHECK_FALSE(header.position_in_binary[2]);
+    CHECK(header.position_in_binary[3]);
+    CHECK(header.fixed_bytes() == 6 + 4 + 4 + 1);
+    REQUIRE(header.ddis.size() == 2);
+    CHECK(header.ddis[1] == 0x0006);
+    CHECK(header.ddi_index(0x0006).value() == 1);
+    CHECK_FALSE(header.ddi_index(0x0001).has_value());
+    CHECK_THROWS(isoxml::parse_tlg_header("<TASKDATA/>"));
+}
+
+TEST_CASE("ISOXML time log import") {
+    dp::Geo datum{51.98776, 5.66238, 0.0};
+    Zone field("Field", "field", make_rect(0, 0, 40, 20), datum, 1.0);
+    const LocalFrame frame(datum);
+    const auto cell_centre = [&](size_t r, size_t c) {
+        return field.visit_raster(0, [&](const auto &g) { return g.get_point(r, c); });
+    };
+
+    auto dir = std::filesystem::temp_directory_path() / "zoneout_test_tlg";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Log 1 (later day): cell (2, 3) twice at 100 and 300; one record without a fix; one outside the grid
+    // Log 2 (earlier day): cell (2, 3) at 50 and cell (5, 5) at 70, many records to cross chunk boundaries
+    {
+        std::ofstream(dir / "TLG00001.XML") << header_xml;
+        LogWriter log(dir / "TLG00001.BIN");
+        log.record(1000, 16000, frame.to_wgs(cell_centre(2, 3)), 4, true, 100);
+        log.record(2000, 16000, frame.to_wgs(cell_centre(2, 3)), 4, true, 300);
+        log.record(3000, 16000, frame.to_wgs(cell_centre(4, 4)), 0, true, 999);
+        log.record(4000, 16000, frame.to_wgs(dp::Point{500, 500, 0}), 4, true, 999);
+        log.record(5000, 16000, frame.to_wgs(cell_centre(6, 6)), 4, false, 0);
+    }
+    {
+        std::ofstream(dir / "TLG00002.XML") << header_xml;
+        LogWriter log(dir / "TLG00002.BIN");
+        for (uint32_t i = 0; i < 500; ++i) {
+            log.record(i, 15000, frame.to_wgs(cell_centre(2, 3)), 4, true, 50);
+            log.record(i, 15000, frame.to_wgs(cell_centre(5, 5)), 4, true, 70);
+        }
+    }
+    std::ofstream(dir / "TASKDATA.XML") << "<ISO11783_TaskData/>";
+
+    auto logs = isoxml::find_time_logs(dir);
+    REQUIRE(logs.size() == 2);
+
+    SUBCASE("Streaming reader handles records split across chunks") {
+        auto header = isoxml::read_tlg_header(logs[1]);
+        size_t with_rate = 0;
+        auto count = isoxml::read_time_log(
+            dir / "TLG00002.BIN", header, [&](const isoxml::TlgRecord &r) { with_rate += r.present[1]; }, 1);
+        CHECK(count == 1000);
+        CHECK(with_rate == 1000);
+    }
+
+    SUBCASE("Logs are burned into a mean layer and a temporal series") {
+        isoxml::ImportOptions options;
+        options.threads = 2;
+        options.value_scale = 0.5;
+        options.temporal_layer = "applied";
+        options.chunk_bytes = 64;
+        auto summary = isoxml::import_time_logs(field, logs, options);
+
+        CHECK(summary.logs == 2);
+        CHECK(summary.records == 1005);
+        CHECK(summary.samples == 1002);
+        CHECK(summary.outside == 1);
+
+        auto layer = field.raster_as<float>(summary.layer_index);
+        REQUIRE(layer.has_value());
+        const auto &grid = layer->get();
+        // (100 + 300 + 500 * 50) * 0.5 / 502
+        CHECK(grid(2, 3) == doctest::Approx((400.0 + 500 * 50.0) * 0.5 / 502.0));
+        CHECK(grid(5, 5) == doctest::Approx(35.0));
+        CHECK(std::isnan(grid(4, 4)));
+        CHECK(std::isnan(grid(6, 6)));
+
+        auto series = field.grid().temporal_layer<float>("applied");
+        REQUIRE(series.has_value());
+        const auto &applied = series->get();
+        REQUIRE(applied.size() == 2);
+        const size_t cols = grid.cols;
+        // Oldest slice is log 2; the newer one overrides (2, 3) and keeps (5, 5)
+        CHECK(applied.to_grid(0)(2, 3) == doctest::Approx(25.0));
+        CHECK(applied.latest()[2 * cols + 3] == doctest::Approx(100.0));
+        CHECK(applied.latest()[5 * cols + 5] == doctest::Approx(35.0));
+        CHECK(std::isnan(applied.latest()[0]));
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,160 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "zoneout/zoneout.hpp"
+
+using namespace zoneout;
+
+TEST_CASE("UUID formatting and parsing") {
+    SUBCASE("to_chars writes canonical lowercase form") {
+        UUID::ByteArray bytes = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                                 0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00};
+        UUID uuid(bytes);
+
+        char buf[UUID::string_size];
+        char *end = uuid.to_chars(buf);
+        CHECK(end == buf + UUID::string_size);
+        CHECK(std::string(buf, UUID::string_size) == "123e4567-e89b-12d3-a456-426614174000");
+        CHECK(uuid.toString() == "123e4567-e89b-12d3-a456-426614174000");
+    }
+
+    SUBCASE("from_chars round-trips generated UUIDs") {
+        for (int i = 0; i < 100; ++i) {
+            UUID original = generateUUID();
+            UUID parsed = UUID::null();
+            REQUIRE(UUID::from_chars(original.toString(), parsed));
+            CHECK(parsed == original);
+        }
+    }
+
+    SUBCASE("from_chars accepts uppercase hex") {
+        UUID parsed = UUID::null();
+        REQUIRE(UUID::from_chars("987FCDEB-51A2-43D1-9C47-123456789ABC", parsed));
+        CHECK(parsed.toString() == "987fcdeb-51a2-43d1-9c47-123456789abc");
+    }
+
+    SUBCASE("from_chars rejects malformed input") {
+        UUID parsed = UUID::null();
+        CHECK_FALSE(UUID::from_chars("", parsed));
+        CHECK_FALSE(UUID::from_chars("987fcdeb-51a2-43d1-9c47-123456789ab", parsed));
+        CHECK_FALSE(UUID::from_chars("987fcdeb-51a2-43d1-9c47-123456789abcd", parsed));
+        CHECK_FALSE(UUID::from_chars("987fcdeb051a2-43d1-9c47-123456789abc", parsed));
+        CHECK_FALSE(UUID::from_chars("987fcdeb-51a2-43d1-9c47-12345678zabc", parsed));
+        CHECK_FALSE(UUID::from_chars("g87fcdeb-51a2-43d1-9c47-123456789abc", parsed));
+        CHECK(parsed.isNull());
+    }
+
+    SUBCASE("fromString throws on malformed input") {
+        CHECK_THROWS_AS(UUID("not-a-uuid"), std::invalid_argument);
+        CHECK_THROWS_AS(UUID("987fcdeb-51a2-43d1-9c47-12345678-abc"), std::invalid_argument);
+    }
+
+    SUBCASE("uuidEquals compares against text without allocating") {
+        UUID uuid = generateUUID();
+        CHECK(uuidEquals(uuid, uuid.toString()));
+        CHECK_FALSE(uuidEquals(uuid, generateUUID().toString()));
+        CHECK_FALSE(uuidEquals(uuid, "short"));
+    }
+}
+
+TEST_CASE("UUIDHash and heterogeneous lookup") {
+    SUBCASE("Textual and binary forms hash identically") {
+        UUIDHash hash;
+        for (int i = 0; i < 100; ++i) {
+            UUID uuid = generateUUID();
+            std::string text = uuid.toString();
+            CHECK(hash(uuid) == hash(text));
+            CHECK(hash(uuid) == hash(std::string_view(text)));
+        }
+    }
+
+    SUBCASE("Hash spreads random UUIDs across buckets") {
+        UUIDHash hash;
+        std::vector<size_t> buckets(64, 0);
+        for (int i = 0; i < 6400; ++i) {
+            buckets[hash(generateUUID()) & 63]++;
+        }
+        for (auto count : buckets) {
+            CHECK(count > 50);
+            CHECK(count < 150);
+        }
+    }
+
+    SUBCASE("UUIDMap finds entries by string without constructing a UUID") {
+        UUIDMap<int> map;
+        UUID a = generateUUID();
+        UUID b = generateUUID();
+        map[a] = 1;
+        map[b] = 2;
+
+        std::string a_text = a.toString();
+        auto it = map.find(std::string_view(a_text));
+        REQUIRE(it != map.end());
+        CHECK(it->second == 1);
+        CHECK(map.count(std::string_view(b.toString())) == 1);
+        CHECK(map.find(std::string_view("not-a-uuid")) == map.end());
+        CHECK(map.find(std::string_view(generateUUID().toString())) == map.end());
+    }
+
+    SUBCASE("UUIDSet contains") {
+        UUIDSet set;
+        UUID a = generateUUID();
+        set.insert(a);
+        CHECK(set.contains(a));
+        CHECK(set.contains(std::string_view(a.toString())));
+    }
+}
+
+TEST_CASE("UUID generation modes") {
+    SUBCASE("Null construction does not generate") {
+        UUID uuid(null_id);
+        CHECK(uuid.isNull());
+        CHECK(uuid.version() == 0);
+    }
+
+    SUBCASE("Default generation is v4") {
+        UUID uuid = generateUUID();
+        CHECK(uuid.version() == 4);
+        CHECK((uuid.bytes()[8] & 0xC0) == 0x80);
+        CHECK(uuid.timestampMs() == 0);
+    }
+
+    SUBCASE("v7 UUIDs embed the time and sort by creation order") {
+        auto before = time_utils::toMilliseconds(time_utils::now());
+        std::vector<UUID> ids;
+        for (int i = 0; i < 5000; ++i) {
+            UUID uuid(null_id);
+            uuid.generateV7();
+            ids.push_back(uuid);
+        }
+        auto after = time_utils::toMilliseconds(time_utils::now());
+
+        CHECK(ids.front().version() == 7);
+        CHECK((ids.front().bytes()[8] & 0xC0) == 0x80);
+        CHECK(ids.front().timestampMs() >= before);
+        CHECK(ids.front().timestampMs() <= after + 1);
+        CHECK(std::is_sorted(ids.begin(), ids.end()));
+        CHECK(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+    }
+
+    SUBCASE("Batch generation honours the default version") {
+        auto v4 = generateUUIDs(1000);
+        CHECK(v4.size() == 1000);
+        CHECK(std::all_of(v4.begin(), v4.end(), [](const UUID &u) { return u.version() == 4; }));
+        UUIDSet unique(v4.begin(), v4.end());
+        CHECK(unique.size() == v4.size());
+
+        setDefaultUUIDVersion(UUIDVersion::V7);
+        auto v7 = generateUUIDs(10000);
+        CHECK(generateUUID().version() == 7);
+        setDefaultUUIDVersion(UUIDVersion::V4);
+
+        CHECK(std::all_of(v7.begin(), v7.end(), [](const UUID &u) { return u.version() == 7; }));
+        CHECK(std::is_sorted(v7.begin(), v7.end()));
+        CHECK(std::adjacent_find(v7.begin(), v7.end()) == v7.end());
+        CHECK(generateUUID().version() == 4);
+    }
+}